@@ -9,6 +9,9 @@
 @brief This file contains the definition of the AVLTree class and its related classes and structures.
 */
 #include "AVLTree.h"
+#include <algorithm> // std::min, std::max
+#include <future> // std::async
+#include <thread> // std::thread::hardware_concurrency
 /**
  * @brief Constructs a new AVLTree object.
  * @param oa Pointer to an ObjectAllocator for memory management.
@@ -25,7 +28,12 @@ AVLTree<T>::AVLTree(ObjectAllocator *oa, bool ShareOA) : BSTree<T>(oa, ShareOA)
 template <typename T>
 void AVLTree<T>::insert(const T &value)
 {
-    this->get_root() = insert_node(this->get_root(), value);
+    bool grew = false;
+    this->get_root() = insert_node(this->get_root(), value, grew);
+    if (grew)
+    {
+        ++this->get_height();
+    }
 }
 /**
  * @brief Removes a value from the AVL tree.
@@ -34,7 +42,12 @@ void AVLTree<T>::insert(const T &value)
 template <typename T>
 void AVLTree<T>::remove(const T &value)
 {
-    this->get_root() = remove_node(this->get_root(), value);
+    bool shrank = false;
+    this->get_root() = remove_node(this->get_root(), value, shrank);
+    if (shrank)
+    {
+        --this->get_height();
+    }
 }
 /**
  * @brief Returns true if efficiency implemented.
@@ -46,32 +59,49 @@ bool AVLTree<T>::ImplementedBalanceFactor(void)
     return true;
 }
 /**
- * @brief Inserts a node into the AVL tree.
+ * @brief Inserts a node into the AVL tree. Balance factors are updated on
+ *        the way back up only while the subtree keeps growing.
  * @param tree Reference to the root node of the tree.
  * @param value Value to be inserted.
+ * @param grew Set to true if the height of the tree increased.
  * @return Pointer to the root node of the modified tree.
  */
 template <typename T>
-typename BSTree<T>::BinTree AVLTree<T>::insert_node(typename BSTree<T>::BinTree &tree, const T &value)
+typename BSTree<T>::BinTree AVLTree<T>::insert_node(typename BSTree<T>::BinTree &tree, const T &value, bool &grew)
 {
     if (tree == nullptr)
     {
+        grew = true;
         return this->make_node(value);
     }
     if (value < tree->data)
     {
         tree->count++;
-        tree->left = insert_node(tree->left, value);
+        tree->left = insert_node(tree->left, value, grew);
+        if (!grew)
+        {
+            return tree;
+        }
+        tree->balance_factor++;
     }
     else if (value > tree->data)
     {
         tree->count++;
-        tree->right = insert_node(tree->right, value);
+        tree->right = insert_node(tree->right, value, grew);
+        if (!grew)
+        {
+            return tree;
+        }
+        tree->balance_factor--;
     }
     else
+    {
+        grew = false;
         return tree;
-    tree->balance_factor = balance_factor(tree);
-    // right rotation
+    }
+    // the subtree is taller only if it was balanced before
+    grew = tree->balance_factor == 1 || tree->balance_factor == -1;
+    // right rotation, restores the height from before the insert
     if (tree->balance_factor > 1)
     {
         if (value < tree->left->data)
@@ -100,27 +130,40 @@ typename BSTree<T>::BinTree AVLTree<T>::insert_node(typename BSTree<T>::BinTree
     return tree;
 }
 /**
- * @brief Removes a node from the AVL tree.
+ * @brief Removes a node from the AVL tree. Balance factors are updated on
+ *        the way back up only while the subtree keeps shrinking.
  * @param tree Reference to the root node of the tree.
  * @param value Value to be removed.
+ * @param shrank Set to true if the height of the tree decreased.
  * @return Pointer to the root node of the modified tree.
  */
 template <typename T>
-typename BSTree<T>::BinTree AVLTree<T>::remove_node(typename BSTree<T>::BinTree &tree, const T &value)
+typename BSTree<T>::BinTree AVLTree<T>::remove_node(typename BSTree<T>::BinTree &tree, const T &value, bool &shrank)
 {
     if (tree == nullptr)
     {
+        shrank = false;
         return tree;
     }
     if (value < tree->data)
     {
         tree->count--;
-        tree->left = remove_node(tree->left, value);
+        tree->left = remove_node(tree->left, value, shrank);
+        if (!shrank)
+        {
+            return tree;
+        }
+        tree->balance_factor--;
     }
     else if (value > tree->data)
     {
         tree->count--;
-        tree->right = remove_node(tree->right, value);
+        tree->right = remove_node(tree->right, value, shrank);
+        if (!shrank)
+        {
+            return tree;
+        }
+        tree->balance_factor++;
     }
     else
     {
@@ -135,6 +178,8 @@ typename BSTree<T>::BinTree AVLTree<T>::remove_node(typename BSTree<T>::BinTree
             else
                 *tree = *temp;
             this->free_node(temp);
+            shrank = true;
+            return tree;
         }
         else
         {
@@ -145,44 +190,47 @@ typename BSTree<T>::BinTree AVLTree<T>::remove_node(typename BSTree<T>::BinTree
             }
             tree->data = temp->data;
             tree->count--;
-            tree->right = remove_node(tree->right, temp->data);
+            tree->right = remove_node(tree->right, temp->data, shrank);
+            if (!shrank)
+            {
+                return tree;
+            }
+            tree->balance_factor++;
         }
     }
-    if (tree == nullptr)
-    {
-        return tree;
-    }
-    tree->balance_factor = balance_factor(tree);
     // right rotation
     if (tree->balance_factor > 1)
     {
-        if (balance_factor(tree->left) >= 0)
+        if (tree->left->balance_factor >= 0)
         {
-            return rotate_right(tree);
+            tree = rotate_right(tree);
         }
         else
         {
             tree->left = rotate_left(tree->left);
-            return rotate_right(tree);
+            tree = rotate_right(tree);
         }
     }
     // left rotation
-    if (tree->balance_factor < -1)
+    else if (tree->balance_factor < -1)
     {
-        if (balance_factor(tree->right) <= 0)
+        if (tree->right->balance_factor <= 0)
         {
-            return rotate_left(tree);
+            tree = rotate_left(tree);
         }
         else
         {
             tree->right = rotate_right(tree->right);
-            return rotate_left(tree);
+            tree = rotate_left(tree);
         }
     }
+    // the subtree is shorter only if it ends up balanced
+    shrank = tree->balance_factor == 0;
     return tree;
 }
 /**
- * @brief Rotates the tree to the left.
+ * @brief Rotates the tree to the left. The balance factors are derived from
+ *        the old ones, so no height is measured.
  * @param tree Reference to the root node of the tree.
  * @return Pointer to the root node of the modified tree.
  */
@@ -193,12 +241,15 @@ typename BSTree<T>::BinTree AVLTree<T>::rotate_left(typename BSTree<T>::BinTree
     tree->right = temp->left;
     temp->left = tree;
 
-    tree->count = 1 + (tree->left ? tree->left->count : 0) + (tree->right ? tree->right->count : 0);
-    temp->count = 1 + (temp->left ? temp->left->count : 0) + (temp->right ? temp->right->count : 0);
+    tree->balance_factor += 1 - std::min(temp->balance_factor, 0);
+    temp->balance_factor += 1 + std::max(tree->balance_factor, 0);
+    update_count(tree);
+    update_count(temp);
     return temp;
 }
 /**
- * @brief Rotates the tree to the right.
+ * @brief Rotates the tree to the right. The balance factors are derived from
+ *        the old ones, so no height is measured.
  * @param tree Reference to the root node of the tree.
  * @return Pointer to the root node of the modified tree.
  */
@@ -209,8 +260,10 @@ typename BSTree<T>::BinTree AVLTree<T>::rotate_right(typename BSTree<T>::BinTree
     tree->left = temp->right;
     temp->right = tree;
 
-    tree->count = 1 + (tree->left ? tree->left->count : 0) + (tree->right ? tree->right->count : 0);
-    temp->count = 1 + (temp->left ? temp->left->count : 0) + (temp->right ? temp->right->count : 0);
+    tree->balance_factor -= 1 + std::max(temp->balance_factor, 0);
+    temp->balance_factor -= 1 - std::min(tree->balance_factor, 0);
+    update_count(tree);
+    update_count(temp);
     return temp;
 }
 /**
@@ -225,5 +278,555 @@ int AVLTree<T>::balance_factor(typename BSTree<T>::BinTree tree)
     {
         return 0;
     }
-    return this->tree_height(tree->left) - this->tree_height(tree->right);
-}
\ No newline at end of file
+    return this->node_height(tree->left) - this->node_height(tree->right);
+}
+/**
+ * @brief Recomputes the count of a node from its children.
+ * @param tree Pointer to the node.
+ */
+template <typename T>
+void AVLTree<T>::update_count(typename BSTree<T>::BinTree tree)
+{
+    tree->count = 1 + (tree->left ? tree->left->count : 0) + (tree->right ? tree->right->count : 0);
+}
+/**
+ * @brief Returns the height of a node's left subtree.
+ * @param tree Pointer to the node.
+ * @param height Height of the node.
+ * @return Height of the left subtree.
+ */
+template <typename T>
+int AVLTree<T>::left_height(typename BSTree<T>::BinTree tree, int height)
+{
+    return tree->balance_factor < 0 ? height - 2 : height - 1;
+}
+/**
+ * @brief Returns the height of a node's right subtree.
+ * @param tree Pointer to the node.
+ * @param height Height of the node.
+ * @return Height of the right subtree.
+ */
+template <typename T>
+int AVLTree<T>::right_height(typename BSTree<T>::BinTree tree, int height)
+{
+    return tree->balance_factor > 0 ? height - 2 : height - 1;
+}
+/**
+ * @brief Updates a node whose children changed and rotates it if unbalanced.
+ *        The children must differ in height by at most 2.
+ * @param tree Reference to the root node of the tree.
+ * @param left_tree_height Height of the left subtree.
+ * @param right_tree_height Height of the right subtree.
+ * @param height Receives the height of the balanced tree.
+ * @return Pointer to the root node of the balanced tree.
+ */
+template <typename T>
+typename BSTree<T>::BinTree AVLTree<T>::rebalance(typename BSTree<T>::BinTree &tree, int left_tree_height,
+                                                  int right_tree_height, int &height)
+{
+    update_count(tree);
+    tree->balance_factor = left_tree_height - right_tree_height;
+    // right rotation, only a single rotation of a balanced child leaves the
+    // root a level above it
+    if (tree->balance_factor > 1)
+    {
+        height = tree->left->balance_factor == 0 ? left_tree_height + 1 : left_tree_height;
+        if (tree->left->balance_factor < 0)
+        {
+            tree->left = rotate_left(tree->left);
+        }
+        return rotate_right(tree);
+    }
+    // left rotation
+    if (tree->balance_factor < -1)
+    {
+        height = tree->right->balance_factor == 0 ? right_tree_height + 1 : right_tree_height;
+        if (tree->right->balance_factor > 0)
+        {
+            tree->right = rotate_right(tree->right);
+        }
+        return rotate_left(tree);
+    }
+    height = 1 + std::max(left_tree_height, right_tree_height);
+    return tree;
+}
+/**
+ * @brief Replaces this tree with left + value + right. Every value in left
+ *        must be smaller than value and every value in right larger.
+ *        left and right are left empty. Nothing is changed if an
+ *        allocation fails.
+ * @param left Tree holding the smaller values.
+ * @param value Value joining the two trees.
+ * @param right Tree holding the larger values.
+ */
+template <typename T>
+void AVLTree<T>::join(AVLTree &left, const T &value, AVLTree &right)
+{
+    // allocate everything before any tree is touched
+    typename BSTree<T>::BinTree node = this->make_node(value);
+    typename BSTree<T>::BinTree left_tree = left.get_root();
+    typename BSTree<T>::BinTree right_tree = right.get_root();
+    try
+    {
+        if (!this->shares_allocator(left))
+        {
+            left_tree = this->clone_tree(left_tree);
+        }
+        if (!this->shares_allocator(right))
+        {
+            right_tree = this->clone_tree(right_tree);
+        }
+    }
+    catch (...)
+    {
+        if (left_tree != left.get_root())
+        {
+            this->clear_tree(left_tree);
+        }
+        this->free_node(node);
+        throw;
+    }
+
+    int left_tree_height = left.get_height();
+    int right_tree_height = right.get_height();
+    // detach the arguments before clearing this tree, which may be one of them
+    release_source(left, left_tree);
+    release_source(right, right_tree);
+    this->clear();
+    int height;
+    this->get_root() = join_nodes(left_tree, left_tree_height, node, right_tree, right_tree_height, height);
+    this->get_height() = height;
+}
+/**
+ * @brief Empties a tree whose nodes were taken, or copied, by join.
+ * @param source The tree.
+ * @param taken The tree join uses in place of source's nodes.
+ */
+template <typename T>
+void AVLTree<T>::release_source(AVLTree &source, typename BSTree<T>::BinTree taken)
+{
+    if (source.get_root() == taken)
+    {
+        source.get_root() = nullptr;
+        source.get_height() = -1;
+    }
+    else
+    {
+        source.clear();
+    }
+}
+/**
+ * @brief Moves the values smaller than value into left and the larger ones
+ *        into right, leaving this tree empty.
+ * @param value Value to split at.
+ * @param left Receives the smaller values (previous contents are cleared).
+ * @param right Receives the larger values (previous contents are cleared).
+ * @return True if value was in the tree.
+ */
+template <typename T>
+bool AVLTree<T>::split(const T &value, AVLTree &left, AVLTree &right)
+{
+    typename BSTree<T>::BinTree left_tree, found, right_tree;
+    int left_tree_height, right_tree_height;
+    split_node(this->get_root(), this->get_height(), value, left_tree, left_tree_height, found, right_tree,
+               right_tree_height);
+    this->get_root() = nullptr;
+    this->get_height() = -1;
+    if (found != nullptr)
+    {
+        this->free_node(found);
+    }
+
+    left.clear();
+    right.clear();
+    left.get_root() = left.adopt_tree(*this, left_tree);
+    right.get_root() = right.adopt_tree(*this, right_tree);
+    left.get_height() = left_tree_height;
+    right.get_height() = right_tree_height;
+    return found != nullptr;
+}
+/**
+ * @brief Adds every value of rhs to this tree.
+ * @param rhs The other set.
+ */
+template <typename T>
+void AVLTree<T>::set_union(const AVLTree &rhs)
+{
+    SetOpContext ctx;
+    init_context(ctx);
+    typename BSTree<T>::BinTree other = this->clone_tree(rhs.root());
+    int height;
+    this->get_root() = union_nodes(this->get_root(), this->get_height(), other, rhs.height(), 0, ctx, height);
+    this->get_height() = height;
+}
+/**
+ * @brief Keeps only the values that are also in rhs.
+ * @param rhs The other set.
+ */
+template <typename T>
+void AVLTree<T>::set_intersection(const AVLTree &rhs)
+{
+    SetOpContext ctx;
+    init_context(ctx);
+    typename BSTree<T>::BinTree other = this->clone_tree(rhs.root());
+    int height;
+    this->get_root() = intersect_nodes(this->get_root(), this->get_height(), other, rhs.height(), 0, ctx, height);
+    this->get_height() = height;
+}
+/**
+ * @brief Removes every value that is in rhs.
+ * @param rhs The other set.
+ */
+template <typename T>
+void AVLTree<T>::set_difference(const AVLTree &rhs)
+{
+    SetOpContext ctx;
+    init_context(ctx);
+    typename BSTree<T>::BinTree other = this->clone_tree(rhs.root());
+    int height;
+    this->get_root() = difference_nodes(this->get_root(), this->get_height(), other, rhs.height(), 0, ctx, height);
+    this->get_height() = height;
+}
+/**
+ * @brief Joins two trees with a middle node. The heights are passed down the
+ *        spine, so this takes time proportional to their difference.
+ * @param left Tree holding the smaller values.
+ * @param left_tree_height Height of left.
+ * @param node Node holding the middle value.
+ * @param right Tree holding the larger values.
+ * @param right_tree_height Height of right.
+ * @param height Receives the height of the joined tree.
+ * @return Pointer to the root node of the joined tree.
+ */
+template <typename T>
+typename BSTree<T>::BinTree AVLTree<T>::join_nodes(typename BSTree<T>::BinTree left, int left_tree_height,
+                                                   typename BSTree<T>::BinTree node,
+                                                   typename BSTree<T>::BinTree right, int right_tree_height,
+                                                   int &height)
+{
+    int joined_height;
+    // walk down the right spine of the taller left tree
+    if (left_tree_height > right_tree_height + 1)
+    {
+        int outer_height = left_height(left, left_tree_height);
+        left->right = join_nodes(left->right, right_height(left, left_tree_height), node, right, right_tree_height,
+                                 joined_height);
+        return rebalance(left, outer_height, joined_height, height);
+    }
+    // walk down the left spine of the taller right tree
+    if (right_tree_height > left_tree_height + 1)
+    {
+        int outer_height = right_height(right, right_tree_height);
+        right->left = join_nodes(left, left_tree_height, node, right->left, left_height(right, right_tree_height),
+                                 joined_height);
+        return rebalance(right, joined_height, outer_height, height);
+    }
+    node->left = left;
+    node->right = right;
+    update_count(node);
+    node->balance_factor = left_tree_height - right_tree_height;
+    height = 1 + std::max(left_tree_height, right_tree_height);
+    return node;
+}
+/**
+ * @brief Joins two trees without a middle node.
+ * @param left Tree holding the smaller values.
+ * @param left_tree_height Height of left.
+ * @param right Tree holding the larger values.
+ * @param right_tree_height Height of right.
+ * @param height Receives the height of the joined tree.
+ * @return Pointer to the root node of the joined tree.
+ */
+template <typename T>
+typename BSTree<T>::BinTree AVLTree<T>::join2(typename BSTree<T>::BinTree left, int left_tree_height,
+                                              typename BSTree<T>::BinTree right, int right_tree_height, int &height)
+{
+    if (left == nullptr)
+    {
+        height = right_tree_height;
+        return right;
+    }
+    typename BSTree<T>::BinTree last;
+    left = split_last(left, left_tree_height, last, left_tree_height);
+    return join_nodes(left, left_tree_height, last, right, right_tree_height, height);
+}
+/**
+ * @brief Splits a tree at a value.
+ * @param tree Pointer to the root node of the tree.
+ * @param tree_height Height of the tree.
+ * @param value Value to split at.
+ * @param left Receives the tree of smaller values.
+ * @param left_tree_height Receives the height of left.
+ * @param found Receives the node holding value, or null.
+ * @param right Receives the tree of larger values.
+ * @param right_tree_height Receives the height of right.
+ */
+template <typename T>
+void AVLTree<T>::split_node(typename BSTree<T>::BinTree tree, int tree_height, const T &value,
+                            typename BSTree<T>::BinTree &left, int &left_tree_height,
+                            typename BSTree<T>::BinTree &found, typename BSTree<T>::BinTree &right,
+                            int &right_tree_height)
+{
+    if (tree == nullptr)
+    {
+        left = right = found = nullptr;
+        left_tree_height = right_tree_height = -1;
+    }
+    else if (value < tree->data)
+    {
+        typename BSTree<T>::BinTree middle;
+        int middle_height;
+        split_node(tree->left, left_height(tree, tree_height), value, left, left_tree_height, found, middle,
+                   middle_height);
+        right = join_nodes(middle, middle_height, tree, tree->right, right_height(tree, tree_height),
+                           right_tree_height);
+    }
+    else if (value > tree->data)
+    {
+        typename BSTree<T>::BinTree middle;
+        int middle_height;
+        split_node(tree->right, right_height(tree, tree_height), value, middle, middle_height, found, right,
+                   right_tree_height);
+        left = join_nodes(tree->left, left_height(tree, tree_height), tree, middle, middle_height,
+                          left_tree_height);
+    }
+    else
+    {
+        left = tree->left;
+        right = tree->right;
+        left_tree_height = left_height(tree, tree_height);
+        right_tree_height = right_height(tree, tree_height);
+        found = tree;
+        found->left = found->right = nullptr;
+        found->balance_factor = 0;
+        update_count(found);
+    }
+}
+/**
+ * @brief Detaches the largest node of a tree.
+ * @param tree Pointer to the root node of a non-empty tree.
+ * @param tree_height Height of the tree.
+ * @param last Receives the largest node.
+ * @param height Receives the height of the remaining tree.
+ * @return Pointer to the root node of the remaining tree.
+ */
+template <typename T>
+typename BSTree<T>::BinTree AVLTree<T>::split_last(typename BSTree<T>::BinTree tree, int tree_height,
+                                                   typename BSTree<T>::BinTree &last, int &height)
+{
+    if (tree->right == nullptr)
+    {
+        last = tree;
+        height = tree_height - 1;
+        return tree->left;
+    }
+    int rest_height;
+    typename BSTree<T>::BinTree rest = split_last(tree->right, right_height(tree, tree_height), last, rest_height);
+    return join_nodes(tree->left, left_height(tree, tree_height), tree, rest, rest_height, height);
+}
+/**
+ * @brief Union of two trees, consuming both.
+ * @param lhs Pointer to the first tree.
+ * @param lhs_height Height of the first tree.
+ * @param rhs Pointer to the second tree.
+ * @param rhs_height Height of the second tree.
+ * @param depth Recursion depth.
+ * @param ctx Shared state of the operation.
+ * @param height Receives the height of the result.
+ * @return Pointer to the root node of the result.
+ */
+template <typename T>
+typename BSTree<T>::BinTree AVLTree<T>::union_nodes(typename BSTree<T>::BinTree lhs, int lhs_height,
+                                                    typename BSTree<T>::BinTree rhs, int rhs_height, int depth,
+                                                    SetOpContext &ctx, int &height)
+{
+    if (lhs == nullptr)
+    {
+        height = rhs_height;
+        return rhs;
+    }
+    if (rhs == nullptr)
+    {
+        height = lhs_height;
+        return lhs;
+    }
+    unsigned size = lhs->count + rhs->count;
+    typename BSTree<T>::BinTree rhs_left, found, rhs_right;
+    int rhs_left_height, rhs_right_height;
+    split_node(rhs, rhs_height, lhs->data, rhs_left, rhs_left_height, found, rhs_right, rhs_right_height);
+    if (found != nullptr)
+    {
+        release_node(found, ctx);
+    }
+    typename BSTree<T>::BinTree left = lhs->left, right = lhs->right;
+    int left_tree_height = left_height(lhs, lhs_height), right_tree_height = right_height(lhs, lhs_height);
+    fork_join(size, depth, ctx,
+              [&]() {
+                  left = union_nodes(left, left_tree_height, rhs_left, rhs_left_height, depth + 1, ctx,
+                                     left_tree_height);
+              },
+              [&]() {
+                  right = union_nodes(right, right_tree_height, rhs_right, rhs_right_height, depth + 1, ctx,
+                                      right_tree_height);
+              });
+    return join_nodes(left, left_tree_height, lhs, right, right_tree_height, height);
+}
+/**
+ * @brief Intersection of two trees, consuming both.
+ * @param lhs Pointer to the first tree.
+ * @param lhs_height Height of the first tree.
+ * @param rhs Pointer to the second tree.
+ * @param rhs_height Height of the second tree.
+ * @param depth Recursion depth.
+ * @param ctx Shared state of the operation.
+ * @param height Receives the height of the result.
+ * @return Pointer to the root node of the result.
+ */
+template <typename T>
+typename BSTree<T>::BinTree AVLTree<T>::intersect_nodes(typename BSTree<T>::BinTree lhs, int lhs_height,
+                                                        typename BSTree<T>::BinTree rhs, int rhs_height, int depth,
+                                                        SetOpContext &ctx, int &height)
+{
+    if (lhs == nullptr || rhs == nullptr)
+    {
+        release_tree(lhs, ctx);
+        release_tree(rhs, ctx);
+        height = -1;
+        return nullptr;
+    }
+    unsigned size = lhs->count + rhs->count;
+    typename BSTree<T>::BinTree rhs_left, found, rhs_right;
+    int rhs_left_height, rhs_right_height;
+    split_node(rhs, rhs_height, lhs->data, rhs_left, rhs_left_height, found, rhs_right, rhs_right_height);
+    typename BSTree<T>::BinTree left = lhs->left, right = lhs->right;
+    int left_tree_height = left_height(lhs, lhs_height), right_tree_height = right_height(lhs, lhs_height);
+    fork_join(size, depth, ctx,
+              [&]() {
+                  left = intersect_nodes(left, left_tree_height, rhs_left, rhs_left_height, depth + 1, ctx,
+                                         left_tree_height);
+              },
+              [&]() {
+                  right = intersect_nodes(right, right_tree_height, rhs_right, rhs_right_height, depth + 1, ctx,
+                                          right_tree_height);
+              });
+    if (found != nullptr)
+    {
+        release_node(found, ctx);
+        return join_nodes(left, left_tree_height, lhs, right, right_tree_height, height);
+    }
+    release_node(lhs, ctx);
+    return join2(left, left_tree_height, right, right_tree_height, height);
+}
+/**
+ * @brief Difference of two trees (lhs - rhs), consuming both.
+ * @param lhs Pointer to the first tree.
+ * @param lhs_height Height of the first tree.
+ * @param rhs Pointer to the second tree.
+ * @param rhs_height Height of the second tree.
+ * @param depth Recursion depth.
+ * @param ctx Shared state of the operation.
+ * @param height Receives the height of the result.
+ * @return Pointer to the root node of the result.
+ */
+template <typename T>
+typename BSTree<T>::BinTree AVLTree<T>::difference_nodes(typename BSTree<T>::BinTree lhs, int lhs_height,
+                                                         typename BSTree<T>::BinTree rhs, int rhs_height, int depth,
+                                                         SetOpContext &ctx, int &height)
+{
+    if (lhs == nullptr || rhs == nullptr)
+    {
+        release_tree(rhs, ctx);
+        height = lhs_height;
+        return lhs;
+    }
+    unsigned size = lhs->count + rhs->count;
+    typename BSTree<T>::BinTree lhs_left, found, lhs_right;
+    int lhs_left_height, lhs_right_height;
+    split_node(lhs, lhs_height, rhs->data, lhs_left, lhs_left_height, found, lhs_right, lhs_right_height);
+    if (found != nullptr)
+    {
+        release_node(found, ctx);
+    }
+    typename BSTree<T>::BinTree rhs_left = rhs->left, rhs_right = rhs->right;
+    int rhs_left_height = left_height(rhs, rhs_height), rhs_right_height = right_height(rhs, rhs_height);
+    release_node(rhs, ctx);
+    fork_join(size, depth, ctx,
+              [&]() {
+                  lhs_left = difference_nodes(lhs_left, lhs_left_height, rhs_left, rhs_left_height, depth + 1, ctx,
+                                              lhs_left_height);
+              },
+              [&]() {
+                  lhs_right = difference_nodes(lhs_right, lhs_right_height, rhs_right, rhs_right_height, depth + 1,
+                                               ctx, lhs_right_height);
+              });
+    return join2(lhs_left, lhs_left_height, lhs_right, lhs_right_height, height);
+}
+/**
+ * @brief Runs two tasks, in parallel if the subtrees are large enough.
+ * @param size Number of nodes the tasks will visit.
+ * @param depth Recursion depth.
+ * @param ctx Shared state of the operation.
+ * @param left_task The first task.
+ * @param right_task The second task.
+ */
+template <typename T>
+template <typename LeftTask, typename RightTask>
+void AVLTree<T>::fork_join(unsigned size, int depth, SetOpContext &ctx, LeftTask left_task, RightTask right_task)
+{
+    if (depth < ctx.spawn_depth && size >= PARALLEL_GRAIN)
+    {
+        std::future<void> left = std::async(std::launch::async, left_task);
+        right_task();
+        left.get();
+    }
+    else
+    {
+        left_task();
+        right_task();
+    }
+}
+/**
+ * @brief Frees a node from inside a set operation.
+ * @param node Pointer to the node.
+ * @param ctx Shared state of the operation.
+ */
+template <typename T>
+void AVLTree<T>::release_node(typename BSTree<T>::BinTree node, SetOpContext &ctx)
+{
+    std::lock_guard<std::mutex> lock(ctx.free_lock);
+    this->free_node(node);
+}
+/**
+ * @brief Frees a whole tree from inside a set operation.
+ * @param tree Pointer to the root node of the tree.
+ * @param ctx Shared state of the operation.
+ */
+template <typename T>
+void AVLTree<T>::release_tree(typename BSTree<T>::BinTree tree, SetOpContext &ctx)
+{
+    if (tree != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(ctx.free_lock);
+        this->clear_tree(tree);
+    }
+}
+/**
+ * @brief Prepares the shared state of a set operation. Tasks are forked down
+ *        to a depth that gives a few tasks per hardware thread.
+ * @param ctx Shared state of the operation.
+ */
+template <typename T>
+void AVLTree<T>::init_context(SetOpContext &ctx)
+{
+    unsigned threads = std::thread::hardware_concurrency();
+    ctx.spawn_depth = 0;
+    while (threads > 1)
+    {
+        ++ctx.spawn_depth;
+        threads /= 2;
+    }
+    if (ctx.spawn_depth > 0)
+    {
+        ctx.spawn_depth += 2;
+    }
+}
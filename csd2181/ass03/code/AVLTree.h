@@ -13,6 +13,7 @@
 #define AVLTREE
 //---------------------------------------------------------------------------
 #include <stack>
+#include <mutex> // std::mutex
 #include "BSTree.h"
 
 /*!
@@ -46,23 +47,69 @@ public:
    * @return True if efficiency implemented.
    */
   static bool ImplementedBalanceFactor(void);
+  /**
+   * @brief Replaces this tree with left + value + right. Every value in left
+   *        must be smaller than value and every value in right larger.
+   *        left and right are left empty. Nothing is changed if an
+   *        allocation fails.
+   * @param left Tree holding the smaller values.
+   * @param value Value joining the two trees.
+   * @param right Tree holding the larger values.
+   */
+  void join(AVLTree &left, const T &value, AVLTree &right);
+  /**
+   * @brief Moves the values smaller than value into left and the larger ones
+   *        into right, leaving this tree empty.
+   * @param value Value to split at.
+   * @param left Receives the smaller values (previous contents are cleared).
+   * @param right Receives the larger values (previous contents are cleared).
+   * @return True if value was in the tree.
+   */
+  bool split(const T &value, AVLTree &left, AVLTree &right);
+  /**
+   * @brief Adds every value of rhs to this tree.
+   * @param rhs The other set.
+   */
+  void set_union(const AVLTree &rhs);
+  /**
+   * @brief Keeps only the values that are also in rhs.
+   * @param rhs The other set.
+   */
+  void set_intersection(const AVLTree &rhs);
+  /**
+   * @brief Removes every value that is in rhs.
+   * @param rhs The other set.
+   */
+  void set_difference(const AVLTree &rhs);
 
 private:
+  //! Subtrees smaller than this are never processed in parallel
+  static const unsigned PARALLEL_GRAIN = 4096;
+
+  //! State shared by the tasks of one set operation
+  struct SetOpContext
+  {
+    std::mutex free_lock; //!< The allocator is not thread-safe
+    int spawn_depth;      //!< Recursion depth down to which tasks are forked
+  };
+
   // private stuff
   /**
    * @brief Inserts a node into the AVL tree.
    * @param tree Reference to the root node of the tree.
    * @param value Value to be inserted.
+   * @param grew Set to true if the height of the tree increased.
    * @return Pointer to the root node of the modified tree.
    */
-  typename BSTree<T>::BinTree insert_node(typename BSTree<T>::BinTree &tree, const T &value);
+  typename BSTree<T>::BinTree insert_node(typename BSTree<T>::BinTree &tree, const T &value, bool &grew);
   /**
    * @brief Removes a node from the AVL tree.
    * @param tree Reference to the root node of the tree.
    * @param value Value to be removed.
+   * @param shrank Set to true if the height of the tree decreased.
    * @return Pointer to the root node of the modified tree.
    */
-  typename BSTree<T>::BinTree remove_node(typename BSTree<T>::BinTree &tree, const T &value);
+  typename BSTree<T>::BinTree remove_node(typename BSTree<T>::BinTree &tree, const T &value, bool &shrank);
   /**
    * @brief Rotates the tree to the left.
    * @param tree Reference to the root node of the tree.
@@ -81,6 +128,158 @@ private:
    * @return The balance factor of the tree.
    */
   int balance_factor(typename BSTree<T>::BinTree tree);
+  /**
+   * @brief Recomputes the count of a node from its children.
+   * @param tree Pointer to the node.
+   */
+  static void update_count(typename BSTree<T>::BinTree tree);
+  /**
+   * @brief Returns the height of a node's left subtree.
+   * @param tree Pointer to the node.
+   * @param height Height of the node.
+   * @return Height of the left subtree.
+   */
+  static int left_height(typename BSTree<T>::BinTree tree, int height);
+  /**
+   * @brief Returns the height of a node's right subtree.
+   * @param tree Pointer to the node.
+   * @param height Height of the node.
+   * @return Height of the right subtree.
+   */
+  static int right_height(typename BSTree<T>::BinTree tree, int height);
+  /**
+   * @brief Updates a node whose children changed and rotates it if unbalanced.
+   * @param tree Reference to the root node of the tree.
+   * @param left_tree_height Height of the left subtree.
+   * @param right_tree_height Height of the right subtree.
+   * @param height Receives the height of the balanced tree.
+   * @return Pointer to the root node of the balanced tree.
+   */
+  typename BSTree<T>::BinTree rebalance(typename BSTree<T>::BinTree &tree, int left_tree_height, int right_tree_height,
+                                        int &height);
+  /**
+   * @brief Empties a tree whose nodes were taken, or copied, by join.
+   * @param source The tree.
+   * @param taken The tree join uses in place of source's nodes.
+   */
+  static void release_source(AVLTree &source, typename BSTree<T>::BinTree taken);
+  /**
+   * @brief Joins two trees with a middle node.
+   * @param left Tree holding the smaller values.
+   * @param left_tree_height Height of left.
+   * @param node Node holding the middle value.
+   * @param right Tree holding the larger values.
+   * @param right_tree_height Height of right.
+   * @param height Receives the height of the joined tree.
+   * @return Pointer to the root node of the joined tree.
+   */
+  typename BSTree<T>::BinTree join_nodes(typename BSTree<T>::BinTree left, int left_tree_height,
+                                         typename BSTree<T>::BinTree node, typename BSTree<T>::BinTree right,
+                                         int right_tree_height, int &height);
+  /**
+   * @brief Joins two trees without a middle node.
+   * @param left Tree holding the smaller values.
+   * @param left_tree_height Height of left.
+   * @param right Tree holding the larger values.
+   * @param right_tree_height Height of right.
+   * @param height Receives the height of the joined tree.
+   * @return Pointer to the root node of the joined tree.
+   */
+  typename BSTree<T>::BinTree join2(typename BSTree<T>::BinTree left, int left_tree_height,
+                                    typename BSTree<T>::BinTree right, int right_tree_height, int &height);
+  /**
+   * @brief Splits a tree at a value.
+   * @param tree Pointer to the root node of the tree.
+   * @param tree_height Height of the tree.
+   * @param value Value to split at.
+   * @param left Receives the tree of smaller values.
+   * @param left_tree_height Receives the height of left.
+   * @param found Receives the node holding value, or null.
+   * @param right Receives the tree of larger values.
+   * @param right_tree_height Receives the height of right.
+   */
+  void split_node(typename BSTree<T>::BinTree tree, int tree_height, const T &value,
+                  typename BSTree<T>::BinTree &left, int &left_tree_height, typename BSTree<T>::BinTree &found,
+                  typename BSTree<T>::BinTree &right, int &right_tree_height);
+  /**
+   * @brief Detaches the largest node of a tree.
+   * @param tree Pointer to the root node of a non-empty tree.
+   * @param tree_height Height of the tree.
+   * @param last Receives the largest node.
+   * @param height Receives the height of the remaining tree.
+   * @return Pointer to the root node of the remaining tree.
+   */
+  typename BSTree<T>::BinTree split_last(typename BSTree<T>::BinTree tree, int tree_height,
+                                         typename BSTree<T>::BinTree &last, int &height);
+  /**
+   * @brief Union of two trees, consuming both.
+   * @param lhs Pointer to the first tree.
+   * @param lhs_height Height of the first tree.
+   * @param rhs Pointer to the second tree.
+   * @param rhs_height Height of the second tree.
+   * @param depth Recursion depth.
+   * @param ctx Shared state of the operation.
+   * @param height Receives the height of the result.
+   * @return Pointer to the root node of the result.
+   */
+  typename BSTree<T>::BinTree union_nodes(typename BSTree<T>::BinTree lhs, int lhs_height,
+                                          typename BSTree<T>::BinTree rhs, int rhs_height, int depth,
+                                          SetOpContext &ctx, int &height);
+  /**
+   * @brief Intersection of two trees, consuming both.
+   * @param lhs Pointer to the first tree.
+   * @param lhs_height Height of the first tree.
+   * @param rhs Pointer to the second tree.
+   * @param rhs_height Height of the second tree.
+   * @param depth Recursion depth.
+   * @param ctx Shared state of the operation.
+   * @param height Receives the height of the result.
+   * @return Pointer to the root node of the result.
+   */
+  typename BSTree<T>::BinTree intersect_nodes(typename BSTree<T>::BinTree lhs, int lhs_height,
+                                              typename BSTree<T>::BinTree rhs, int rhs_height, int depth,
+                                              SetOpContext &ctx, int &height);
+  /**
+   * @brief Difference of two trees (lhs - rhs), consuming both.
+   * @param lhs Pointer to the first tree.
+   * @param lhs_height Height of the first tree.
+   * @param rhs Pointer to the second tree.
+   * @param rhs_height Height of the second tree.
+   * @param depth Recursion depth.
+   * @param ctx Shared state of the operation.
+   * @param height Receives the height of the result.
+   * @return Pointer to the root node of the result.
+   */
+  typename BSTree<T>::BinTree difference_nodes(typename BSTree<T>::BinTree lhs, int lhs_height,
+                                               typename BSTree<T>::BinTree rhs, int rhs_height, int depth,
+                                               SetOpContext &ctx, int &height);
+  /**
+   * @brief Runs two tasks, in parallel if the subtrees are large enough.
+   * @param size Number of nodes the tasks will visit.
+   * @param depth Recursion depth.
+   * @param ctx Shared state of the operation.
+   * @param left_task The first task.
+   * @param right_task The second task.
+   */
+  template <typename LeftTask, typename RightTask>
+  void fork_join(unsigned size, int depth, SetOpContext &ctx, LeftTask left_task, RightTask right_task);
+  /**
+   * @brief Frees a node from inside a set operation.
+   * @param node Pointer to the node.
+   * @param ctx Shared state of the operation.
+   */
+  void release_node(typename BSTree<T>::BinTree node, SetOpContext &ctx);
+  /**
+   * @brief Frees a whole tree from inside a set operation.
+   * @param tree Pointer to the root node of the tree.
+   * @param ctx Shared state of the operation.
+   */
+  void release_tree(typename BSTree<T>::BinTree tree, SetOpContext &ctx);
+  /**
+   * @brief Prepares the shared state of a set operation.
+   * @param ctx Shared state of the operation.
+   */
+  static void init_context(SetOpContext &ctx);
 };
 
 #include "AVLTree.cpp"
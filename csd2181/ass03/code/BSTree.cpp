@@ -15,7 +15,7 @@
  * @param ShareOA Flag indicating whether to share the ObjectAllocator.
  */
 template <typename T>
-BSTree<T>::BSTree(ObjectAllocator *oa, bool ShareOA) : root_(nullptr), oa_(oa), share_oa_(ShareOA)
+BSTree<T>::BSTree(ObjectAllocator *oa, bool ShareOA) : root_(nullptr), height_(-1), oa_(oa), share_oa_(ShareOA)
 {
     if (oa_ == nullptr)
     {
@@ -28,7 +28,7 @@ BSTree<T>::BSTree(ObjectAllocator *oa, bool ShareOA) : root_(nullptr), oa_(oa),
  * @param rhs Reference to the BSTree to be copied.
  */
 template <typename T>
-BSTree<T>::BSTree(const BSTree &rhs) : root_(nullptr), share_oa_(rhs.share_oa_)
+BSTree<T>::BSTree(const BSTree &rhs) : root_(nullptr), height_(rhs.height_), share_oa_(rhs.share_oa_)
 {
     if (share_oa_)
     {
@@ -67,6 +67,7 @@ BSTree<T> &BSTree<T>::operator=(const BSTree &rhs)
 
     clear();
     copy_tree(root_, rhs.root_);
+    height_ = rhs.height_;
     return *this;
 }
 /**
@@ -86,7 +87,12 @@ const typename BSTree<T>::BinTreeNode *BSTree<T>::operator[](int index) const
 template <typename T>
 void BSTree<T>::insert(const T &value)
 {
-    root_ = insert_node(root_, value);
+    bool grew = false;
+    root_ = insert_node(root_, value, grew);
+    if (grew)
+    {
+        ++height_;
+    }
 }
 /**
  * @brief Removes a node from the BST.
@@ -95,7 +101,12 @@ void BSTree<T>::insert(const T &value)
 template <typename T>
 void BSTree<T>::remove(const T &value)
 {
-    root_ = remove_node(root_, value);
+    bool shrank = false;
+    root_ = remove_node(root_, value, shrank);
+    if (shrank)
+    {
+        --height_;
+    }
 }
 /**
  * @brief Clears the BST.
@@ -105,6 +116,7 @@ void BSTree<T>::clear()
 {
     clear_tree(root_);
     root_ = nullptr;
+    height_ = -1;
 }
 /**
  * @brief Searches for a value in the BST.
@@ -137,13 +149,14 @@ unsigned int BSTree<T>::size() const
     return root_ == nullptr ? 0 : root_->count;
 }
 /**
- * @brief Returns the height of the BST.
+ * @brief Returns the height of the BST. The height is maintained on every
+ *        update, so this is O(1).
  * @return The height of the BST.
  */
 template <typename T>
 int BSTree<T>::height() const
 {
-    return tree_height(root_);
+    return height_;
 }
 /**
  * @brief Returns the root of the BST.
@@ -163,6 +176,15 @@ typename BSTree<T>::BinTree &BSTree<T>::get_root()
 {
     return root_;
 }
+/**
+ * @brief Returns the cached height of the BST.
+ * @return The cached height of the BST.
+ */
+template <typename T>
+int &BSTree<T>::get_height()
+{
+    return height_;
+}
 /**
  * @brief Creates a new node.
  * @param value The value to be stored in the new node.
@@ -208,6 +230,23 @@ int BSTree<T>::tree_height(BinTree tree) const
 {
     return tree == nullptr ? -1 : std::max(tree_height(tree->left), tree_height(tree->right)) + 1;
 }
+/**
+ * @brief Returns the height of a tree by following the taller side.
+ *        Every balance factor below tree must be up to date.
+ * @param tree Pointer to the root of the tree.
+ * @return The height of the tree.
+ */
+template <typename T>
+int BSTree<T>::node_height(BinTree tree) const
+{
+    int height = -1;
+    while (tree != nullptr)
+    {
+        ++height;
+        tree = tree->balance_factor > 0 ? tree->left : tree->right;
+    }
+    return height;
+}
 /**
  * @brief Finds the predecessor of a node.
  * @param tree Pointer to the node.
@@ -222,6 +261,56 @@ void BSTree<T>::find_predecessor(BinTree tree, BinTree &predecessor) const
         predecessor = predecessor->right;
     }
 }
+/**
+ * @brief Copies a tree into nodes from this tree's allocator. Nothing is
+ *        leaked if an allocation fails.
+ * @param src Pointer to the source tree.
+ * @return Pointer to the copy.
+ */
+template <typename T>
+typename BSTree<T>::BinTree BSTree<T>::clone_tree(BinTree src)
+{
+    BinTree dest = nullptr;
+    try
+    {
+        copy_tree(dest, src);
+    }
+    catch (...)
+    {
+        clear_tree(dest);
+        throw;
+    }
+    return dest;
+}
+/**
+ * @brief Checks if another tree allocates from the same allocator.
+ * @param rhs Reference to the other tree.
+ * @return true if nodes of rhs can be moved into this tree as they are.
+ */
+template <typename T>
+bool BSTree<T>::shares_allocator(const BSTree &rhs) const
+{
+    return rhs.oa_ == oa_;
+}
+/**
+ * @brief Moves a tree allocated by another tree's allocator into this one.
+ *        The nodes are copied (and the originals freed) if the trees do not
+ *        share an allocator.
+ * @param owner Reference to the tree whose allocator owns the nodes.
+ * @param tree Pointer to the tree to be moved.
+ * @return Pointer to a tree owned by this tree's allocator.
+ */
+template <typename T>
+typename BSTree<T>::BinTree BSTree<T>::adopt_tree(BSTree &owner, BinTree tree)
+{
+    if (shares_allocator(owner))
+    {
+        return tree;
+    }
+    BinTree copy = clone_tree(tree);
+    owner.clear_tree(tree);
+    return copy;
+}
 /**
  * @brief Copies a tree.
  * @param dest Reference to the pointer to the destination tree.
@@ -236,6 +325,7 @@ void BSTree<T>::copy_tree(BinTree &dest, BinTree src)
     {
         dest = make_node(src->data);
         dest->count = src->count;
+        dest->balance_factor = src->balance_factor;
         copy_tree(dest->left, src->left);
         copy_tree(dest->right, src->right);
     }
@@ -258,25 +348,39 @@ void BSTree<T>::clear_tree(BinTree &tree)
  * @brief Inserts a new node into a tree.
  * @param tree Reference to the pointer to the tree.
  * @param value The value to be inserted.
+ * @param grew Set to true if the height of the tree increased.
  * @return Pointer to the modified tree.
  */
 template <typename T>
-typename BSTree<T>::BinTree BSTree<T>::insert_node(BinTree &tree, const T &value)
+typename BSTree<T>::BinTree BSTree<T>::insert_node(BinTree &tree, const T &value, bool &grew)
 {
     if (tree == nullptr)
     {
         tree = make_node(value);
+        grew = true;
         return tree;
     }
-    // smaller value
+    // smaller value, this subtree grows only if the left side was not shorter
     else if (value < tree->data)
     {
-        tree->left = insert_node(tree->left, value);
+        tree->left = insert_node(tree->left, value, grew);
+        if (grew)
+        {
+            grew = ++tree->balance_factor > 0;
+        }
     }
     // larger value
     else if (value > tree->data)
     {
-        tree->right = insert_node(tree->right, value);
+        tree->right = insert_node(tree->right, value, grew);
+        if (grew)
+        {
+            grew = --tree->balance_factor < 0;
+        }
+    }
+    else
+    {
+        grew = false;
     }
     tree->count++;
     return tree;
@@ -285,24 +389,34 @@ typename BSTree<T>::BinTree BSTree<T>::insert_node(BinTree &tree, const T &value
  * @brief Removes a node from a tree.
  * @param tree Reference to the pointer to the tree.
  * @param value The value to be removed.
+ * @param shrank Set to true if the height of the tree decreased.
  * @return Pointer to the modified tree.
  */
 template <typename T>
-typename BSTree<T>::BinTree BSTree<T>::remove_node(BinTree &tree, const T &value)
+typename BSTree<T>::BinTree BSTree<T>::remove_node(BinTree &tree, const T &value, bool &shrank)
 {
     if (tree == nullptr)
     {
+        shrank = false;
         return tree;
     }
-    // smaller value
+    // smaller value, this subtree shrinks only if the left side was taller
     else if (value < tree->data)
     {
-        tree->left = remove_node(tree->left, value);
+        tree->left = remove_node(tree->left, value, shrank);
+        if (shrank)
+        {
+            shrank = --tree->balance_factor >= 0;
+        }
     }
     // larger value
     else if (value > tree->data)
     {
-        tree->right = remove_node(tree->right, value);
+        tree->right = remove_node(tree->right, value, shrank);
+        if (shrank)
+        {
+            shrank = ++tree->balance_factor <= 0;
+        }
     }
     else
     {
@@ -310,18 +424,24 @@ typename BSTree<T>::BinTree BSTree<T>::remove_node(BinTree &tree, const T &value
         {
             BinTree temp = tree->right;
             free_node(tree);
+            shrank = true;
             return temp;
         }
         else if (tree->right == nullptr)
         {
             BinTree temp = tree->left;
             free_node(tree);
+            shrank = true;
             return temp;
         }
         BinTree temp;
         find_predecessor(tree->left, temp);
         tree->data = temp->data;
-        tree->left = remove_node(tree->left, temp->data);
+        tree->left = remove_node(tree->left, temp->data, shrank);
+        if (shrank)
+        {
+            shrank = --tree->balance_factor >= 0;
+        }
     }
     tree->count--;
     return tree;
@@ -154,7 +154,8 @@ public:
    */
   unsigned int size() const;
   /**
-   * @brief Returns the height of the BST.
+   * @brief Returns the height of the BST. The height is maintained on every
+   *        update, so this is O(1).
    * @return The height of the BST.
    */
   int height() const;
@@ -170,6 +171,11 @@ protected:
    * @return The root of the BST.
    */
   BinTree &get_root();
+  /**
+   * @brief Returns the cached height of the BST.
+   * @return The cached height of the BST.
+   */
+  int &get_height();
   /**
    * @brief Creates a new node.
    * @param value The value to be stored in the new node.
@@ -187,16 +193,51 @@ protected:
    * @return The height of the tree.
    */
   int tree_height(BinTree tree) const;
+  /**
+   * @brief Returns the height of a tree by following the taller side.
+   *        Every balance factor below tree must be up to date.
+   * @param tree Pointer to the root of the tree.
+   * @return The height of the tree.
+   */
+  int node_height(BinTree tree) const;
   /**
    * @brief Finds the predecessor of a node.
    * @param tree Pointer to the node.
    * @param predecessor Reference to the pointer to the predecessor.
    */
   void find_predecessor(BinTree tree, BinTree &predecessor) const;
+  /**
+   * @brief Clears a tree.
+   * @param tree Pointer to the tree to be cleared.
+   */
+  void clear_tree(BinTree &tree);
+  /**
+   * @brief Copies a tree into nodes from this tree's allocator. Nothing is
+   *        leaked if an allocation fails.
+   * @param src Pointer to the source tree.
+   * @return Pointer to the copy.
+   */
+  BinTree clone_tree(BinTree src);
+  /**
+   * @brief Checks if another tree allocates from the same allocator.
+   * @param rhs Reference to the other tree.
+   * @return true if nodes of rhs can be moved into this tree as they are.
+   */
+  bool shares_allocator(const BSTree &rhs) const;
+  /**
+   * @brief Moves a tree allocated by another tree's allocator into this one.
+   *        The nodes are copied (and the originals freed) if the trees do not
+   *        share an allocator.
+   * @param owner Reference to the tree whose allocator owns the nodes.
+   * @param tree Pointer to the tree to be moved.
+   * @return Pointer to a tree owned by this tree's allocator.
+   */
+  BinTree adopt_tree(BSTree &owner, BinTree tree);
 
 private:
   // private stuff...
   BinTree root_;
+  int height_;
   ObjectAllocator *oa_;
   bool share_oa_;
   /**
@@ -205,25 +246,22 @@ private:
    * @param src Pointer to the source tree.
    */
   void copy_tree(BinTree &dest, BinTree src);
-  /**
-   * @brief Clears a tree.
-   * @param tree Pointer to the tree to be cleared.
-   */
-  void clear_tree(BinTree &tree);
   /**
    * @brief Inserts a new node into a tree.
    * @param tree Reference to the pointer to the tree.
    * @param value The value to be inserted.
+   * @param grew Set to true if the height of the tree increased.
    * @return Pointer to the modified tree.
    */
-  BinTree insert_node(BinTree &tree, const T &value);
+  BinTree insert_node(BinTree &tree, const T &value, bool &grew);
   /**
    * @brief Removes a node from a tree.
    * @param tree Reference to the pointer to the tree.
    * @param value The value to be removed.
+   * @param shrank Set to true if the height of the tree decreased.
    * @return Pointer to the modified tree.
    */
-  BinTree remove_node(BinTree &tree, const T &value);
+  BinTree remove_node(BinTree &tree, const T &value, bool &shrank);
   /**
    * @brief Finds the node at a specified index.
    * @param tree Pointer to the tree.
@@ -0,0 +1,626 @@
+/*!
+@file BTree.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the definition of the BTree class.
+*/
+#include "BTree.h"
+#include <utility> // std::move
+/**
+ * @brief Constructs a new BTree object.
+ * @param oa Pointer to an ObjectAllocator for memory management.
+ * @param ShareOA Flag indicating whether to share the ObjectAllocator.
+ */
+template <typename T>
+BTree<T>::BTree(ObjectAllocator *oa, bool ShareOA)
+    : root_(nullptr), oa_(oa), share_oa_(ShareOA), free_oa_(false), height_(-1)
+{
+    if (oa_ == nullptr)
+    {
+        OAConfig config(true);
+        oa_ = new ObjectAllocator(sizeof(BTreeNode), config);
+        free_oa_ = true;
+    }
+}
+/**
+ * @brief Copy constructor.
+ * @param rhs Reference to the BTree to be copied.
+ */
+template <typename T>
+BTree<T>::BTree(const BTree &rhs)
+    : root_(nullptr), oa_(nullptr), share_oa_(rhs.share_oa_), free_oa_(false), height_(rhs.height_)
+{
+    if (share_oa_)
+    {
+        oa_ = rhs.oa_;
+    }
+    else
+    {
+        OAConfig config(true);
+        oa_ = new ObjectAllocator(sizeof(BTreeNode), config);
+        free_oa_ = true;
+    }
+    root_ = copy_tree(rhs.root_);
+}
+/**
+ * @brief Destructor.
+ */
+template <typename T>
+BTree<T>::~BTree()
+{
+    clear();
+    if (free_oa_)
+    {
+        delete oa_;
+    }
+    oa_ = nullptr;
+}
+/**
+ * @brief Assignment operator.
+ * @param rhs Reference to the BTree to be assigned.
+ * @return Reference to the modified BTree.
+ */
+template <typename T>
+BTree<T> &BTree<T>::operator=(const BTree &rhs)
+{
+    if (this != &rhs)
+    {
+        clear();
+        root_ = copy_tree(rhs.root_);
+        height_ = rhs.height_;
+    }
+    return *this;
+}
+/**
+ * @brief Subscript operator for r-values.
+ * @param index The position of the key in sorted order.
+ * @return Pointer to the key at the specified index, or null if out of range.
+ */
+template <typename T>
+const T *BTree<T>::operator[](int index) const
+{
+    if (index < 0 || index >= static_cast<int>(size()))
+    {
+        return nullptr;
+    }
+    unsigned position = static_cast<unsigned>(index);
+    BNode node = root_;
+    while (!node->leaf)
+    {
+        unsigned i = 0;
+        for (; i < node->size; ++i)
+        {
+            unsigned left_count = node->children[i]->count;
+            if (position < left_count)
+            {
+                break;
+            }
+            else if (position == left_count)
+            {
+                return &node->keys[i];
+            }
+            position -= left_count + 1;
+        }
+        node = node->children[i];
+    }
+    return &node->keys[position];
+}
+/**
+ * @brief Inserts a new key into the tree.
+ * @param value The value to be inserted.
+ */
+template <typename T>
+void BTree<T>::insert(const T &value)
+{
+    if (root_ == nullptr)
+    {
+        root_ = make_node(true);
+        root_->keys[0] = value;
+        root_->size = 1;
+        root_->count = 1;
+        height_ = 0;
+        return;
+    }
+    // a full root is split first, which is the only way the tree grows
+    if (root_->size == MAX_KEYS)
+    {
+        BNode new_root = make_node(false);
+        new_root->children[0] = root_;
+        new_root->count = root_->count;
+        root_ = new_root;
+        split_child(root_, 0);
+        ++height_;
+    }
+    insert_nonfull(root_, value);
+}
+/**
+ * @brief Removes a key from the tree.
+ * @param value The value to be removed.
+ */
+template <typename T>
+void BTree<T>::remove(const T &value)
+{
+    if (root_ == nullptr)
+    {
+        return;
+    }
+    remove_node(root_, value);
+    // an empty root is dropped, which is the only way the tree shrinks
+    if (root_->size == 0)
+    {
+        BNode old_root = root_;
+        root_ = root_->leaf ? nullptr : root_->children[0];
+        free_node(old_root);
+        --height_;
+    }
+}
+/**
+ * @brief Clears the tree.
+ */
+template <typename T>
+void BTree<T>::clear()
+{
+    clear_tree(root_);
+    root_ = nullptr;
+    height_ = -1;
+}
+/**
+ * @brief Searches for a value in the tree.
+ * @param value The value to be searched for.
+ * @param compares The number of key comparisons made during the search.
+ * @return true if the value is found, false otherwise.
+ */
+template <typename T>
+bool BTree<T>::find(const T &value, unsigned &compares) const
+{
+    compares = 0;
+    BNode node = root_;
+    while (node != nullptr)
+    {
+        unsigned i = lower_bound(node, value, compares);
+        if (i < node->size)
+        {
+            compares++;
+            if (!(value < node->keys[i]))
+            {
+                return true;
+            }
+        }
+        node = node->leaf ? nullptr : node->children[i];
+    }
+    return false;
+}
+/**
+ * @brief Checks if the tree is empty.
+ * @return true if the tree is empty, false otherwise.
+ */
+template <typename T>
+bool BTree<T>::empty() const
+{
+    return root_ == nullptr;
+}
+/**
+ * @brief Returns the number of keys in the tree.
+ * @return The number of keys in the tree.
+ */
+template <typename T>
+unsigned int BTree<T>::size() const
+{
+    return root_ == nullptr ? 0 : root_->count;
+}
+/**
+ * @brief Returns the height of the tree (edges from the root to a leaf).
+ * @return The height of the tree, -1 if empty.
+ */
+template <typename T>
+int BTree<T>::height() const
+{
+    return height_;
+}
+/**
+ * @brief Returns the root of the tree.
+ * @return The root of the tree.
+ */
+template <typename T>
+const typename BTree<T>::BTreeNode *BTree<T>::root() const
+{
+    return root_;
+}
+/**
+ * @brief Creates a new empty node.
+ * @param leaf True for a leaf node.
+ * @return Pointer to the new node.
+ */
+template <typename T>
+typename BTree<T>::BNode BTree<T>::make_node(bool leaf) const
+{
+    try
+    {
+        BNode node = static_cast<BNode>(oa_->Allocate());
+        node = new (node) BTreeNode(leaf);
+        return node;
+    }
+    catch (const OAException &e)
+    {
+        throw BSTException{BSTException::BST_EXCEPTION::E_NO_MEMORY, "No memory"};
+    }
+}
+/**
+ * @brief Frees a node.
+ * @param node Pointer to the node to be freed.
+ */
+template <typename T>
+void BTree<T>::free_node(BNode node)
+{
+    node->~BTreeNode();
+    oa_->Free(node);
+}
+/**
+ * @brief Copies a tree.
+ * @param src Pointer to the source tree.
+ * @return Pointer to the copy.
+ */
+template <typename T>
+typename BTree<T>::BNode BTree<T>::copy_tree(BNode src)
+{
+    if (src == nullptr)
+    {
+        return nullptr;
+    }
+    BNode dest = make_node(src->leaf);
+    dest->size = src->size;
+    dest->count = src->count;
+    for (unsigned i = 0; i < src->size; ++i)
+    {
+        dest->keys[i] = src->keys[i];
+    }
+    if (!src->leaf)
+    {
+        for (unsigned i = 0; i <= src->size; ++i)
+        {
+            dest->children[i] = copy_tree(src->children[i]);
+        }
+    }
+    return dest;
+}
+/**
+ * @brief Clears a tree.
+ * @param tree Pointer to the tree to be cleared.
+ */
+template <typename T>
+void BTree<T>::clear_tree(BNode tree)
+{
+    if (tree != nullptr)
+    {
+        if (!tree->leaf)
+        {
+            for (unsigned i = 0; i <= tree->size; ++i)
+            {
+                clear_tree(tree->children[i]);
+            }
+        }
+        free_node(tree);
+    }
+}
+/**
+ * @brief Finds the first key in a node that is not less than value.
+ * @param node Pointer to the node.
+ * @param value The value to be searched for.
+ * @param compares Incremented once per key comparison.
+ * @return The index of the key (node->size if every key is smaller).
+ */
+template <typename T>
+unsigned BTree<T>::lower_bound(BNode node, const T &value, unsigned &compares)
+{
+    unsigned low = 0, high = node->size;
+    while (low < high)
+    {
+        unsigned mid = (low + high) / 2;
+        compares++;
+        if (node->keys[mid] < value)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return low;
+}
+/**
+ * @brief Recomputes the subtree size of a node from its keys and children.
+ * @param node Pointer to the node.
+ */
+template <typename T>
+void BTree<T>::recount(BNode node)
+{
+    node->count = node->size;
+    if (!node->leaf)
+    {
+        for (unsigned i = 0; i <= node->size; ++i)
+        {
+            node->count += node->children[i]->count;
+        }
+    }
+}
+/**
+ * @brief Splits the full child at index into two nodes.
+ * @param parent Pointer to a non-full parent.
+ * @param index Index of the full child.
+ */
+template <typename T>
+void BTree<T>::split_child(BNode parent, unsigned index)
+{
+    BNode full = parent->children[index];
+    BNode sibling = make_node(full->leaf);
+    // the upper MIN_DEGREE - 1 keys move to the new sibling
+    sibling->size = MIN_DEGREE - 1;
+    for (unsigned i = 0; i < MIN_DEGREE - 1; ++i)
+    {
+        sibling->keys[i] = std::move(full->keys[i + MIN_DEGREE]);
+    }
+    if (!full->leaf)
+    {
+        for (unsigned i = 0; i < MIN_DEGREE; ++i)
+        {
+            sibling->children[i] = full->children[i + MIN_DEGREE];
+        }
+    }
+    full->size = MIN_DEGREE - 1;
+    // the median key moves up into the parent
+    for (unsigned i = parent->size; i > index; --i)
+    {
+        parent->keys[i] = std::move(parent->keys[i - 1]);
+        parent->children[i + 1] = parent->children[i];
+    }
+    parent->keys[index] = std::move(full->keys[MIN_DEGREE - 1]);
+    parent->children[index + 1] = sibling;
+    parent->size++;
+    recount(full);
+    recount(sibling);
+}
+/**
+ * @brief Inserts a value into a subtree whose root is not full.
+ * @param node Pointer to the subtree.
+ * @param value The value to be inserted.
+ * @return true if the value was inserted, false if it was a duplicate.
+ */
+template <typename T>
+bool BTree<T>::insert_nonfull(BNode node, const T &value)
+{
+    unsigned compares = 0;
+    unsigned i = lower_bound(node, value, compares);
+    if (i < node->size && !(value < node->keys[i]))
+    {
+        return false;
+    }
+    if (node->leaf)
+    {
+        for (unsigned j = node->size; j > i; --j)
+        {
+            node->keys[j] = std::move(node->keys[j - 1]);
+        }
+        node->keys[i] = value;
+        node->size++;
+        node->count++;
+        return true;
+    }
+    if (node->children[i]->size == MAX_KEYS)
+    {
+        split_child(node, i);
+        if (node->keys[i] < value)
+        {
+            ++i;
+        }
+        else if (!(value < node->keys[i]))
+        {
+            return false;
+        }
+    }
+    bool inserted = insert_nonfull(node->children[i], value);
+    if (inserted)
+    {
+        node->count++;
+    }
+    return inserted;
+}
+/**
+ * @brief Removes a value from a subtree whose root has at least MIN_DEGREE keys
+ *        (or is the root of the tree).
+ * @param node Pointer to the subtree.
+ * @param value The value to be removed.
+ * @return true if the value was removed.
+ */
+template <typename T>
+bool BTree<T>::remove_node(BNode node, const T &value)
+{
+    unsigned compares = 0;
+    unsigned i = lower_bound(node, value, compares);
+    bool found = i < node->size && !(value < node->keys[i]);
+
+    if (found && node->leaf)
+    {
+        for (unsigned j = i + 1; j < node->size; ++j)
+        {
+            node->keys[j - 1] = std::move(node->keys[j]);
+        }
+        node->size--;
+        node->count--;
+        return true;
+    }
+    if (found)
+    {
+        BNode left = node->children[i];
+        BNode right = node->children[i + 1];
+        // replace with the predecessor
+        if (left->size >= MIN_DEGREE)
+        {
+            BNode pred = left;
+            while (!pred->leaf)
+            {
+                pred = pred->children[pred->size];
+            }
+            node->keys[i] = pred->keys[pred->size - 1];
+            remove_node(left, node->keys[i]);
+        }
+        // replace with the successor
+        else if (right->size >= MIN_DEGREE)
+        {
+            BNode succ = right;
+            while (!succ->leaf)
+            {
+                succ = succ->children[0];
+            }
+            node->keys[i] = succ->keys[0];
+            remove_node(right, node->keys[i]);
+        }
+        // both children are minimal, push the key down into the merged child
+        else
+        {
+            merge_children(node, i);
+            remove_node(left, value);
+        }
+        node->count--;
+        return true;
+    }
+    if (node->leaf)
+    {
+        return false;
+    }
+    if (node->children[i]->size < MIN_DEGREE)
+    {
+        i = fill_child(node, i);
+    }
+    bool removed = remove_node(node->children[i], value);
+    if (removed)
+    {
+        node->count--;
+    }
+    return removed;
+}
+/**
+ * @brief Ensures the child at index has at least MIN_DEGREE keys.
+ * @param parent Pointer to the parent.
+ * @param index Index of the child.
+ * @return Index of the child that now covers the same key range.
+ */
+template <typename T>
+unsigned BTree<T>::fill_child(BNode parent, unsigned index)
+{
+    if (index > 0 && parent->children[index - 1]->size >= MIN_DEGREE)
+    {
+        borrow_from_prev(parent, index);
+    }
+    else if (index < parent->size && parent->children[index + 1]->size >= MIN_DEGREE)
+    {
+        borrow_from_next(parent, index);
+    }
+    else if (index < parent->size)
+    {
+        merge_children(parent, index);
+    }
+    else
+    {
+        merge_children(parent, index - 1);
+        --index;
+    }
+    return index;
+}
+/**
+ * @brief Moves a key from the left sibling through the parent into a child.
+ * @param parent Pointer to the parent.
+ * @param index Index of the child.
+ */
+template <typename T>
+void BTree<T>::borrow_from_prev(BNode parent, unsigned index)
+{
+    BNode child = parent->children[index];
+    BNode sibling = parent->children[index - 1];
+    for (unsigned i = child->size; i > 0; --i)
+    {
+        child->keys[i] = std::move(child->keys[i - 1]);
+    }
+    if (!child->leaf)
+    {
+        for (unsigned i = child->size + 1; i > 0; --i)
+        {
+            child->children[i] = child->children[i - 1];
+        }
+        child->children[0] = sibling->children[sibling->size];
+    }
+    child->keys[0] = std::move(parent->keys[index - 1]);
+    parent->keys[index - 1] = std::move(sibling->keys[sibling->size - 1]);
+    child->size++;
+    sibling->size--;
+    recount(child);
+    recount(sibling);
+}
+/**
+ * @brief Moves a key from the right sibling through the parent into a child.
+ * @param parent Pointer to the parent.
+ * @param index Index of the child.
+ */
+template <typename T>
+void BTree<T>::borrow_from_next(BNode parent, unsigned index)
+{
+    BNode child = parent->children[index];
+    BNode sibling = parent->children[index + 1];
+    child->keys[child->size] = std::move(parent->keys[index]);
+    if (!child->leaf)
+    {
+        child->children[child->size + 1] = sibling->children[0];
+    }
+    parent->keys[index] = std::move(sibling->keys[0]);
+    for (unsigned i = 1; i < sibling->size; ++i)
+    {
+        sibling->keys[i - 1] = std::move(sibling->keys[i]);
+    }
+    if (!sibling->leaf)
+    {
+        for (unsigned i = 1; i <= sibling->size; ++i)
+        {
+            sibling->children[i - 1] = sibling->children[i];
+        }
+    }
+    child->size++;
+    sibling->size--;
+    recount(child);
+    recount(sibling);
+}
+/**
+ * @brief Merges the child at index, the separating key and the next child.
+ * @param parent Pointer to the parent.
+ * @param index Index of the left child.
+ */
+template <typename T>
+void BTree<T>::merge_children(BNode parent, unsigned index)
+{
+    BNode child = parent->children[index];
+    BNode sibling = parent->children[index + 1];
+    child->keys[child->size] = std::move(parent->keys[index]);
+    for (unsigned i = 0; i < sibling->size; ++i)
+    {
+        child->keys[child->size + 1 + i] = std::move(sibling->keys[i]);
+    }
+    if (!child->leaf)
+    {
+        for (unsigned i = 0; i <= sibling->size; ++i)
+        {
+            child->children[child->size + 1 + i] = sibling->children[i];
+        }
+    }
+    child->size += sibling->size + 1;
+    for (unsigned i = index + 1; i < parent->size; ++i)
+    {
+        parent->keys[i - 1] = std::move(parent->keys[i]);
+        parent->children[i] = parent->children[i + 1];
+    }
+    parent->size--;
+    recount(child);
+    free_node(sibling);
+}
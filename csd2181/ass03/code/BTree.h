@@ -0,0 +1,215 @@
+/*!
+@file BTree.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the declaration of the BTree class, an ordered set
+       with the BSTree interface that stores many keys per node.
+*/
+//---------------------------------------------------------------------------
+#ifndef BTREE_H
+#define BTREE_H
+//---------------------------------------------------------------------------
+#include "BSTree.h" // BSTException
+#include "ObjectAllocator.h"
+
+/*!
+  A B-tree ordered set. Each node holds up to MAX_KEYS sorted keys, sized so a
+  node spans a few cache lines, so a search touches one node per level instead
+  of one node per comparison. Every node also stores the size of its subtree
+  for indexing.
+*/
+template <typename T>
+class BTree
+{
+public:
+  //! Target size of a node in bytes (four 64-byte cache lines)
+  static const unsigned NODE_BYTES = 256;
+  //! Minimum degree: every node but the root has MIN_DEGREE - 1 to MAX_KEYS keys
+  static const unsigned MIN_DEGREE = (NODE_BYTES / (sizeof(T) + sizeof(void *)) + 1) / 2 < 2
+                                         ? 2
+                                         : (NODE_BYTES / (sizeof(T) + sizeof(void *)) + 1) / 2;
+  //! Maximum number of keys in a node
+  static const unsigned MAX_KEYS = 2 * MIN_DEGREE - 1;
+
+  //! The node structure
+  struct BTreeNode
+  {
+    unsigned size;                       //!< Number of keys in use
+    unsigned count;                      //!< Keys in this subtree for efficient indexing
+    bool leaf;                           //!< True if the node has no children
+    T keys[MAX_KEYS];                    //!< The sorted keys
+    BTreeNode *children[MAX_KEYS + 1];   //!< The children (internal nodes only)
+
+    //! Conversion constructor
+    BTreeNode(bool is_leaf) : size(0), count(0), leaf(is_leaf), keys(), children(){};
+  };
+
+  /**
+   * @brief Constructs a new BTree object.
+   * @param oa Pointer to an ObjectAllocator for memory management.
+   * @param ShareOA Flag indicating whether to share the ObjectAllocator.
+   */
+  BTree(ObjectAllocator *oa = 0, bool ShareOA = false);
+  /**
+   * @brief Copy constructor.
+   * @param rhs Reference to the BTree to be copied.
+   */
+  BTree(const BTree &rhs);
+  /**
+   * @brief Destructor.
+   */
+  ~BTree();
+  /**
+   * @brief Assignment operator.
+   * @param rhs Reference to the BTree to be assigned.
+   * @return Reference to the modified BTree.
+   */
+  BTree &operator=(const BTree &rhs);
+  /**
+   * @brief Subscript operator for r-values.
+   * @param index The position of the key in sorted order.
+   * @return Pointer to the key at the specified index, or null if out of range.
+   */
+  const T *operator[](int index) const;
+  /**
+   * @brief Inserts a new key into the tree.
+   * @param value The value to be inserted.
+   */
+  void insert(const T &value);
+  /**
+   * @brief Removes a key from the tree.
+   * @param value The value to be removed.
+   */
+  void remove(const T &value);
+  /**
+   * @brief Clears the tree.
+   */
+  void clear();
+  /**
+   * @brief Searches for a value in the tree.
+   * @param value The value to be searched for.
+   * @param compares The number of key comparisons made during the search.
+   * @return true if the value is found, false otherwise.
+   */
+  bool find(const T &value, unsigned &compares) const;
+  /**
+   * @brief Checks if the tree is empty.
+   * @return true if the tree is empty, false otherwise.
+   */
+  bool empty() const;
+  /**
+   * @brief Returns the number of keys in the tree.
+   * @return The number of keys in the tree.
+   */
+  unsigned int size() const;
+  /**
+   * @brief Returns the height of the tree (edges from the root to a leaf).
+   * @return The height of the tree, -1 if empty.
+   */
+  int height() const;
+  /**
+   * @brief Returns the root of the tree.
+   * @return The root of the tree.
+   */
+  const BTreeNode *root() const;
+
+private:
+  typedef BTreeNode *BNode;
+
+  BNode root_;
+  ObjectAllocator *oa_;
+  bool share_oa_;
+  bool free_oa_;
+  int height_;
+
+  /**
+   * @brief Creates a new empty node.
+   * @param leaf True for a leaf node.
+   * @return Pointer to the new node.
+   */
+  BNode make_node(bool leaf) const;
+  /**
+   * @brief Frees a node.
+   * @param node Pointer to the node to be freed.
+   */
+  void free_node(BNode node);
+  /**
+   * @brief Copies a tree.
+   * @param src Pointer to the source tree.
+   * @return Pointer to the copy.
+   */
+  BNode copy_tree(BNode src);
+  /**
+   * @brief Clears a tree.
+   * @param tree Pointer to the tree to be cleared.
+   */
+  void clear_tree(BNode tree);
+  /**
+   * @brief Finds the first key in a node that is not less than value.
+   * @param node Pointer to the node.
+   * @param value The value to be searched for.
+   * @param compares Incremented once per key comparison.
+   * @return The index of the key (node->size if every key is smaller).
+   */
+  static unsigned lower_bound(BNode node, const T &value, unsigned &compares);
+  /**
+   * @brief Recomputes the subtree size of a node from its keys and children.
+   * @param node Pointer to the node.
+   */
+  static void recount(BNode node);
+  /**
+   * @brief Splits the full child at index into two nodes.
+   * @param parent Pointer to a non-full parent.
+   * @param index Index of the full child.
+   */
+  void split_child(BNode parent, unsigned index);
+  /**
+   * @brief Inserts a value into a subtree whose root is not full.
+   * @param node Pointer to the subtree.
+   * @param value The value to be inserted.
+   * @return true if the value was inserted, false if it was a duplicate.
+   */
+  bool insert_nonfull(BNode node, const T &value);
+  /**
+   * @brief Removes a value from a subtree whose root has at least MIN_DEGREE keys
+   *        (or is the root of the tree).
+   * @param node Pointer to the subtree.
+   * @param value The value to be removed.
+   * @return true if the value was removed.
+   */
+  bool remove_node(BNode node, const T &value);
+  /**
+   * @brief Ensures the child at index has at least MIN_DEGREE keys.
+   * @param parent Pointer to the parent.
+   * @param index Index of the child.
+   * @return Index of the child that now covers the same key range.
+   */
+  unsigned fill_child(BNode parent, unsigned index);
+  /**
+   * @brief Moves a key from the left sibling through the parent into a child.
+   * @param parent Pointer to the parent.
+   * @param index Index of the child.
+   */
+  void borrow_from_prev(BNode parent, unsigned index);
+  /**
+   * @brief Moves a key from the right sibling through the parent into a child.
+   * @param parent Pointer to the parent.
+   * @param index Index of the child.
+   */
+  void borrow_from_next(BNode parent, unsigned index);
+  /**
+   * @brief Merges the child at index, the separating key and the next child.
+   * @param parent Pointer to the parent.
+   * @param index Index of the left child.
+   */
+  void merge_children(BNode parent, unsigned index);
+};
+
+#include "BTree.cpp"
+
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,532 @@
+/*!
+@file ConcurrentAVLTree.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the definition of the ConcurrentAVLTree class.
+*/
+#include "ConcurrentAVLTree.h"
+#include <algorithm> // std::max
+#include <functional> // std::hash
+#include <thread>    // std::this_thread
+#include <new>       // std::bad_alloc
+/**
+ * @brief Constructs a new ConcurrentAVLTree object.
+ * @param oa Pointer to an ObjectAllocator for memory management.
+ */
+template <typename T>
+ConcurrentAVLTree<T>::ConcurrentAVLTree(ObjectAllocator *oa) : root_(nullptr), oa_(oa), free_oa_(false), epoch_(0)
+{
+    if (oa_ == nullptr)
+    {
+        OAConfig config(true);
+        oa_ = new ObjectAllocator(sizeof(CAVLNode), config);
+        free_oa_ = true;
+    }
+    for (unsigned slot = 0; slot < 2; ++slot)
+    {
+        for (unsigned stripe = 0; stripe < READER_STRIPES; ++stripe)
+        {
+            readers_[slot][stripe].value.store(0);
+        }
+    }
+}
+/**
+ * @brief Destructor. No reader or writer may be active.
+ */
+template <typename T>
+ConcurrentAVLTree<T>::~ConcurrentAVLTree()
+{
+    clear();
+    if (free_oa_)
+    {
+        delete oa_;
+    }
+    oa_ = nullptr;
+}
+/**
+ * @brief Inserts a value. Serialized with other writers.
+ * @param value The value to be inserted.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::insert(const T &value)
+{
+    std::lock_guard<std::mutex> lock(writer_lock_);
+    CAVLTree old_root = root_.load();
+    CAVLTree new_root;
+    try
+    {
+        new_root = insert_node(old_root, value);
+    }
+    catch (...)
+    {
+        abandon();
+        throw;
+    }
+    commit(old_root, new_root);
+    if (retired_.size() >= RETIRE_BATCH)
+    {
+        reclaim();
+    }
+}
+/**
+ * @brief Removes a value. Serialized with other writers.
+ * @param value The value to be removed.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::remove(const T &value)
+{
+    std::lock_guard<std::mutex> lock(writer_lock_);
+    CAVLTree old_root = root_.load();
+    CAVLTree new_root;
+    try
+    {
+        new_root = remove_node(old_root, value);
+    }
+    catch (...)
+    {
+        abandon();
+        throw;
+    }
+    commit(old_root, new_root);
+    if (retired_.size() >= RETIRE_BATCH)
+    {
+        reclaim();
+    }
+}
+/**
+ * @brief Removes every value. Serialized with other writers.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::clear()
+{
+    std::lock_guard<std::mutex> lock(writer_lock_);
+    CAVLTree old_root = root_.load();
+    try
+    {
+        retire_tree(old_root);
+    }
+    catch (...)
+    {
+        abandon();
+        throw;
+    }
+    commit(old_root, nullptr);
+    reclaim();
+}
+/**
+ * @brief Searches for a value without taking any lock.
+ * @param value The value to be searched for.
+ * @param compares The number of comparisons made during the search.
+ * @return true if the value is found, false otherwise.
+ */
+template <typename T>
+bool ConcurrentAVLTree<T>::find(const T &value, unsigned &compares) const
+{
+    ReadGuard guard(*this);
+    compares = 0;
+    CAVLTree node = root_.load();
+    while (true)
+    {
+        compares++;
+        if (node == nullptr)
+        {
+            return false;
+        }
+        else if (value < node->data)
+        {
+            node = node->left;
+        }
+        else if (value > node->data)
+        {
+            node = node->right;
+        }
+        else
+        {
+            return true;
+        }
+    }
+}
+/**
+ * @brief Checks if the tree is empty.
+ * @return true if the tree is empty, false otherwise.
+ */
+template <typename T>
+bool ConcurrentAVLTree<T>::empty() const
+{
+    return root_.load() == nullptr;
+}
+/**
+ * @brief Returns the number of nodes in the tree.
+ * @return The number of nodes in the tree.
+ */
+template <typename T>
+unsigned int ConcurrentAVLTree<T>::size() const
+{
+    ReadGuard guard(*this);
+    return tree_size(root_.load());
+}
+/**
+ * @brief Returns the height of the tree.
+ * @return The height of the tree.
+ */
+template <typename T>
+int ConcurrentAVLTree<T>::height() const
+{
+    ReadGuard guard(*this);
+    return tree_height(root_.load());
+}
+/**
+ * @brief Enters a read-side critical section.
+ * @param tree The tree being read.
+ */
+template <typename T>
+ConcurrentAVLTree<T>::ReadGuard::ReadGuard(const ConcurrentAVLTree &tree)
+    : counter_(tree.readers_[tree.epoch_.load() & 1][reader_stripe()].value)
+{
+    counter_.fetch_add(1);
+}
+/**
+ * @brief Leaves the read-side critical section.
+ */
+template <typename T>
+ConcurrentAVLTree<T>::ReadGuard::~ReadGuard()
+{
+    counter_.fetch_sub(1);
+}
+/**
+ * @brief Returns the reader stripe of the calling thread.
+ * @return The stripe index.
+ */
+template <typename T>
+unsigned ConcurrentAVLTree<T>::reader_stripe()
+{
+    static thread_local unsigned stripe =
+        static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id()) % READER_STRIPES);
+    return stripe;
+}
+/**
+ * @brief Creates a new node.
+ * @param value The value to be stored in the new node.
+ * @param left The left child.
+ * @param right The right child.
+ * @return Pointer to the new node.
+ */
+template <typename T>
+typename ConcurrentAVLTree<T>::CAVLTree ConcurrentAVLTree<T>::make_node(const T &value, CAVLTree left, CAVLTree right)
+{
+    CAVLTree node;
+    try
+    {
+        void *mem = oa_->Allocate();
+        node = new (mem) CAVLNode(value, left, right,
+                                  std::max(tree_height(left), tree_height(right)) + 1,
+                                  tree_size(left) + tree_size(right) + 1);
+    }
+    catch (const OAException &e)
+    {
+        throw BSTException{BSTException::BST_EXCEPTION::E_NO_MEMORY, "No memory"};
+    }
+    try
+    {
+        created_.push_back(node);
+    }
+    catch (const std::bad_alloc &e)
+    {
+        free_node(node);
+        throw BSTException{BSTException::BST_EXCEPTION::E_NO_MEMORY, "No memory"};
+    }
+    return node;
+}
+/**
+ * @brief Frees a node immediately.
+ * @param node Pointer to the node to be freed.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::free_node(CAVLTree node)
+{
+    CAVLNode *mutable_node = const_cast<CAVLNode *>(node);
+    mutable_node->~CAVLNode();
+    oa_->Free(mutable_node);
+}
+/**
+ * @brief Records a node the current write replaces.
+ *
+ * The node is still reachable from the published root, so it only joins
+ * retired_ in commit, once the new root is published. A write that fails
+ * leaves it where it is.
+ *
+ * @param node Pointer to the node to be retired once the write is published.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::retire(CAVLTree node)
+{
+    try
+    {
+        replaced_.push_back(node);
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw BSTException{BSTException::BST_EXCEPTION::E_NO_MEMORY, "No memory"};
+    }
+}
+/**
+ * @brief Publishes a new root and retires the nodes the write replaced.
+ *
+ * Nodes the write both made and replaced (an intermediate copy rebuilt by a
+ * rotation) were never published and are retired with the others. If
+ * retired_ cannot grow, the replaced nodes are leaked rather than freed
+ * while readers may still hold them.
+ *
+ * @param old_root The root the write started from.
+ * @param new_root The root the write built.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::commit(CAVLTree old_root, CAVLTree new_root)
+{
+    if (new_root != old_root)
+    {
+        root_.store(new_root);
+    }
+    created_.clear();
+    try
+    {
+        retired_.insert(retired_.end(), replaced_.begin(), replaced_.end());
+    }
+    catch (const std::bad_alloc &e)
+    {
+    }
+    replaced_.clear();
+}
+/**
+ * @brief Frees the nodes of a failed write, leaving the published tree as it was.
+ *
+ * No reader can reach a node the write made, so they are freed at once. The
+ * nodes it meant to replace are still in the published tree and are kept.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::abandon()
+{
+    for (CAVLTree node : created_)
+    {
+        free_node(node);
+    }
+    created_.clear();
+    replaced_.clear();
+}
+/**
+ * @brief Waits until no reader can hold a retired node, then frees them.
+ *
+ * Readers register on the counter of the epoch they observed. Flipping the
+ * epoch twice and draining the old counter each time guarantees that every
+ * reader that started before the flip has finished, while new readers land on
+ * the other counter and cannot starve the writer.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::reclaim()
+{
+    if (retired_.empty())
+    {
+        return;
+    }
+    for (int phase = 0; phase < 2; ++phase)
+    {
+        unsigned old_slot = epoch_.fetch_add(1) & 1;
+        for (unsigned stripe = 0; stripe < READER_STRIPES; ++stripe)
+        {
+            while (readers_[old_slot][stripe].value.load() != 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+    for (CAVLTree node : retired_)
+    {
+        free_node(node);
+    }
+    retired_.clear();
+}
+/**
+ * @brief Retires every node of a tree.
+ * @param tree Pointer to the tree.
+ */
+template <typename T>
+void ConcurrentAVLTree<T>::retire_tree(CAVLTree tree)
+{
+    if (tree != nullptr)
+    {
+        retire_tree(tree->left);
+        retire_tree(tree->right);
+        retire(tree);
+    }
+}
+/**
+ * @brief Builds a balanced node from a value and two subtrees.
+ * @param value The value of the new node.
+ * @param left The left subtree.
+ * @param right The right subtree.
+ * @return Pointer to the root of the balanced subtree.
+ */
+template <typename T>
+typename ConcurrentAVLTree<T>::CAVLTree ConcurrentAVLTree<T>::balance(const T &value, CAVLTree left, CAVLTree right)
+{
+    int left_height = tree_height(left);
+    int right_height = tree_height(right);
+    // right rotation
+    if (left_height > right_height + 1)
+    {
+        if (tree_height(left->left) >= tree_height(left->right))
+        {
+            CAVLTree result = make_node(left->data, left->left, make_node(value, left->right, right));
+            retire(left);
+            return result;
+        }
+        CAVLTree pivot = left->right;
+        CAVLTree result = make_node(pivot->data,
+                                    make_node(left->data, left->left, pivot->left),
+                                    make_node(value, pivot->right, right));
+        retire(left);
+        retire(pivot);
+        return result;
+    }
+    // left rotation
+    if (right_height > left_height + 1)
+    {
+        if (tree_height(right->right) >= tree_height(right->left))
+        {
+            CAVLTree result = make_node(right->data, make_node(value, left, right->left), right->right);
+            retire(right);
+            return result;
+        }
+        CAVLTree pivot = right->left;
+        CAVLTree result = make_node(pivot->data,
+                                    make_node(value, left, pivot->left),
+                                    make_node(right->data, pivot->right, right->right));
+        retire(right);
+        retire(pivot);
+        return result;
+    }
+    return make_node(value, left, right);
+}
+/**
+ * @brief Inserts a value by copying the search path.
+ * @param tree Pointer to the tree.
+ * @param value The value to be inserted.
+ * @return Pointer to the new tree (the same tree if nothing changed).
+ */
+template <typename T>
+typename ConcurrentAVLTree<T>::CAVLTree ConcurrentAVLTree<T>::insert_node(CAVLTree tree, const T &value)
+{
+    if (tree == nullptr)
+    {
+        return make_node(value, nullptr, nullptr);
+    }
+    if (value < tree->data)
+    {
+        CAVLTree left = insert_node(tree->left, value);
+        if (left == tree->left)
+        {
+            return tree;
+        }
+        retire(tree);
+        return balance(tree->data, left, tree->right);
+    }
+    else if (value > tree->data)
+    {
+        CAVLTree right = insert_node(tree->right, value);
+        if (right == tree->right)
+        {
+            return tree;
+        }
+        retire(tree);
+        return balance(tree->data, tree->left, right);
+    }
+    return tree;
+}
+/**
+ * @brief Removes a value by copying the search path.
+ * @param tree Pointer to the tree.
+ * @param value The value to be removed.
+ * @return Pointer to the new tree (the same tree if nothing changed).
+ */
+template <typename T>
+typename ConcurrentAVLTree<T>::CAVLTree ConcurrentAVLTree<T>::remove_node(CAVLTree tree, const T &value)
+{
+    if (tree == nullptr)
+    {
+        return tree;
+    }
+    if (value < tree->data)
+    {
+        CAVLTree left = remove_node(tree->left, value);
+        if (left == tree->left)
+        {
+            return tree;
+        }
+        retire(tree);
+        return balance(tree->data, left, tree->right);
+    }
+    else if (value > tree->data)
+    {
+        CAVLTree right = remove_node(tree->right, value);
+        if (right == tree->right)
+        {
+            return tree;
+        }
+        retire(tree);
+        return balance(tree->data, tree->left, right);
+    }
+    retire(tree);
+    if (tree->left == nullptr)
+    {
+        return tree->right;
+    }
+    else if (tree->right == nullptr)
+    {
+        return tree->left;
+    }
+    T successor = tree->right->data;
+    CAVLTree right = remove_min(tree->right, successor);
+    return balance(successor, tree->left, right);
+}
+/**
+ * @brief Removes the smallest value by copying the leftmost path.
+ * @param tree Pointer to a non-empty tree.
+ * @param min Receives the removed value.
+ * @return Pointer to the new tree.
+ */
+template <typename T>
+typename ConcurrentAVLTree<T>::CAVLTree ConcurrentAVLTree<T>::remove_min(CAVLTree tree, T &min)
+{
+    retire(tree);
+    if (tree->left == nullptr)
+    {
+        min = tree->data;
+        return tree->right;
+    }
+    CAVLTree left = remove_min(tree->left, min);
+    return balance(tree->data, left, tree->right);
+}
+/**
+ * @brief Returns the height of a tree.
+ * @param tree Pointer to the tree.
+ * @return The height of the tree.
+ */
+template <typename T>
+int ConcurrentAVLTree<T>::tree_height(CAVLTree tree)
+{
+    return tree == nullptr ? -1 : tree->height;
+}
+/**
+ * @brief Returns the number of nodes in a tree.
+ * @param tree Pointer to the tree.
+ * @return The number of nodes in the tree.
+ */
+template <typename T>
+unsigned ConcurrentAVLTree<T>::tree_size(CAVLTree tree)
+{
+    return tree == nullptr ? 0 : tree->count;
+}
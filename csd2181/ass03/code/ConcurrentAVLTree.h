@@ -0,0 +1,236 @@
+/*!
+@file ConcurrentAVLTree.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the declaration of the ConcurrentAVLTree class, an AVL
+       tree that many threads can read without locks while writers serialize.
+*/
+//---------------------------------------------------------------------------
+#ifndef CONCURRENTAVLTREE_H
+#define CONCURRENTAVLTREE_H
+//---------------------------------------------------------------------------
+#include <atomic> // std::atomic
+#include <mutex>  // std::mutex
+#include <vector> // std::vector
+
+#include "BSTree.h" // BSTException
+#include "ObjectAllocator.h"
+
+/*!
+  An AVL tree for read-mostly workloads.
+
+  Nodes are never modified once they are reachable from the root. A writer
+  copies the path it changes (RCU-style node replacement) and publishes the new
+  root with a single atomic store, so a reader always walks a consistent
+  snapshot without taking a lock. Replaced nodes are retired and only returned
+  to the allocator after a grace period in which every reader that could still
+  see them has left.
+
+  Writers (insert, remove, clear) serialize among themselves on a mutex.
+*/
+template <typename T>
+class ConcurrentAVLTree
+{
+public:
+  //! The node structure (immutable once published)
+  struct CAVLNode
+  {
+    const CAVLNode *left;  //!< The left child
+    const CAVLNode *right; //!< The right child
+    T data;                //!< The data
+    int height;            //!< Height of this subtree
+    unsigned count;        //!< Nodes in this subtree
+
+    //! Conversion constructor
+    CAVLNode(const T &value, const CAVLNode *l, const CAVLNode *r, int h, unsigned c)
+        : left(l), right(r), data(value), height(h), count(c){};
+  };
+
+  /**
+   * @brief Constructs a new ConcurrentAVLTree object.
+   * @param oa Pointer to an ObjectAllocator for memory management. Only the
+   *           writer allocates or frees, so the allocator need not be thread-safe.
+   */
+  ConcurrentAVLTree(ObjectAllocator *oa = 0);
+  /**
+   * @brief Destructor. No reader or writer may be active.
+   */
+  ~ConcurrentAVLTree();
+  /**
+   * @brief Inserts a value. Serialized with other writers.
+   * @param value The value to be inserted.
+   */
+  void insert(const T &value);
+  /**
+   * @brief Removes a value. Serialized with other writers.
+   * @param value The value to be removed.
+   */
+  void remove(const T &value);
+  /**
+   * @brief Removes every value. Serialized with other writers.
+   */
+  void clear();
+  /**
+   * @brief Searches for a value without taking any lock.
+   * @param value The value to be searched for.
+   * @param compares The number of comparisons made during the search.
+   * @return true if the value is found, false otherwise.
+   */
+  bool find(const T &value, unsigned &compares) const;
+  /**
+   * @brief Checks if the tree is empty.
+   * @return true if the tree is empty, false otherwise.
+   */
+  bool empty() const;
+  /**
+   * @brief Returns the number of nodes in the tree.
+   * @return The number of nodes in the tree.
+   */
+  unsigned int size() const;
+  /**
+   * @brief Returns the height of the tree.
+   * @return The height of the tree.
+   */
+  int height() const;
+
+private:
+  typedef const CAVLNode *CAVLTree;
+
+  //! Reader counters are striped so readers on different cores do not share a line
+  static const unsigned READER_STRIPES = 16;
+  //! Retired nodes are reclaimed in batches to amortize the grace period
+  static const unsigned RETIRE_BATCH = 256;
+
+  //! One reader counter, padded to its own cache line
+  struct alignas(64) ReaderCount
+  {
+    std::atomic<unsigned> value; //!< Readers currently inside a read section
+  };
+
+  /*!
+    Scoped read-side critical section. While alive, no node reachable from
+    the root it observed will be freed.
+  */
+  class ReadGuard
+  {
+  public:
+    /**
+     * @brief Enters a read-side critical section.
+     * @param tree The tree being read.
+     */
+    ReadGuard(const ConcurrentAVLTree &tree);
+    /**
+     * @brief Leaves the read-side critical section.
+     */
+    ~ReadGuard();
+
+  private:
+    std::atomic<unsigned> &counter_;
+  };
+
+  std::atomic<CAVLTree> root_;
+  ObjectAllocator *oa_;
+  bool free_oa_;
+  std::mutex writer_lock_;
+  std::vector<CAVLTree> retired_;
+  std::vector<CAVLTree> replaced_; //!< Nodes the current write replaces, retired once it is published
+  std::vector<CAVLTree> created_;  //!< Nodes the current write made, freed if it fails
+  std::atomic<unsigned> epoch_;
+  mutable ReaderCount readers_[2][READER_STRIPES];
+
+  ConcurrentAVLTree(const ConcurrentAVLTree &) = delete;
+  ConcurrentAVLTree &operator=(const ConcurrentAVLTree &) = delete;
+
+  /**
+   * @brief Returns the reader stripe of the calling thread.
+   * @return The stripe index.
+   */
+  static unsigned reader_stripe();
+  /**
+   * @brief Creates a new node.
+   * @param value The value to be stored in the new node.
+   * @param left The left child.
+   * @param right The right child.
+   * @return Pointer to the new node.
+   */
+  CAVLTree make_node(const T &value, CAVLTree left, CAVLTree right);
+  /**
+   * @brief Frees a node immediately.
+   * @param node Pointer to the node to be freed.
+   */
+  void free_node(CAVLTree node);
+  /**
+   * @brief Records a node the current write replaces.
+   * @param node Pointer to the node to be retired once the write is published.
+   */
+  void retire(CAVLTree node);
+  /**
+   * @brief Publishes a new root and retires the nodes the write replaced.
+   * @param old_root The root the write started from.
+   * @param new_root The root the write built.
+   */
+  void commit(CAVLTree old_root, CAVLTree new_root);
+  /**
+   * @brief Frees the nodes of a failed write, leaving the published tree as it was.
+   */
+  void abandon();
+  /**
+   * @brief Waits until no reader can hold a retired node, then frees them.
+   */
+  void reclaim();
+  /**
+   * @brief Retires every node of a tree.
+   * @param tree Pointer to the tree.
+   */
+  void retire_tree(CAVLTree tree);
+  /**
+   * @brief Builds a balanced node from a value and two subtrees.
+   * @param value The value of the new node.
+   * @param left The left subtree.
+   * @param right The right subtree.
+   * @return Pointer to the root of the balanced subtree.
+   */
+  CAVLTree balance(const T &value, CAVLTree left, CAVLTree right);
+  /**
+   * @brief Inserts a value by copying the search path.
+   * @param tree Pointer to the tree.
+   * @param value The value to be inserted.
+   * @return Pointer to the new tree (the same tree if nothing changed).
+   */
+  CAVLTree insert_node(CAVLTree tree, const T &value);
+  /**
+   * @brief Removes a value by copying the search path.
+   * @param tree Pointer to the tree.
+   * @param value The value to be removed.
+   * @return Pointer to the new tree (the same tree if nothing changed).
+   */
+  CAVLTree remove_node(CAVLTree tree, const T &value);
+  /**
+   * @brief Removes the smallest value by copying the leftmost path.
+   * @param tree Pointer to a non-empty tree.
+   * @param min Receives the removed value.
+   * @return Pointer to the new tree.
+   */
+  CAVLTree remove_min(CAVLTree tree, T &min);
+  /**
+   * @brief Returns the height of a tree.
+   * @param tree Pointer to the tree.
+   * @return The height of the tree.
+   */
+  static int tree_height(CAVLTree tree);
+  /**
+   * @brief Returns the number of nodes in a tree.
+   * @param tree Pointer to the tree.
+   * @return The number of nodes in the tree.
+   */
+  static unsigned tree_size(CAVLTree tree);
+};
+
+#include "ConcurrentAVLTree.cpp"
+
+#endif
+//---------------------------------------------------------------------------
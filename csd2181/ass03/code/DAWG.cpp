@@ -0,0 +1,373 @@
+/*!
+@file DAWG.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the definition of the DAWG class.
+*/
+#include "DAWG.h"
+#include <algorithm> // std::max
+/**
+ * @brief Constructs an empty DAWG.
+ */
+DAWG::DAWG()
+    : register_(16, StateHash{&states_}, StateEqual{&states_}), size_(0), height_(-1)
+{
+    clear();
+}
+/**
+ * @brief Inserts a word. Sorted input gives a minimal graph.
+ * @param word The word to be inserted.
+ */
+void DAWG::insert(const std::string &word)
+{
+    unsigned compares = 0;
+    if (find(word, compares))
+    {
+        return;
+    }
+    // the part of the last word not shared with this one is final now
+    std::size_t common = 0;
+    while (common < word.size() && common < last_.size() && word[common] == last_[common])
+    {
+        ++common;
+    }
+    minimize(common);
+
+    // an out-of-order word can run into registered states, which may be
+    // shared, so each one is copied before anything below it changes
+    std::size_t depth = common;
+    while (depth < word.size())
+    {
+        std::uint32_t target = next(path_[depth], word[depth], compares);
+        if (target == NO_STATE)
+        {
+            break;
+        }
+        std::uint32_t copy = make_state();
+        states_[copy].edges = states_[target].edges;
+        states_[copy].final = states_[target].final;
+        set_edge(path_[depth], word[depth], copy);
+        path_.push_back(copy);
+        ++depth;
+    }
+    for (; depth < word.size(); ++depth)
+    {
+        std::uint32_t state = make_state();
+        set_edge(path_[depth], word[depth], state);
+        path_.push_back(state);
+    }
+    states_[path_.back()].final = true;
+    last_ = word;
+    size_++;
+    height_ = std::max(height_, static_cast<int>(word.size()));
+}
+/**
+ * @brief Minimizes the path of the last word and frees the register. Call
+ *        after the last insert; later inserts still work but may leave the
+ *        graph larger than minimal.
+ */
+void DAWG::finish()
+{
+    minimize(0);
+    last_.clear();
+    // clear() keeps the buckets, so swap in an empty register
+    std::unordered_set<std::uint32_t, StateHash, StateEqual>(0, StateHash{&states_}, StateEqual{&states_})
+        .swap(register_);
+}
+/**
+ * @brief Removes every word.
+ */
+void DAWG::clear()
+{
+    register_.clear();
+    states_.clear();
+    free_.clear();
+    last_.clear();
+    path_.clear();
+    path_.push_back(make_state());
+    size_ = 0;
+    height_ = -1;
+}
+/**
+ * @brief Searches for a word.
+ * @param word The word to be searched for.
+ * @param compares The number of transitions followed or tried.
+ * @return true if the word is found, false otherwise.
+ */
+bool DAWG::find(const std::string &word, unsigned &compares) const
+{
+    std::uint32_t state = 0;
+    compares = 0;
+    for (std::size_t i = 0; i < word.size(); ++i)
+    {
+        state = next(state, word[i], compares);
+        if (state == NO_STATE)
+        {
+            return false;
+        }
+    }
+    return states_[state].final;
+}
+/**
+ * @brief Checks if any word starts with a prefix.
+ * @param prefix The prefix.
+ * @return true if some word starts with prefix, false otherwise.
+ */
+bool DAWG::has_prefix(const std::string &prefix) const
+{
+    // every state other than an empty root leads to a word
+    std::uint32_t state = walk(prefix);
+    return state != NO_STATE && size_ > 0;
+}
+/**
+ * @brief Lists the words that start with a prefix, in sorted order.
+ * @param prefix The prefix.
+ * @param limit The largest number of words to return.
+ * @return The words that start with prefix.
+ */
+std::vector<std::string> DAWG::words_with_prefix(const std::string &prefix, unsigned limit) const
+{
+    std::vector<std::string> words;
+    std::uint32_t state = walk(prefix);
+    if (state != NO_STATE)
+    {
+        std::string word(prefix);
+        collect(state, word, words, limit);
+    }
+    return words;
+}
+/**
+ * @brief Checks if the DAWG is empty.
+ * @return true if the DAWG is empty, false otherwise.
+ */
+bool DAWG::empty() const
+{
+    return size_ == 0;
+}
+/**
+ * @brief Returns the number of words.
+ * @return The number of words.
+ */
+unsigned int DAWG::size() const
+{
+    return size_;
+}
+/**
+ * @brief Returns the length of the longest word.
+ * @return The length of the longest word, -1 if empty.
+ */
+int DAWG::height() const
+{
+    return height_;
+}
+/**
+ * @brief Returns the number of states in use.
+ * @return The number of states in use.
+ */
+unsigned int DAWG::states() const
+{
+    return static_cast<unsigned>(states_.size() - free_.size());
+}
+/**
+ * @brief Returns the number of transitions.
+ * @return The number of transitions.
+ */
+unsigned int DAWG::transitions() const
+{
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < states_.size(); ++i)
+    {
+        count += states_[i].edges.size();
+    }
+    return static_cast<unsigned>(count);
+}
+/**
+ * @brief Returns the bytes used by the states and transitions, not
+ *        counting the register, which finish frees.
+ * @return The bytes used by the graph.
+ */
+std::size_t DAWG::memory() const
+{
+    std::size_t bytes = states_.capacity() * sizeof(State);
+    for (std::size_t i = 0; i < states_.size(); ++i)
+    {
+        bytes += states_[i].edges.capacity() * sizeof(Edge);
+    }
+    return bytes;
+}
+/**
+ * @brief Hashes a state.
+ * @param id Index of the state.
+ * @return The hash of its final flag and transitions.
+ */
+std::size_t DAWG::StateHash::operator()(std::uint32_t id) const
+{
+    const State &state = (*states)[id];
+    std::size_t hash = state.final ? 1 : 0;
+    for (std::size_t i = 0; i < state.edges.size(); ++i)
+    {
+        hash = hash * 31 + static_cast<unsigned char>(state.edges[i].label);
+        hash = hash * 1000003 + state.edges[i].target;
+    }
+    return hash;
+}
+/**
+ * @brief Compares two states.
+ * @param lhs Index of the first state.
+ * @param rhs Index of the second state.
+ * @return true if both have the same final flag and transitions.
+ */
+bool DAWG::StateEqual::operator()(std::uint32_t lhs, std::uint32_t rhs) const
+{
+    const State &left = (*states)[lhs];
+    const State &right = (*states)[rhs];
+    if (left.final != right.final || left.edges.size() != right.edges.size())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < left.edges.size(); ++i)
+    {
+        if (left.edges[i].label != right.edges[i].label || left.edges[i].target != right.edges[i].target)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+/**
+ * @brief Creates a state, reusing one that was merged away if possible.
+ * @return Index of the new state.
+ */
+std::uint32_t DAWG::make_state()
+{
+    if (!free_.empty())
+    {
+        std::uint32_t state = free_.back();
+        free_.pop_back();
+        return state;
+    }
+    State state;
+    state.final = false;
+    states_.push_back(state);
+    return static_cast<std::uint32_t>(states_.size() - 1);
+}
+/**
+ * @brief Returns the target of a transition.
+ * @param state Index of the state.
+ * @param label The character.
+ * @param compares Incremented once per label compared.
+ * @return The target, NO_STATE if there is no such transition.
+ */
+std::uint32_t DAWG::next(std::uint32_t state, char label, unsigned &compares) const
+{
+    const std::vector<Edge> &edges = states_[state].edges;
+    for (std::size_t i = 0; i < edges.size(); ++i)
+    {
+        compares++;
+        if (edges[i].label == label)
+        {
+            return edges[i].target;
+        }
+        else if (edges[i].label > label)
+        {
+            break;
+        }
+    }
+    return NO_STATE;
+}
+/**
+ * @brief Adds or redirects a transition.
+ * @param state Index of the state.
+ * @param label The character.
+ * @param target The state reached.
+ */
+void DAWG::set_edge(std::uint32_t state, char label, std::uint32_t target)
+{
+    std::vector<Edge> &edges = states_[state].edges;
+    std::size_t i = 0;
+    while (i < edges.size() && edges[i].label < label)
+    {
+        ++i;
+    }
+    if (i < edges.size() && edges[i].label == label)
+    {
+        edges[i].target = target;
+    }
+    else
+    {
+        Edge edge = {label, target};
+        edges.insert(edges.begin() + static_cast<std::ptrdiff_t>(i), edge);
+    }
+}
+/**
+ * @brief Merges the states of the last word deeper than depth with
+ *        equivalent registered states, or registers them. Works from the
+ *        end of the word up, so children are registered before parents.
+ * @param depth Number of leading states of the path to keep unregistered.
+ */
+void DAWG::minimize(std::size_t depth)
+{
+    for (std::size_t i = path_.size() - 1; i > depth; --i)
+    {
+        std::uint32_t state = path_[i];
+        std::unordered_set<std::uint32_t, StateHash, StateEqual>::iterator match = register_.find(state);
+        if (match != register_.end())
+        {
+            set_edge(path_[i - 1], last_[i - 1], *match);
+            states_[state].edges.clear();
+            states_[state].final = false;
+            free_.push_back(state);
+        }
+        else
+        {
+            // registered states never change again
+            states_[state].edges.shrink_to_fit();
+            register_.insert(state);
+        }
+    }
+    path_.resize(depth + 1);
+}
+/**
+ * @brief Follows a string from the root.
+ * @param text The string.
+ * @return The state reached, NO_STATE if the string leaves the graph.
+ */
+std::uint32_t DAWG::walk(const std::string &text) const
+{
+    unsigned compares = 0;
+    std::uint32_t state = 0;
+    for (std::size_t i = 0; i < text.size() && state != NO_STATE; ++i)
+    {
+        state = next(state, text[i], compares);
+    }
+    return state;
+}
+/**
+ * @brief Collects the words below a state in sorted order.
+ * @param state Index of the state.
+ * @param word The characters leading to state.
+ * @param words Receives the words.
+ * @param limit The largest number of words to collect.
+ */
+void DAWG::collect(std::uint32_t state, std::string &word, std::vector<std::string> &words, unsigned limit) const
+{
+    if (words.size() >= limit)
+    {
+        return;
+    }
+    if (states_[state].final)
+    {
+        words.push_back(word);
+    }
+    const std::vector<Edge> &edges = states_[state].edges;
+    for (std::size_t i = 0; i < edges.size(); ++i)
+    {
+        word.push_back(edges[i].label);
+        collect(edges[i].target, word, words, limit);
+        word.pop_back();
+    }
+}
@@ -0,0 +1,207 @@
+/*!
+@file DAWG.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the declaration of the DAWG class, a minimized word
+       graph that stores a dictionary of strings.
+*/
+//---------------------------------------------------------------------------
+#ifndef DAWG_H
+#define DAWG_H
+//---------------------------------------------------------------------------
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint32_t
+#include <string>        // std::string
+#include <unordered_set> // std::unordered_set
+#include <vector>        // std::vector
+
+/*!
+  A directed acyclic word graph: a trie in which equal suffixes are shared.
+
+  Words are inserted with the algorithm of Daciuk et al.: only the path of
+  the most recent word is kept unminimized, and its states are merged with
+  equivalent registered states once the next word leaves that path. For
+  sorted input this keeps the graph minimal as it is built. A word that
+  arrives out of order is still stored correctly; the shared states on its
+  path are copied before they are changed.
+
+  Looking a word up follows one transition per character, and the graph has
+  the same find/size/height interface as BSTree<std::string>, so it can
+  replace the tree as a dictionary.
+*/
+class DAWG
+{
+public:
+  /**
+   * @brief Constructs an empty DAWG.
+   */
+  DAWG();
+  /**
+   * @brief Inserts a word. Sorted input gives a minimal graph.
+   * @param word The word to be inserted.
+   */
+  void insert(const std::string &word);
+  /**
+   * @brief Minimizes the path of the last word and frees the register. Call
+   *        after the last insert; later inserts still work but may leave
+   *        the graph larger than minimal.
+   */
+  void finish();
+  /**
+   * @brief Removes every word.
+   */
+  void clear();
+  /**
+   * @brief Searches for a word.
+   * @param word The word to be searched for.
+   * @param compares The number of transitions followed or tried.
+   * @return true if the word is found, false otherwise.
+   */
+  bool find(const std::string &word, unsigned &compares) const;
+  /**
+   * @brief Checks if any word starts with a prefix.
+   * @param prefix The prefix.
+   * @return true if some word starts with prefix, false otherwise.
+   */
+  bool has_prefix(const std::string &prefix) const;
+  /**
+   * @brief Lists the words that start with a prefix, in sorted order.
+   * @param prefix The prefix.
+   * @param limit The largest number of words to return.
+   * @return The words that start with prefix.
+   */
+  std::vector<std::string> words_with_prefix(const std::string &prefix, unsigned limit) const;
+  /**
+   * @brief Checks if the DAWG is empty.
+   * @return true if the DAWG is empty, false otherwise.
+   */
+  bool empty() const;
+  /**
+   * @brief Returns the number of words.
+   * @return The number of words.
+   */
+  unsigned int size() const;
+  /**
+   * @brief Returns the length of the longest word.
+   * @return The length of the longest word, -1 if empty.
+   */
+  int height() const;
+  /**
+   * @brief Returns the number of states in use.
+   * @return The number of states in use.
+   */
+  unsigned int states() const;
+  /**
+   * @brief Returns the number of transitions.
+   * @return The number of transitions.
+   */
+  unsigned int transitions() const;
+  /**
+   * @brief Returns the bytes used by the states and transitions, not
+   *        counting the register, which finish frees.
+   * @return The bytes used by the graph.
+   */
+  std::size_t memory() const;
+
+private:
+  //! A labelled transition
+  struct Edge
+  {
+    char label;           //!< The character consumed
+    std::uint32_t target; //!< The state reached
+  };
+
+  //! A state; its transitions are sorted by label
+  struct State
+  {
+    std::vector<Edge> edges; //!< Outgoing transitions
+    bool final;              //!< True if a word ends here
+  };
+
+  //! Hashes a state by its contents
+  struct StateHash
+  {
+    const std::vector<State> *states; //!< The states of the graph
+    /**
+     * @brief Hashes a state.
+     * @param id Index of the state.
+     * @return The hash of its final flag and transitions.
+     */
+    std::size_t operator()(std::uint32_t id) const;
+  };
+
+  //! Compares two states by their contents
+  struct StateEqual
+  {
+    const std::vector<State> *states; //!< The states of the graph
+    /**
+     * @brief Compares two states.
+     * @param lhs Index of the first state.
+     * @param rhs Index of the second state.
+     * @return true if both have the same final flag and transitions.
+     */
+    bool operator()(std::uint32_t lhs, std::uint32_t rhs) const;
+  };
+
+  //! Marks a missing transition
+  static const std::uint32_t NO_STATE = 0xFFFFFFFFu;
+
+  std::vector<State> states_;
+  std::vector<std::uint32_t> free_;
+  std::unordered_set<std::uint32_t, StateHash, StateEqual> register_;
+  std::vector<std::uint32_t> path_; // states of last_, path_[0] is the root
+  std::string last_;
+  unsigned size_;
+  int height_;
+
+  DAWG(const DAWG &) = delete;
+  DAWG &operator=(const DAWG &) = delete;
+
+  /**
+   * @brief Creates a state.
+   * @return Index of the new state.
+   */
+  std::uint32_t make_state();
+  /**
+   * @brief Returns the target of a transition.
+   * @param state Index of the state.
+   * @param label The character.
+   * @param compares Incremented once per label compared.
+   * @return The target, NO_STATE if there is no such transition.
+   */
+  std::uint32_t next(std::uint32_t state, char label, unsigned &compares) const;
+  /**
+   * @brief Adds or redirects a transition.
+   * @param state Index of the state.
+   * @param label The character.
+   * @param target The state reached.
+   */
+  void set_edge(std::uint32_t state, char label, std::uint32_t target);
+  /**
+   * @brief Merges the states of the last word deeper than depth with
+   *        equivalent registered states, or registers them.
+   * @param depth Number of leading states of the path to keep unregistered.
+   */
+  void minimize(std::size_t depth);
+  /**
+   * @brief Follows a string from the root.
+   * @param text The string.
+   * @return The state reached, NO_STATE if the string leaves the graph.
+   */
+  std::uint32_t walk(const std::string &text) const;
+  /**
+   * @brief Collects the words below a state in sorted order.
+   * @param state Index of the state.
+   * @param word The characters leading to state.
+   * @param words Receives the words.
+   * @param limit The largest number of words to collect.
+   */
+  void collect(std::uint32_t state, std::string &word, std::vector<std::string> &words, unsigned limit) const;
+};
+
+#endif
+//---------------------------------------------------------------------------
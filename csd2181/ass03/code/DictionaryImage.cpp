@@ -0,0 +1,316 @@
+/*!
+@file DictionaryImage.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the definition of the DictionaryImage class.
+*/
+#include "DictionaryImage.h"
+#include <cstring> // std::memcmp, std::memcpy
+#include <fstream> // std::ofstream
+#include <limits>  // std::numeric_limits
+#include <vector>  // std::vector
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+#endif
+
+namespace
+{
+    const char IMAGE_MAGIC[8] = "DICTIMG";
+}
+/**
+ * @brief Constructs an empty DictionaryImage with nothing mapped.
+ */
+DictionaryImage::DictionaryImage()
+    : header_(nullptr), sorted_(nullptr), index_(nullptr), pool_(nullptr), map_(nullptr), map_bytes_(0)
+{
+}
+/**
+ * @brief Destructor. Unmaps the image.
+ */
+DictionaryImage::~DictionaryImage()
+{
+    close();
+}
+/**
+ * @brief Writes the keys of a tree to an image file.
+ * @param tree The tree to be written (a BSTree or an AVLTree).
+ * @param filename The path of the image file.
+ * @return true if the image was written, false otherwise.
+ */
+bool DictionaryImage::save(const BSTree<std::string> &tree, const char *filename)
+{
+    std::vector<Entry> sorted;
+    std::string pool;
+    sorted.reserve(tree.size());
+
+    // in-order walk, so the pool and the entries come out sorted
+    std::vector<BSTree<std::string>::BinTree> path;
+    BSTree<std::string>::BinTree node = tree.root();
+    while (node != nullptr || !path.empty())
+    {
+        if (node != nullptr)
+        {
+            path.push_back(node);
+            node = node->left;
+        }
+        else
+        {
+            node = path.back();
+            path.pop_back();
+            if (pool.size() + node->data.size() + 1 > std::numeric_limits<std::uint32_t>::max())
+            {
+                return false;
+            }
+            Entry entry;
+            entry.offset = static_cast<std::uint32_t>(pool.size());
+            entry.length = static_cast<std::uint32_t>(node->data.size());
+            sorted.push_back(entry);
+            pool.append(node->data);
+            pool.push_back('\0');
+            node = node->right;
+        }
+    }
+
+    std::uint32_t count = static_cast<std::uint32_t>(sorted.size());
+    std::vector<Entry> index(sorted.size());
+    build_index(sorted.data(), index.data(), 0, 0, count);
+
+    Header header;
+    std::memcpy(header.magic, IMAGE_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.count = count;
+    header.height = -1;
+    for (std::uint32_t nodes = count; nodes > 0; nodes /= 2)
+    {
+        header.height++;
+    }
+    header.pool_bytes = static_cast<std::uint32_t>(pool.size());
+
+    std::ofstream outfile(filename, std::ios::binary | std::ios::trunc);
+    if (!outfile.is_open())
+    {
+        return false;
+    }
+    outfile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    outfile.write(reinterpret_cast<const char *>(sorted.data()),
+                  static_cast<std::streamsize>(sorted.size() * sizeof(Entry)));
+    outfile.write(reinterpret_cast<const char *>(index.data()),
+                  static_cast<std::streamsize>(index.size() * sizeof(Entry)));
+    outfile.write(pool.data(), static_cast<std::streamsize>(pool.size()));
+    return static_cast<bool>(outfile);
+}
+/**
+ * @brief Maps an image file, replacing any image already mapped.
+ *        Checks only the header against the file size and that the pool
+ *        ends with a NUL, so opening touches two pages; each entry is
+ *        checked against the pool when find or operator[] reads it.
+ * @param filename The path of the image file.
+ * @return true if the file was mapped and is a valid image, false otherwise.
+ */
+bool DictionaryImage::open(const char *filename)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart < static_cast<LONGLONG>(sizeof(Header)))
+    {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        return false;
+    }
+    // the view keeps the mapping alive after its handle is closed
+    void *map = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (map == NULL)
+    {
+        return false;
+    }
+    std::size_t map_bytes = static_cast<std::size_t>(file_size.QuadPart);
+#else
+    int fd = ::open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(Header)))
+    {
+        ::close(fd);
+        return false;
+    }
+    std::size_t map_bytes = static_cast<std::size_t>(file_stat.st_size);
+    // the mapping stays valid after the descriptor is closed
+    void *map = mmap(nullptr, map_bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+#endif
+    map_ = map;
+    map_bytes_ = map_bytes;
+
+    const char *bytes = static_cast<const char *>(map_);
+    const Header *header = reinterpret_cast<const Header *>(bytes);
+    std::size_t entry_bytes = static_cast<std::size_t>(header->count) * sizeof(Entry);
+    if (std::memcmp(header->magic, IMAGE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != VERSION ||
+        map_bytes_ != sizeof(Header) + 2 * entry_bytes + header->pool_bytes)
+    {
+        close();
+        return false;
+    }
+    const char *pool = bytes + sizeof(Header) + 2 * entry_bytes;
+    // a NUL at the end of the pool stops any key operator[] returns inside
+    // the mapping
+    if (header->pool_bytes == 0 ? header->count != 0 : pool[header->pool_bytes - 1] != '\0')
+    {
+        close();
+        return false;
+    }
+    header_ = header;
+    sorted_ = reinterpret_cast<const Entry *>(bytes + sizeof(Header));
+    index_ = reinterpret_cast<const Entry *>(bytes + sizeof(Header) + entry_bytes);
+    pool_ = pool;
+    return true;
+}
+/**
+ * @brief Unmaps the image.
+ */
+void DictionaryImage::close()
+{
+    if (map_ != nullptr)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(map_);
+#else
+        munmap(map_, map_bytes_);
+#endif
+    }
+    header_ = nullptr;
+    sorted_ = nullptr;
+    index_ = nullptr;
+    pool_ = nullptr;
+    map_ = nullptr;
+    map_bytes_ = 0;
+}
+/**
+ * @brief Subscript operator.
+ * @param index The position of the key in sorted order.
+ * @return Pointer to the NUL-terminated key, or null if out of range.
+ */
+const char *DictionaryImage::operator[](int index) const
+{
+    if (index < 0 || static_cast<unsigned>(index) >= size() || !in_pool(sorted_[index]))
+    {
+        return nullptr;
+    }
+    return pool_ + sorted_[index].offset;
+}
+/**
+ * @brief Searches for a value in the mapped image. Walks the implicit tree
+ *        from slot 0; the levels near the root share a few cache lines. An
+ *        entry outside the pool ends the search as a miss.
+ * @param value The value to be searched for.
+ * @param compares The number of comparisons made during the search.
+ * @return true if the value is found, false otherwise.
+ */
+bool DictionaryImage::find(const std::string &value, unsigned &compares) const
+{
+    std::uint32_t count = size();
+    std::uint32_t slot = 0;
+    compares = 0;
+    while (slot < count)
+    {
+        compares++;
+        const Entry &entry = index_[slot];
+        if (!in_pool(entry))
+        {
+            return false;
+        }
+        int result = value.compare(0, std::string::npos, pool_ + entry.offset, entry.length);
+        if (result == 0)
+        {
+            return true;
+        }
+        slot = 2 * slot + (result < 0 ? 1 : 2);
+    }
+    // the empty child, as BSTree counts it
+    compares++;
+    return false;
+}
+/**
+ * @brief Checks if the dictionary is empty.
+ * @return true if the dictionary is empty, false otherwise.
+ */
+bool DictionaryImage::empty() const
+{
+    return size() == 0;
+}
+/**
+ * @brief Returns the number of keys in the dictionary.
+ * @return The number of keys in the dictionary.
+ */
+unsigned int DictionaryImage::size() const
+{
+    return header_ == nullptr ? 0 : header_->count;
+}
+/**
+ * @brief Returns the height of the implicit search tree.
+ * @return The height of the implicit search tree, -1 if empty.
+ */
+int DictionaryImage::height() const
+{
+    return header_ == nullptr ? -1 : header_->height;
+}
+/**
+ * @brief Copies the keys of sorted into index in breadth-first order.
+ * @param sorted The keys in sorted order.
+ * @param index Receives the keys in breadth-first order.
+ * @param next The next sorted key to place.
+ * @param slot The slot of the subtree to fill.
+ * @param count Number of keys.
+ * @return The next sorted key to place after the subtree.
+ */
+std::uint32_t DictionaryImage::build_index(const Entry *sorted, Entry *index, std::uint32_t next,
+                                           std::uint32_t slot, std::uint32_t count)
+{
+    if (slot < count)
+    {
+        // an in-order walk of the implicit tree visits the keys in sorted order
+        next = build_index(sorted, index, next, 2 * slot + 1, count);
+        index[slot] = sorted[next++];
+        next = build_index(sorted, index, next, 2 * slot + 2, count);
+    }
+    return next;
+}
+/**
+ * @brief Checks that an entry's key lies inside the pool.
+ * @param entry The entry.
+ * @return true if the key and the byte after it are inside the pool.
+ */
+bool DictionaryImage::in_pool(const Entry &entry) const
+{
+    return entry.offset < header_->pool_bytes && entry.length < header_->pool_bytes - entry.offset;
+}
@@ -0,0 +1,148 @@
+/*!
+@file DictionaryImage.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the declaration of the DictionaryImage class, a
+       read-only dictionary that is memory-mapped from a binary image and
+       searched in place.
+*/
+//---------------------------------------------------------------------------
+#ifndef DICTIONARYIMAGE_H
+#define DICTIONARYIMAGE_H
+//---------------------------------------------------------------------------
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <string>  // std::string
+
+#include "BSTree.h"
+
+/*!
+  A read-only string dictionary stored as a single binary image.
+
+  The image is written once from a BSTree (or AVLTree) and mapped back into
+  memory with mmap, so opening a dictionary is one page-in instead of parsing
+  a word list and building a tree node by node. Nothing is copied out of the
+  mapping: find and operator[] work directly on the mapped bytes.
+
+  Layout (native byte order):
+    Header   magic, version, key count, height, string pool size
+    Entry    sorted[count]    keys in sorted order, for indexing
+    Entry    index[count]     the same keys in breadth-first order of a
+                              complete binary search tree (the children of
+                              slot k are 2k+1 and 2k+2), for searching
+    char     pool[]           the keys in sorted order, each NUL-terminated
+*/
+class DictionaryImage
+{
+public:
+  /**
+   * @brief Constructs an empty DictionaryImage with nothing mapped.
+   */
+  DictionaryImage();
+  /**
+   * @brief Destructor. Unmaps the image.
+   */
+  ~DictionaryImage();
+  /**
+   * @brief Writes the keys of a tree to an image file.
+   * @param tree The tree to be written (a BSTree or an AVLTree).
+   * @param filename The path of the image file.
+   * @return true if the image was written, false otherwise.
+   */
+  static bool save(const BSTree<std::string> &tree, const char *filename);
+  /**
+   * @brief Maps an image file, replacing any image already mapped.
+   * @param filename The path of the image file.
+   * @return true if the file was mapped and is a valid image, false otherwise.
+   */
+  bool open(const char *filename);
+  /**
+   * @brief Unmaps the image.
+   */
+  void close();
+  /**
+   * @brief Subscript operator.
+   * @param index The position of the key in sorted order.
+   * @return Pointer to the NUL-terminated key, or null if out of range or
+   *         if its entry lies outside the pool.
+   */
+  const char *operator[](int index) const;
+  /**
+   * @brief Searches for a value in the mapped image.
+   * @param value The value to be searched for.
+   * @param compares The number of comparisons made during the search.
+   * @return true if the value is found, false otherwise.
+   */
+  bool find(const std::string &value, unsigned &compares) const;
+  /**
+   * @brief Checks if the dictionary is empty.
+   * @return true if the dictionary is empty, false otherwise.
+   */
+  bool empty() const;
+  /**
+   * @brief Returns the number of keys in the dictionary.
+   * @return The number of keys in the dictionary.
+   */
+  unsigned int size() const;
+  /**
+   * @brief Returns the height of the implicit search tree.
+   * @return The height of the implicit search tree, -1 if empty.
+   */
+  int height() const;
+
+private:
+  //! Image file header
+  struct Header
+  {
+    char magic[8];            //!< "DICTIMG" and a NUL
+    std::uint32_t version;    //!< Format version
+    std::uint32_t count;      //!< Number of keys
+    std::int32_t height;      //!< Height of the implicit search tree
+    std::uint32_t pool_bytes; //!< Size of the string pool
+  };
+
+  //! One key: its position and length in the string pool
+  struct Entry
+  {
+    std::uint32_t offset; //!< Offset of the key in the pool
+    std::uint32_t length; //!< Length of the key, without the NUL
+  };
+
+  //! Current format version
+  static const std::uint32_t VERSION = 1;
+
+  const Header *header_;
+  const Entry *sorted_;
+  const Entry *index_;
+  const char *pool_;
+  void *map_;
+  std::size_t map_bytes_;
+
+  DictionaryImage(const DictionaryImage &) = delete;
+  DictionaryImage &operator=(const DictionaryImage &) = delete;
+
+  /**
+   * @brief Copies the keys of sorted into index in breadth-first order.
+   * @param sorted The keys in sorted order.
+   * @param index Receives the keys in breadth-first order.
+   * @param next The next sorted key to place.
+   * @param slot The slot of the subtree to fill.
+   * @param count Number of keys.
+   * @return The next sorted key to place after the subtree.
+   */
+  static std::uint32_t build_index(const Entry *sorted, Entry *index, std::uint32_t next,
+                                   std::uint32_t slot, std::uint32_t count);
+  /**
+   * @brief Checks that an entry's key lies inside the pool.
+   * @param entry The entry.
+   * @return true if the key and the byte after it are inside the pool.
+   */
+  bool in_pool(const Entry &entry) const;
+};
+
+#endif
+//---------------------------------------------------------------------------
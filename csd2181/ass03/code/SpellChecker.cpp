@@ -0,0 +1,310 @@
+/*!
+@file SpellChecker.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the definition of the SpellChecker class.
+*/
+#include "SpellChecker.h"
+#include <algorithm> // std::sort, std::max
+#include <future>    // std::async, std::future
+#include <thread>    // std::thread
+/**
+ * @brief Constructs a new SpellChecker object.
+ * @param dictionary The dictionary. It must outlive the checker and must not
+ *                   change while a document is checked.
+ * @param threads Number of threads, 0 for one per core.
+ * @param chunk_bytes Number of bytes each thread checks per block.
+ */
+template <typename Dictionary>
+SpellChecker<Dictionary>::SpellChecker(const Dictionary &dictionary, unsigned threads, std::size_t chunk_bytes)
+    : dictionary_(dictionary), threads_(threads), chunk_bytes_(chunk_bytes), words_(0), lookups_(0), line_(1),
+      line_start_(0)
+{
+    if (threads_ == 0)
+    {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (chunk_bytes_ == 0)
+    {
+        chunk_bytes_ = DEFAULT_CHUNK_BYTES;
+    }
+}
+/**
+ * @brief Checks a document read from a stream.
+ * @param input The stream to be checked.
+ * @return The misspellings in document order.
+ */
+template <typename Dictionary>
+std::vector<typename SpellChecker<Dictionary>::Misspelling> SpellChecker<Dictionary>::check(std::istream &input)
+{
+    reset();
+    std::vector<Misspelling> result;
+    std::string buffer;
+    std::size_t block_bytes = chunk_bytes_ * threads_;
+    std::size_t carry = 0;
+    std::size_t base = 0;
+    bool done = false;
+    while (!done)
+    {
+        buffer.resize(carry + block_bytes);
+        input.read(&buffer[carry], static_cast<std::streamsize>(block_bytes));
+        std::size_t size = carry + static_cast<std::size_t>(input.gcount());
+        done = !input;
+        // a word cut by the end of the block is carried into the next block
+        std::size_t end = done ? size : word_boundary(buffer.data(), size);
+        if (end == 0 && !done)
+        {
+            carry = size;
+            continue;
+        }
+        check_block(buffer.data(), end, base, result);
+        base += end;
+        carry = size - end;
+        buffer.erase(0, end);
+    }
+    return result;
+}
+/**
+ * @brief Checks a document held in memory.
+ * @param text The document to be checked.
+ * @return The misspellings in document order.
+ */
+template <typename Dictionary>
+std::vector<typename SpellChecker<Dictionary>::Misspelling> SpellChecker<Dictionary>::check(const std::string &text)
+{
+    reset();
+    std::vector<Misspelling> result;
+    check_block(text.data(), text.size(), 0, result);
+    return result;
+}
+/**
+ * @brief Returns the number of threads used.
+ * @return The number of threads used.
+ */
+template <typename Dictionary>
+unsigned SpellChecker<Dictionary>::threads() const
+{
+    return threads_;
+}
+/**
+ * @brief Returns the number of words in the last document checked.
+ * @return The number of words in the last document checked.
+ */
+template <typename Dictionary>
+std::size_t SpellChecker<Dictionary>::words() const
+{
+    return words_;
+}
+/**
+ * @brief Returns the number of dictionary lookups for the last document
+ *        (one per distinct word per chunk).
+ * @return The number of dictionary lookups for the last document.
+ */
+template <typename Dictionary>
+std::size_t SpellChecker<Dictionary>::lookups() const
+{
+    return lookups_;
+}
+/**
+ * @brief Resets the counters and the position before a document.
+ */
+template <typename Dictionary>
+void SpellChecker<Dictionary>::reset()
+{
+    words_ = 0;
+    lookups_ = 0;
+    line_ = 1;
+    line_start_ = 0;
+}
+/**
+ * @brief Checks a block that does not end inside a word. The block is split
+ *        into one chunk per thread; chunk 0 runs on the calling thread.
+ * @param text The block.
+ * @param size Number of bytes in the block.
+ * @param base Document offset of the block.
+ * @param result Receives the misspellings.
+ */
+template <typename Dictionary>
+void SpellChecker<Dictionary>::check_block(const char *text, std::size_t size, std::size_t base,
+                                           std::vector<Misspelling> &result)
+{
+    // chunk boundaries, moved forward so no word is split
+    std::vector<std::size_t> begin(threads_ + 1, size);
+    begin[0] = 0;
+    for (unsigned i = 1; i < threads_; ++i)
+    {
+        std::size_t cut = std::max(begin[i - 1], size / threads_ * i);
+        while (cut < size && is_letter(text[cut]))
+        {
+            ++cut;
+        }
+        begin[i] = cut;
+    }
+
+    std::vector<std::future<ChunkResult> > tasks;
+    for (unsigned i = 1; i < threads_; ++i)
+    {
+        if (begin[i] < begin[i + 1])
+        {
+            tasks.push_back(std::async(std::launch::async, &SpellChecker::check_chunk, this, text + begin[i],
+                                       begin[i + 1] - begin[i]));
+        }
+    }
+    std::vector<ChunkResult> chunks;
+    chunks.push_back(check_chunk(text, begin[1]));
+    for (std::size_t i = 0; i < tasks.size(); ++i)
+    {
+        chunks.push_back(tasks[i].get());
+    }
+
+    // turn chunk positions into document lines and columns, in order
+    std::size_t chunk_index = 0;
+    for (unsigned i = 0; i < threads_; ++i)
+    {
+        if (i > 0 && begin[i] == begin[i + 1])
+        {
+            continue;
+        }
+        const ChunkResult &chunk = chunks[chunk_index++];
+        std::size_t chunk_base = base + begin[i];
+        for (std::size_t j = 0; j < chunk.misspelled.size(); ++j)
+        {
+            const Token &token = chunk.misspelled[j];
+            Misspelling misspelling;
+            misspelling.word.assign(text + begin[i] + token.offset, token.length);
+            misspelling.offset = chunk_base + token.offset;
+            misspelling.line = line_ + token.newlines;
+            std::size_t line_start = token.newlines > 0 ? chunk_base + token.line_start : line_start_;
+            misspelling.column = misspelling.offset - line_start + 1;
+            result.push_back(misspelling);
+        }
+        words_ += chunk.words;
+        lookups_ += chunk.lookups;
+        if (chunk.newlines > 0)
+        {
+            line_ += chunk.newlines;
+            line_start_ = chunk_base + chunk.line_start;
+        }
+    }
+}
+/**
+ * @brief Tokenizes a chunk and looks its words up as a batch.
+ * @param text The chunk.
+ * @param size Number of bytes in the chunk.
+ * @return The misspelled words and counters of the chunk.
+ */
+template <typename Dictionary>
+typename SpellChecker<Dictionary>::ChunkResult SpellChecker<Dictionary>::check_chunk(const char *text,
+                                                                                     std::size_t size) const
+{
+    ChunkResult chunk;
+    chunk.newlines = 0;
+    chunk.line_start = 0;
+
+    std::vector<Token> tokens;
+    std::size_t i = 0;
+    while (i < size)
+    {
+        if (text[i] == '\n')
+        {
+            chunk.newlines++;
+            chunk.line_start = ++i;
+        }
+        else if (is_letter(text[i]))
+        {
+            Token token;
+            token.offset = i;
+            token.newlines = chunk.newlines;
+            token.line_start = chunk.line_start;
+            while (i < size && is_letter(text[i]))
+            {
+                ++i;
+            }
+            token.length = i - token.offset;
+            tokens.push_back(token);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    chunk.words = tokens.size();
+
+    std::vector<std::string> keys(tokens.size());
+    std::vector<std::size_t> order(tokens.size());
+    for (std::size_t j = 0; j < tokens.size(); ++j)
+    {
+        keys[j].assign(text + tokens[j].offset, tokens[j].length);
+        for (std::size_t k = 0; k < keys[j].size(); ++k)
+        {
+            if (keys[j][k] >= 'a' && keys[j][k] <= 'z')
+            {
+                keys[j][k] = static_cast<char>(keys[j][k] - 'a' + 'A');
+            }
+        }
+        order[j] = j;
+    }
+    // sorted, so every distinct word is looked up once and in key order
+    std::sort(order.begin(), order.end(),
+              [&keys](std::size_t lhs, std::size_t rhs) { return keys[lhs] < keys[rhs]; });
+
+    std::vector<bool> misspelled(tokens.size(), false);
+    chunk.lookups = 0;
+    std::size_t group = 0;
+    while (group < order.size())
+    {
+        std::size_t next = group + 1;
+        while (next < order.size() && keys[order[next]] == keys[order[group]])
+        {
+            ++next;
+        }
+        unsigned compares = 0;
+        chunk.lookups++;
+        if (!dictionary_.find(keys[order[group]], compares))
+        {
+            for (std::size_t j = group; j < next; ++j)
+            {
+                misspelled[order[j]] = true;
+            }
+        }
+        group = next;
+    }
+
+    for (std::size_t j = 0; j < tokens.size(); ++j)
+    {
+        if (misspelled[j])
+        {
+            chunk.misspelled.push_back(tokens[j]);
+        }
+    }
+    return chunk;
+}
+/**
+ * @brief Returns the end of the last complete word before size.
+ * @param text The text.
+ * @param size Number of bytes in the text.
+ * @return Offset just past the last byte that is not a letter, 0 if none.
+ */
+template <typename Dictionary>
+std::size_t SpellChecker<Dictionary>::word_boundary(const char *text, std::size_t size)
+{
+    while (size > 0 && is_letter(text[size - 1]))
+    {
+        --size;
+    }
+    return size;
+}
+/**
+ * @brief Checks if a byte is an ASCII letter.
+ * @param c The byte.
+ * @return true if c is a letter, false otherwise.
+ */
+template <typename Dictionary>
+bool SpellChecker<Dictionary>::is_letter(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
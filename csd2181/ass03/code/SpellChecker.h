@@ -0,0 +1,153 @@
+/*!
+@file SpellChecker.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the declaration of the SpellChecker class, which
+       checks a document against a dictionary on several threads.
+*/
+//---------------------------------------------------------------------------
+#ifndef SPELLCHECKER_H
+#define SPELLCHECKER_H
+//---------------------------------------------------------------------------
+#include <cstddef> // std::size_t
+#include <istream> // std::istream
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+/*!
+  A spell-check engine over a read-only dictionary.
+
+  The document is streamed in blocks. Each block is split at word boundaries
+  into one chunk per thread, and every chunk is tokenized and checked on its
+  own thread. Inside a chunk the words are looked up as a batch: they are
+  sorted so each distinct word is looked up once, and neighbouring lookups
+  walk the same upper part of the tree.
+
+  A word is a run of ASCII letters and is upper-cased before the lookup, the
+  way the dictionaries are loaded. Dictionary may be any type with a
+  thread-safe bool find(const std::string &, unsigned &) const, such as
+  BSTree, AVLTree, BTree or DictionaryImage.
+*/
+template <typename Dictionary>
+class SpellChecker
+{
+public:
+  //! Default number of bytes each thread checks per block
+  static const std::size_t DEFAULT_CHUNK_BYTES = 256 * 1024;
+
+  //! A word that is not in the dictionary
+  struct Misspelling
+  {
+    std::string word;   //!< The word as it appears in the document
+    std::size_t offset; //!< Byte offset of the word in the document
+    std::size_t line;   //!< Line of the word, starting at 1
+    std::size_t column; //!< Column of the word in bytes, starting at 1
+  };
+
+  /**
+   * @brief Constructs a new SpellChecker object.
+   * @param dictionary The dictionary. It must outlive the checker and must not
+   *                   change while a document is checked.
+   * @param threads Number of threads, 0 for one per core.
+   * @param chunk_bytes Number of bytes each thread checks per block.
+   */
+  SpellChecker(const Dictionary &dictionary, unsigned threads = 0, std::size_t chunk_bytes = DEFAULT_CHUNK_BYTES);
+  /**
+   * @brief Checks a document read from a stream.
+   * @param input The stream to be checked.
+   * @return The misspellings in document order.
+   */
+  std::vector<Misspelling> check(std::istream &input);
+  /**
+   * @brief Checks a document held in memory.
+   * @param text The document to be checked.
+   * @return The misspellings in document order.
+   */
+  std::vector<Misspelling> check(const std::string &text);
+  /**
+   * @brief Returns the number of threads used.
+   * @return The number of threads used.
+   */
+  unsigned threads() const;
+  /**
+   * @brief Returns the number of words in the last document checked.
+   * @return The number of words in the last document checked.
+   */
+  std::size_t words() const;
+  /**
+   * @brief Returns the number of dictionary lookups for the last document
+   *        (one per distinct word per chunk).
+   * @return The number of dictionary lookups for the last document.
+   */
+  std::size_t lookups() const;
+
+private:
+  //! A word found by the tokenizer, positioned within its chunk
+  struct Token
+  {
+    std::size_t offset;     //!< Offset of the word in the chunk
+    std::size_t length;     //!< Length of the word
+    std::size_t newlines;   //!< Newlines in the chunk before the word
+    std::size_t line_start; //!< Offset in the chunk of the word's line, if newlines > 0
+  };
+
+  //! The result of checking one chunk
+  struct ChunkResult
+  {
+    std::vector<Token> misspelled; //!< Misspelled words in chunk order
+    std::size_t words;             //!< Words in the chunk
+    std::size_t lookups;           //!< Dictionary lookups made
+    std::size_t newlines;          //!< Newlines in the chunk
+    std::size_t line_start;        //!< Offset in the chunk after the last newline
+  };
+
+  const Dictionary &dictionary_;
+  unsigned threads_;
+  std::size_t chunk_bytes_;
+  std::size_t words_;
+  std::size_t lookups_;
+  std::size_t line_;       // line at the start of the next block
+  std::size_t line_start_; // document offset of that line
+
+  /**
+   * @brief Resets the counters and the position before a document.
+   */
+  void reset();
+  /**
+   * @brief Checks a block that does not end inside a word.
+   * @param text The block.
+   * @param size Number of bytes in the block.
+   * @param base Document offset of the block.
+   * @param result Receives the misspellings.
+   */
+  void check_block(const char *text, std::size_t size, std::size_t base, std::vector<Misspelling> &result);
+  /**
+   * @brief Tokenizes a chunk and looks its words up as a batch.
+   * @param text The chunk.
+   * @param size Number of bytes in the chunk.
+   * @return The misspelled words and counters of the chunk.
+   */
+  ChunkResult check_chunk(const char *text, std::size_t size) const;
+  /**
+   * @brief Returns the end of the last complete word before size.
+   * @param text The text.
+   * @param size Number of bytes in the text.
+   * @return Offset just past the last byte that is not a letter, 0 if none.
+   */
+  static std::size_t word_boundary(const char *text, std::size_t size);
+  /**
+   * @brief Checks if a byte is an ASCII letter.
+   * @param c The byte.
+   * @return true if c is a letter, false otherwise.
+   */
+  static bool is_letter(char c);
+};
+
+#include "SpellChecker.cpp"
+
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,361 @@
+/*!
+@file SuggestionIndex.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the definition of the SuggestionIndex class.
+*/
+#include "SuggestionIndex.h"
+#include <algorithm> // std::push_heap, std::pop_heap, std::sort_heap, std::min
+#include <atomic>    // std::atomic
+#include <thread>    // std::thread
+
+namespace
+{
+    //! Orders suggestions nearest first, then alphabetically
+    bool SuggestionLess(const SuggestionIndex::Suggestion &lhs, const SuggestionIndex::Suggestion &rhs)
+    {
+        return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.word < rhs.word);
+    }
+
+    //! Queries each thread takes at a time in a batch
+    const std::size_t BATCH_GRAIN = 16;
+}
+/**
+ * @brief Builds the index from the words of a tree.
+ * @param tree The dictionary (a BSTree or an AVLTree).
+ */
+SuggestionIndex::SuggestionIndex(const BSTree<std::string> &tree)
+{
+    std::vector<std::string> words;
+    words.reserve(tree.size());
+    std::vector<BSTree<std::string>::BinTree> path;
+    BSTree<std::string>::BinTree node = tree.root();
+    while (node != nullptr || !path.empty())
+    {
+        if (node != nullptr)
+        {
+            path.push_back(node);
+            node = node->left;
+        }
+        else
+        {
+            node = path.back();
+            path.pop_back();
+            words.push_back(node->data);
+            node = node->right;
+        }
+    }
+    std::vector<BuildNode> built;
+    built.reserve(words.size());
+    for (std::uint32_t word = 0; word < words.size(); ++word)
+    {
+        insert(words, built, word);
+    }
+    flatten(words, built);
+}
+/**
+ * @brief Finds the nearest words to a query. The query is upper-cased the
+ *        way the dictionaries are loaded.
+ * @param word The query.
+ * @param max_distance The largest edit distance to accept.
+ * @param k The largest number of suggestions to return.
+ * @param distances The number of edit distances computed.
+ * @return Up to k words within max_distance, nearest first, ties in
+ *         alphabetical order.
+ */
+std::vector<SuggestionIndex::Suggestion> SuggestionIndex::suggest(const std::string &word, unsigned max_distance,
+                                                                  unsigned k, unsigned &distances) const
+{
+    std::vector<Suggestion> best;
+    distances = 0;
+    if (nodes_.empty() || k == 0)
+    {
+        return best;
+    }
+    std::string query(word);
+    for (std::size_t i = 0; i < query.size(); ++i)
+    {
+        if (query[i] >= 'a' && query[i] <= 'z')
+        {
+            query[i] = static_cast<char>(query[i] - 'a' + 'A');
+        }
+    }
+    Pattern pattern;
+    make_pattern(query, pattern);
+
+    // best is a max-heap of the k nearest so far; once it is full only words
+    // at most as far as its worst entry can still get in
+    unsigned limit = max_distance;
+    std::vector<std::uint32_t> pending(1, 0);
+    while (!pending.empty())
+    {
+        const BKNode &node = nodes_[pending.back()];
+        pending.pop_back();
+        const char *text = pool_.data() + node.offset;
+        unsigned d = distance(pattern, text, node.length);
+        distances++;
+        if (d <= limit)
+        {
+            Suggestion candidate = {std::string(text, node.length), d};
+            if (best.size() < k)
+            {
+                best.push_back(candidate);
+                std::push_heap(best.begin(), best.end(), SuggestionLess);
+            }
+            else if (SuggestionLess(candidate, best.front()))
+            {
+                std::pop_heap(best.begin(), best.end(), SuggestionLess);
+                best.back() = candidate;
+                std::push_heap(best.begin(), best.end(), SuggestionLess);
+            }
+            if (best.size() == k)
+            {
+                limit = std::min(limit, best.front().distance);
+            }
+        }
+        // triangle inequality: only children filed within limit of d can match
+        std::uint32_t last = node.first_child + node.children;
+        for (std::uint32_t child = node.first_child; child < last && nodes_[child].distance <= d + limit; ++child)
+        {
+            if (nodes_[child].distance + limit >= d)
+            {
+                pending.push_back(child);
+            }
+        }
+    }
+    std::sort_heap(best.begin(), best.end(), SuggestionLess);
+    return best;
+}
+/**
+ * @brief Finds the nearest words to many queries on several threads. Threads
+ *        take the queries a few at a time, so slow queries do not leave the
+ *        other threads idle.
+ * @param words The queries.
+ * @param max_distance The largest edit distance to accept.
+ * @param k The largest number of suggestions per query.
+ * @param threads Number of threads, 0 for one per core.
+ * @return The suggestions of each query, in query order.
+ */
+std::vector<std::vector<SuggestionIndex::Suggestion> > SuggestionIndex::suggest(const std::vector<std::string> &words,
+                                                                                unsigned max_distance, unsigned k,
+                                                                                unsigned threads) const
+{
+    std::vector<std::vector<Suggestion> > result(words.size());
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        unsigned distances = 0;
+        std::size_t first;
+        while ((first = next.fetch_add(BATCH_GRAIN)) < words.size())
+        {
+            std::size_t last = std::min(first + BATCH_GRAIN, words.size());
+            for (std::size_t i = first; i < last; ++i)
+            {
+                result[i] = suggest(words[i], max_distance, k, distances);
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned i = 1; i < threads; ++i)
+    {
+        pool.push_back(std::thread(worker));
+    }
+    worker();
+    for (std::size_t i = 0; i < pool.size(); ++i)
+    {
+        pool[i].join();
+    }
+    return result;
+}
+/**
+ * @brief Returns the number of words in the index.
+ * @return The number of words in the index.
+ */
+unsigned int SuggestionIndex::size() const
+{
+    return static_cast<unsigned>(nodes_.size());
+}
+/**
+ * @brief Returns the Levenshtein distance between two strings.
+ * @param lhs The first string.
+ * @param rhs The second string.
+ * @return The number of insertions, deletions and substitutions that turn
+ *         lhs into rhs.
+ */
+unsigned SuggestionIndex::edit_distance(const std::string &lhs, const std::string &rhs)
+{
+    Pattern pattern;
+    make_pattern(lhs, pattern);
+    return distance(pattern, rhs.data(), rhs.size());
+}
+/**
+ * @brief Adds a word under the root of a tree being built.
+ * @param words The words; node i holds words[i].
+ * @param tree The tree being built.
+ * @param word Index of the word to be added.
+ */
+void SuggestionIndex::insert(const std::vector<std::string> &words, std::vector<BuildNode> &tree, std::uint32_t word)
+{
+    BuildNode added = {0, NO_NODE, NO_NODE};
+    tree.push_back(added);
+    if (word == 0)
+    {
+        return;
+    }
+    Pattern pattern;
+    make_pattern(words[word], pattern);
+    std::uint32_t node = 0;
+    while (true)
+    {
+        std::uint32_t d = distance(pattern, words[node].data(), words[node].size());
+        std::uint32_t child = tree[node].first_child;
+        while (child != NO_NODE && tree[child].distance != d)
+        {
+            child = tree[child].next_sibling;
+        }
+        if (child == NO_NODE)
+        {
+            tree[word].distance = d;
+            tree[word].next_sibling = tree[node].first_child;
+            tree[node].first_child = word;
+            return;
+        }
+        node = child;
+    }
+}
+/**
+ * @brief Lays a built tree out breadth-first into nodes_ and pool_. A query
+ *        then scans the children of a node as one contiguous run, and their
+ *        words sit next to each other in the pool.
+ * @param words The words; node i holds words[i].
+ * @param tree The built tree.
+ */
+void SuggestionIndex::flatten(const std::vector<std::string> &words, const std::vector<BuildNode> &tree)
+{
+    nodes_.clear();
+    pool_.clear();
+    if (tree.empty())
+    {
+        return;
+    }
+    // order[i] is the built node placed at nodes_[i]
+    std::vector<std::uint32_t> order(1, 0);
+    order.reserve(tree.size());
+    nodes_.reserve(tree.size());
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        const std::string &word = words[order[i]];
+        BKNode node = {static_cast<std::uint32_t>(pool_.size()), static_cast<std::uint32_t>(word.size()),
+                       tree[order[i]].distance, static_cast<std::uint32_t>(order.size()), 0};
+        pool_.append(word);
+        for (std::uint32_t child = tree[order[i]].first_child; child != NO_NODE; child = tree[child].next_sibling)
+        {
+            order.push_back(child);
+            node.children++;
+        }
+        std::sort(order.begin() + node.first_child, order.end(),
+                  [&tree](std::uint32_t lhs, std::uint32_t rhs) { return tree[lhs].distance < tree[rhs].distance; });
+        nodes_.push_back(node);
+    }
+}
+/**
+ * @brief Prepares a query for Myers' algorithm.
+ * @param text The query.
+ * @param pattern Receives the prepared query.
+ */
+void SuggestionIndex::make_pattern(const std::string &text, Pattern &pattern)
+{
+    pattern.text = text;
+    std::fill(pattern.peq, pattern.peq + 256, 0);
+    if (text.size() <= WORD_BITS)
+    {
+        for (std::size_t i = 0; i < text.size(); ++i)
+        {
+            pattern.peq[static_cast<unsigned char>(text[i])] |= std::uint64_t(1) << i;
+        }
+    }
+}
+/**
+ * @brief Returns the edit distance between a prepared query and a string.
+ *
+ * Myers' algorithm keeps one column of the dynamic programming matrix as bit
+ * vectors of the +1/-1 steps between neighbouring cells, so each character
+ * of text updates the whole column with a handful of word operations.
+ *
+ * @param pattern The prepared query.
+ * @param text The string.
+ * @param length Length of the string.
+ * @return The Levenshtein distance.
+ */
+unsigned SuggestionIndex::distance(const Pattern &pattern, const char *text, std::size_t length)
+{
+    std::size_t pattern_length = pattern.text.size();
+    if (pattern_length > WORD_BITS)
+    {
+        return distance_dp(pattern.text, std::string(text, length));
+    }
+    if (pattern_length == 0)
+    {
+        return static_cast<unsigned>(length);
+    }
+    std::uint64_t positive = ~std::uint64_t(0); // vertical +1 steps
+    std::uint64_t negative = 0;                 // vertical -1 steps
+    std::uint64_t last = std::uint64_t(1) << (pattern_length - 1);
+    unsigned score = static_cast<unsigned>(pattern_length);
+    for (std::size_t j = 0; j < length; ++j)
+    {
+        std::uint64_t equal = pattern.peq[static_cast<unsigned char>(text[j])];
+        std::uint64_t vertical = equal | negative;
+        std::uint64_t horizontal = (((equal & positive) + positive) ^ positive) | equal;
+        std::uint64_t horizontal_positive = negative | ~(horizontal | positive);
+        std::uint64_t horizontal_negative = positive & horizontal;
+        if (horizontal_positive & last)
+        {
+            ++score;
+        }
+        else if (horizontal_negative & last)
+        {
+            --score;
+        }
+        // the top row of the matrix counts up, so a +1 step enters at row 0
+        horizontal_positive = (horizontal_positive << 1) | 1;
+        horizontal_negative <<= 1;
+        positive = horizontal_negative | ~(vertical | horizontal_positive);
+        negative = horizontal_positive & vertical;
+    }
+    return score;
+}
+/**
+ * @brief Returns the edit distance with the two-row dynamic program, for
+ *        queries longer than WORD_BITS.
+ * @param lhs The first string.
+ * @param rhs The second string.
+ * @return The Levenshtein distance.
+ */
+unsigned SuggestionIndex::distance_dp(const std::string &lhs, const std::string &rhs)
+{
+    std::vector<unsigned> previous(rhs.size() + 1);
+    std::vector<unsigned> current(rhs.size() + 1);
+    for (std::size_t j = 0; j <= rhs.size(); ++j)
+    {
+        previous[j] = static_cast<unsigned>(j);
+    }
+    for (std::size_t i = 1; i <= lhs.size(); ++i)
+    {
+        current[0] = static_cast<unsigned>(i);
+        for (std::size_t j = 1; j <= rhs.size(); ++j)
+        {
+            unsigned substitute = previous[j - 1] + (lhs[i - 1] == rhs[j - 1] ? 0 : 1);
+            current[j] = std::min(std::min(previous[j], current[j - 1]) + 1, substitute);
+        }
+        previous.swap(current);
+    }
+    return previous[rhs.size()];
+}
@@ -0,0 +1,157 @@
+/*!
+@file SuggestionIndex.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignent 3
+@date 10/19/2026
+@brief This file contains the declaration of the SuggestionIndex class, which
+       finds the dictionary words nearest to a misspelled word.
+*/
+//---------------------------------------------------------------------------
+#ifndef SUGGESTIONINDEX_H
+#define SUGGESTIONINDEX_H
+//---------------------------------------------------------------------------
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#include "BSTree.h"
+
+/*!
+  A BK-tree over the words of a dictionary.
+
+  Every child of a node is filed under its edit distance to that node, so by
+  the triangle inequality a search for words within distance d of a query
+  only needs the children whose distance is within d of the node's own
+  distance to the query. Distances are computed with Myers' bit-parallel
+  algorithm, one machine word operation per character of the dictionary word
+  for queries of up to 64 characters.
+*/
+class SuggestionIndex
+{
+public:
+  //! A dictionary word near the query
+  struct Suggestion
+  {
+    std::string word;  //!< The dictionary word
+    unsigned distance; //!< Its edit distance to the query
+  };
+
+  /**
+   * @brief Builds the index from the words of a tree.
+   * @param tree The dictionary (a BSTree or an AVLTree).
+   */
+  SuggestionIndex(const BSTree<std::string> &tree);
+  /**
+   * @brief Finds the nearest words to a query. The query is upper-cased the
+   *        way the dictionaries are loaded.
+   * @param word The query.
+   * @param max_distance The largest edit distance to accept.
+   * @param k The largest number of suggestions to return.
+   * @param distances The number of edit distances computed.
+   * @return Up to k words within max_distance, nearest first, ties in
+   *         alphabetical order.
+   */
+  std::vector<Suggestion> suggest(const std::string &word, unsigned max_distance, unsigned k,
+                                  unsigned &distances) const;
+  /**
+   * @brief Finds the nearest words to many queries on several threads.
+   * @param words The queries.
+   * @param max_distance The largest edit distance to accept.
+   * @param k The largest number of suggestions per query.
+   * @param threads Number of threads, 0 for one per core.
+   * @return The suggestions of each query, in query order.
+   */
+  std::vector<std::vector<Suggestion> > suggest(const std::vector<std::string> &words, unsigned max_distance,
+                                                unsigned k, unsigned threads = 0) const;
+  /**
+   * @brief Returns the number of words in the index.
+   * @return The number of words in the index.
+   */
+  unsigned int size() const;
+  /**
+   * @brief Returns the Levenshtein distance between two strings.
+   * @param lhs The first string.
+   * @param rhs The second string.
+   * @return The number of insertions, deletions and substitutions that turn
+   *         lhs into rhs.
+   */
+  static unsigned edit_distance(const std::string &lhs, const std::string &rhs);
+
+private:
+  //! A node of the BK-tree. Nodes are stored breadth-first, so the children
+  //! of a node are contiguous and sorted by their distance to it
+  struct BKNode
+  {
+    std::uint32_t offset;      //!< Offset of the word in pool_
+    std::uint32_t length;      //!< Length of the word
+    std::uint32_t distance;    //!< Edit distance to the parent
+    std::uint32_t first_child; //!< Index of the first child
+    std::uint32_t children;    //!< Number of children
+  };
+
+  //! A node while the tree is being built
+  struct BuildNode
+  {
+    std::uint32_t distance;     //!< Edit distance to the parent
+    std::uint32_t first_child;  //!< First child, NO_NODE if none
+    std::uint32_t next_sibling; //!< Next child of the parent, NO_NODE if none
+  };
+
+  //! A query prepared for Myers' algorithm
+  struct Pattern
+  {
+    std::string text;       //!< The query
+    std::uint64_t peq[256]; //!< Bit i of peq[c] is set if text[i] == c
+  };
+
+  //! Marks a missing child or sibling
+  static const std::uint32_t NO_NODE = 0xFFFFFFFFu;
+  //! Longest query handled by the bit-parallel kernel
+  static const unsigned WORD_BITS = 64;
+
+  std::string pool_;
+  std::vector<BKNode> nodes_;
+
+  /**
+   * @brief Adds a word under the root of a tree being built.
+   * @param words The words; node i holds words[i].
+   * @param tree The tree being built.
+   * @param word Index of the word to be added.
+   */
+  static void insert(const std::vector<std::string> &words, std::vector<BuildNode> &tree, std::uint32_t word);
+  /**
+   * @brief Lays a built tree out breadth-first into nodes_ and pool_.
+   * @param words The words; node i holds words[i].
+   * @param tree The built tree.
+   */
+  void flatten(const std::vector<std::string> &words, const std::vector<BuildNode> &tree);
+  /**
+   * @brief Prepares a query for Myers' algorithm.
+   * @param text The query.
+   * @param pattern Receives the prepared query.
+   */
+  static void make_pattern(const std::string &text, Pattern &pattern);
+  /**
+   * @brief Returns the edit distance between a prepared query and a string.
+   * @param pattern The prepared query.
+   * @param text The string.
+   * @param length Length of the string.
+   * @return The Levenshtein distance.
+   */
+  static unsigned distance(const Pattern &pattern, const char *text, std::size_t length);
+  /**
+   * @brief Returns the edit distance with the two-row dynamic program, for
+   *        queries longer than WORD_BITS.
+   * @param lhs The first string.
+   * @param rhs The second string.
+   * @return The Levenshtein distance.
+   */
+  static unsigned distance_dp(const std::string &lhs, const std::string &rhs);
+};
+
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,1067 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <algorithm>
+
+#include "BSTree.h"
+#include "AVLTree.h"
+#include "ConcurrentAVLTree.h"
+#include "BTree.h"
+#include "DAWG.h"
+#include "DictionaryImage.h"
+#include "SpellChecker.h"
+#include "SuggestionIndex.h"
+#include "PRNG.h"
+#include "ObjectAllocator.h"
+
+const char *gFile = "wordsy.txt";
+unsigned gMaxThreads = 0; // 0 means std::thread::hardware_concurrency()
+
+using std::cout;
+using std::endl;
+
+//*********************************************************************
+// Helpers
+//*********************************************************************
+typedef std::chrono::steady_clock Clock;
+
+double ElapsedMs(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int RandomInt(int low, int high)
+{
+  return Digipen::Utils::Random(low, high);
+}
+
+template <typename T>
+void Shuffle(std::vector<T> &array)
+{
+  int count = static_cast<int>(array.size());
+  for (int i = 0; i < count; i++)
+  {
+    int r = RandomInt(0, count - 1);
+    std::swap(array[static_cast<size_t>(i)], array[static_cast<size_t>(r)]);
+  }
+}
+
+char *mystrupr(char *string)
+{
+  char *p = string;
+  while (*p)
+  {
+    if (*p >= 'a' && *p <= 'z')
+      *p -= 32;
+    p++;
+  }
+
+  return string;
+}
+
+bool LoadWords(std::vector<std::string> &words, const char *filename)
+{
+  std::ifstream infile(filename);
+  if (!infile.is_open())
+  {
+    std::cout << "Can't open file: " << filename << std::endl;
+    return false;
+  }
+
+  std::string word;
+  while (std::getline(infile, word))
+  {
+    mystrupr(const_cast<char *>(word.c_str()));
+    words.push_back(word);
+  }
+  return true;
+}
+
+// Thread counts 1, 2, 4, ... up to the number of cores (at least 4 so
+// oversubscription is visible on small machines).
+std::vector<unsigned> ThreadCounts(void)
+{
+  unsigned max_threads = gMaxThreads;
+  if (max_threads == 0)
+    max_threads = std::max(4u, std::thread::hardware_concurrency());
+
+  std::vector<unsigned> counts;
+  for (unsigned t = 1; t <= max_threads; t *= 2)
+    counts.push_back(t);
+  return counts;
+}
+
+//*********************************************************************
+// End Helpers
+//*********************************************************************
+
+// Runs num_readers threads doing lookups while one writer keeps inserting.
+// Returns lookups per second.
+template <typename Find, typename Insert>
+double ReadMostly(unsigned num_readers, const std::vector<std::string> &queries, Find find, Insert insert)
+{
+  const size_t lookups_per_reader = 200000;
+  std::atomic<bool> go(false);
+  std::atomic<bool> stop(false);
+  std::atomic<unsigned> found_total(0);
+
+  std::thread writer([&]() {
+    while (!go.load())
+      std::this_thread::yield();
+    unsigned n = 0;
+    while (!stop.load())
+    {
+      insert("ZZNEWWORD" + std::to_string(n++));
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  });
+
+  std::vector<std::thread> readers;
+  for (unsigned r = 0; r < num_readers; r++)
+  {
+    readers.push_back(std::thread([&, r]() {
+      while (!go.load())
+        std::this_thread::yield();
+      unsigned found = 0;
+      size_t index = r * 7919u;
+      for (size_t i = 0; i < lookups_per_reader; i++)
+      {
+        unsigned compares;
+        if (find(queries[index % queries.size()], compares))
+          found++;
+        index++;
+      }
+      found_total.fetch_add(found);
+    }));
+  }
+
+  Clock::time_point start = Clock::now();
+  go.store(true);
+  for (size_t r = 0; r < readers.size(); r++)
+    readers[r].join();
+  double ms = ElapsedMs(start);
+  stop.store(true);
+  writer.join();
+
+  return (static_cast<double>(lookups_per_reader) * num_readers) / (ms / 1000.0);
+}
+
+void TestConcurrentReads(void)
+{
+  const char *test = "TestConcurrentReads";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    std::vector<std::string> words;
+    if (!LoadWords(words, gFile))
+      return;
+
+    Digipen::Utils::srand(1, 2);
+    Shuffle(words);
+
+    // Half of the queries miss
+    std::vector<std::string> queries(words);
+    for (size_t i = 0; i < words.size(); i++)
+      queries.push_back(words[i] + "Q");
+    Shuffle(queries);
+
+    AVLTree<std::string> locked_tree;
+    std::shared_timed_mutex tree_lock;
+    ConcurrentAVLTree<std::string> concurrent_tree;
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < words.size(); i++)
+      locked_tree.insert(words[i]);
+    std::cout << "AVLTree load:           " << ElapsedMs(start) << " ms" << endl;
+
+    start = Clock::now();
+    for (size_t i = 0; i < words.size(); i++)
+      concurrent_tree.insert(words[i]);
+    std::cout << "ConcurrentAVLTree load: " << ElapsedMs(start) << " ms" << endl;
+    std::cout << "words: " << concurrent_tree.size() << ", height: " << concurrent_tree.height() << endl;
+
+    std::cout << std::setw(8) << "threads" << std::setw(22) << "rwlock AVLTree (op/s)"
+              << std::setw(26) << "ConcurrentAVLTree (op/s)" << std::setw(10) << "speedup" << endl;
+
+    std::vector<unsigned> counts = ThreadCounts();
+    for (size_t c = 0; c < counts.size(); c++)
+    {
+      double locked = ReadMostly(counts[c], queries,
+        [&](const std::string &word, unsigned &compares) {
+          std::shared_lock<std::shared_timed_mutex> lock(tree_lock);
+          return locked_tree.find(word, compares);
+        },
+        [&](const std::string &word) {
+          std::unique_lock<std::shared_timed_mutex> lock(tree_lock);
+          locked_tree.insert(word);
+        });
+
+      double lockfree = ReadMostly(counts[c], queries,
+        [&](const std::string &word, unsigned &compares) {
+          return concurrent_tree.find(word, compares);
+        },
+        [&](const std::string &word) {
+          concurrent_tree.insert(word);
+        });
+
+      std::cout << std::setw(8) << counts[c] << std::setw(22) << std::fixed << std::setprecision(0) << locked
+                << std::setw(26) << lockfree << std::setw(10) << std::setprecision(2) << lockfree / locked << endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
+template <typename T>
+void PrintSetResult(const char *label, const AVLTree<T> &tree, double ms)
+{
+  std::cout << std::setw(24) << std::left << label << std::right << std::setw(10) << std::fixed
+            << std::setprecision(2) << ms << " ms, nodes: " << tree.size() << ", height: " << tree.height() << endl;
+  std::cout.unsetf(std::ios::fixed);
+}
+
+void TestSetOperations(void)
+{
+  const char *test = "TestSetOperations";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    std::vector<std::string> words;
+    if (!LoadWords(words, gFile))
+      return;
+
+    Digipen::Utils::srand(1, 2);
+    Shuffle(words);
+
+      // Two overlapping shards: each gets half of the words, plus a shared fifth
+    AVLTree<std::string> shard1, shard2;
+    for (size_t i = 0; i < words.size(); i++)
+    {
+      if (i % 2 == 0 || i % 5 == 0)
+        shard1.insert(words[i]);
+      if (i % 2 == 1 || i % 5 == 0)
+        shard2.insert(words[i]);
+    }
+    std::cout << "shard1 nodes: " << shard1.size() << ", shard2 nodes: " << shard2.size() << endl;
+
+    Clock::time_point start = Clock::now();
+    AVLTree<std::string> merged(shard1);
+    for (unsigned i = 0; i < shard2.size(); i++)
+    {
+      unsigned compares;
+      const std::string &word = shard2[static_cast<int>(i)]->data;
+      if (!merged.find(word, compares))
+        merged.insert(word);
+    }
+    PrintSetResult("insert loop union:", merged, ElapsedMs(start));
+
+    start = Clock::now();
+    AVLTree<std::string> united(shard1);
+    united.set_union(shard2);
+    PrintSetResult("set_union:", united, ElapsedMs(start));
+
+    start = Clock::now();
+    AVLTree<std::string> common(shard1);
+    common.set_intersection(shard2);
+    PrintSetResult("set_intersection:", common, ElapsedMs(start));
+
+    start = Clock::now();
+    AVLTree<std::string> only1(shard1);
+    only1.set_difference(shard2);
+    PrintSetResult("set_difference:", only1, ElapsedMs(start));
+
+    start = Clock::now();
+    AVLTree<std::string> low, high;
+    AVLTree<std::string> whole(united);
+    whole.split("M", low, high);
+    whole.join(low, "M", high);
+    PrintSetResult("split + join at \"M\":", whole, ElapsedMs(start));
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
+template <typename T>
+const T &IndexValue(const typename BSTree<T>::BinTreeNode *node)
+{
+  return node->data;
+}
+
+template <typename T>
+const T &IndexValue(const T *key)
+{
+  return *key;
+}
+
+size_t KeyWeight(int key)
+{
+  return static_cast<size_t>(key);
+}
+
+size_t KeyWeight(const std::string &key)
+{
+  return key.size();
+}
+
+template <typename T>
+size_t NodeBytes(const BSTree<T> &tree)
+{
+  return tree.size() * sizeof(typename BSTree<T>::BinTreeNode);
+}
+
+template <typename T>
+size_t CountBTreeNodes(const typename BTree<T>::BTreeNode *node)
+{
+  size_t nodes = 1;
+  if (!node->leaf)
+    for (unsigned i = 0; i <= node->size; i++)
+      nodes += CountBTreeNodes<T>(node->children[i]);
+  return nodes;
+}
+
+template <typename T>
+size_t NodeBytes(const BTree<T> &tree)
+{
+  return tree.empty() ? 0 : CountBTreeNodes<T>(tree.root()) * sizeof(typename BTree<T>::BTreeNode);
+}
+
+// Times one workload (insert, hits, misses, indexing, remove half) on a tree type
+template <typename Tree, typename T>
+void OrderedSetWorkload(const char *label, const std::vector<T> &keys, const std::vector<T> &misses)
+{
+  Tree tree;
+  unsigned compares;
+  unsigned long total_compares = 0;
+  unsigned found = 0;
+
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    tree.insert(keys[i]);
+  double insert_ms = ElapsedMs(start);
+  size_t bytes = NodeBytes(tree);
+  int height = tree.height();
+
+  start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    found += tree.find(keys[i], compares);
+    total_compares += compares;
+  }
+  double hit_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  for (size_t i = 0; i < misses.size(); i++)
+    found += tree.find(misses[i], compares);
+  double miss_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  size_t checksum = 0;
+  for (unsigned i = 0; i < tree.size(); i += 7)
+    checksum += KeyWeight(IndexValue<T>(tree[static_cast<int>(i)]));
+  double index_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i += 2)
+    tree.remove(keys[i]);
+  double remove_ms = ElapsedMs(start);
+
+  std::cout << std::setw(10) << std::left << label << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << insert_ms << std::setw(10) << hit_ms << std::setw(10) << miss_ms
+            << std::setw(10) << index_ms << std::setw(10) << remove_ms << std::setw(8) << height
+            << std::setw(10) << static_cast<double>(total_compares) / static_cast<double>(keys.size())
+            << std::setw(10) << static_cast<double>(bytes) / static_cast<double>(keys.size())
+            << (found + checksum == 0 ? " (empty)" : "") << endl;
+  std::cout.unsetf(std::ios::fixed);
+}
+
+void PrintWorkloadHeader(void)
+{
+  std::cout << std::setw(10) << std::left << "tree" << std::right << std::setw(10) << "insert" << std::setw(10) << "hits"
+            << std::setw(10) << "misses" << std::setw(10) << "index" << std::setw(10) << "remove"
+            << std::setw(8) << "height" << std::setw(10) << "cmp/find" << std::setw(10) << "B/key" << endl;
+}
+
+void TestOrderedSets(void)
+{
+  const char *test = "TestOrderedSets";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    Digipen::Utils::srand(1, 2);
+
+    const int count = 1000000;
+    std::vector<int> ints, int_misses;
+    for (int i = 0; i < count; i++)
+    {
+      ints.push_back(2 * i);
+      int_misses.push_back(2 * i + 1);
+    }
+    Shuffle(ints);
+    Shuffle(int_misses);
+
+    std::cout << count << " random ints (times in ms)" << endl;
+    PrintWorkloadHeader();
+    OrderedSetWorkload<BSTree<int> >("BSTree", ints, int_misses);
+    OrderedSetWorkload<AVLTree<int> >("AVLTree", ints, int_misses);
+    OrderedSetWorkload<BTree<int> >("BTree", ints, int_misses);
+
+    std::vector<std::string> words;
+    if (!LoadWords(words, gFile))
+      return;
+    Shuffle(words);
+    std::vector<std::string> word_misses;
+    for (size_t i = 0; i < words.size(); i++)
+      word_misses.push_back(words[i] + "Q");
+
+    std::cout << endl << words.size() << " words from " << gFile << " (times in ms)" << endl;
+    PrintWorkloadHeader();
+    OrderedSetWorkload<BSTree<std::string> >("BSTree", words, word_misses);
+    OrderedSetWorkload<AVLTree<std::string> >("AVLTree", words, word_misses);
+    OrderedSetWorkload<BTree<std::string> >("BTree", words, word_misses);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
+
+void TestDictionaryImage(void)
+{
+  const char *test = "TestDictionaryImage";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    // startup the way the spell checker does it: parse the list, build the tree
+    Clock::time_point start = Clock::now();
+    AVLTree<std::string> tree;
+    std::vector<std::string> words;
+    if (!LoadWords(words, gFile))
+      return;
+    for (size_t i = 0; i < words.size(); i++)
+      tree.insert(words[i]);
+    double parse_ms = ElapsedMs(start);
+
+    std::string image_file = std::string(gFile) + ".img";
+    start = Clock::now();
+    if (!DictionaryImage::save(tree, image_file.c_str()))
+    {
+      std::cout << "Can't write image: " << image_file << std::endl;
+      return;
+    }
+    double save_ms = ElapsedMs(start);
+
+    start = Clock::now();
+    DictionaryImage image;
+    if (!image.open(image_file.c_str()))
+    {
+      std::cout << "Can't map image: " << image_file << std::endl;
+      return;
+    }
+    double open_ms = ElapsedMs(start);
+
+    std::cout << "keys: " << image.size() << " (tree " << tree.size() << "), height: " << image.height()
+              << " (tree " << tree.height() << ")" << endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "parse + build tree: " << std::setw(10) << parse_ms << " ms" << endl;
+    std::cout << "save image:         " << std::setw(10) << save_ms << " ms" << endl;
+    std::cout << "map image:          " << std::setw(10) << open_ms << " ms" << endl;
+
+    unsigned mismatches = 0;
+    for (unsigned i = 0; i < tree.size(); i++)
+    {
+      if (tree[static_cast<int>(i)]->data != image[static_cast<int>(i)])
+        mismatches++;
+    }
+
+    std::vector<std::string> queries(words);
+    for (size_t i = 0; i < words.size(); i++)
+      queries.push_back(words[i] + "Q");
+    Shuffle(queries);
+
+    unsigned compares;
+    unsigned long tree_compares = 0, image_compares = 0;
+    unsigned tree_found = 0, image_found = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+      compares = 0;
+      tree_found += tree.find(queries[i], compares);
+      tree_compares += compares;
+    }
+    double tree_ms = ElapsedMs(start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+      compares = 0;
+      image_found += image.find(queries[i], compares);
+      image_compares += compares;
+    }
+    double image_ms = ElapsedMs(start);
+
+    double num_queries = static_cast<double>(queries.size());
+    std::cout << queries.size() << " lookups, half misses" << endl;
+    std::cout << "AVLTree find:       " << std::setw(10) << tree_ms << " ms, "
+              << static_cast<double>(tree_compares) / num_queries << " compares, " << tree_found << " found" << endl;
+    std::cout << "image find:         " << std::setw(10) << image_ms << " ms, "
+              << static_cast<double>(image_compares) / num_queries << " compares, " << image_found << " found" << endl;
+    std::cout << "index mismatches: " << mismatches << endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    image.close();
+    std::remove(image_file.c_str());
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
+
+// Writes roughly bytes of text made of dictionary words in mixed case with
+// punctuation and line breaks. Like real text, a few words are much more
+// common than the rest. About one word in 25 has a letter changed.
+void WriteCorpus(std::vector<std::string> words, const char *filename, size_t bytes)
+{
+  Shuffle(words);
+  std::ofstream outfile(filename, std::ios::binary | std::ios::trunc);
+  const char *separators[] = {" ", " ", " ", " ", ", ", ". ", "; ", " - "};
+  std::string line;
+  size_t written = 0;
+  while (written < bytes)
+  {
+    int rank = RandomInt(0, RandomInt(0, static_cast<int>(words.size()) - 1));
+    std::string word = words[static_cast<size_t>(rank)];
+    for (size_t i = 0; i < word.size(); i++)
+      word[i] = static_cast<char>(word[i] - 'A' + 'a');
+    if (RandomInt(0, 24) == 0)
+      word[static_cast<size_t>(RandomInt(0, static_cast<int>(word.size()) - 1))] = static_cast<char>('a' + RandomInt(0, 25));
+    if (RandomInt(0, 9) == 0)
+      word[0] = static_cast<char>(word[0] - 'a' + 'A');
+    line += word;
+    if (line.size() > 70)
+    {
+      line += ".\n";
+      outfile << line;
+      written += line.size();
+      line.clear();
+    }
+    else
+      line += separators[RandomInt(0, 7)];
+  }
+  outfile << line << "\n";
+}
+
+// Checks a document one word at a time on one thread, the way TestSpellCheck2 does.
+template <typename Tree>
+std::vector<typename SpellChecker<Tree>::Misspelling> CheckOneByOne(const Tree &tree, const std::string &text)
+{
+  std::vector<typename SpellChecker<Tree>::Misspelling> result;
+  size_t line = 1, line_start = 0, i = 0;
+  while (i < text.size())
+  {
+    char c = text[i];
+    if (c == '\n')
+    {
+      line++;
+      line_start = ++i;
+    }
+    else if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
+    {
+      size_t start = i;
+      while (i < text.size() && ((text[i] >= 'a' && text[i] <= 'z') || (text[i] >= 'A' && text[i] <= 'Z')))
+        i++;
+      std::string word = text.substr(start, i - start);
+      std::string key = word;
+      mystrupr(const_cast<char *>(key.c_str()));
+      unsigned compares = 0;
+      if (!tree.find(key, compares))
+      {
+        typename SpellChecker<Tree>::Misspelling misspelling = {word, start, line, start - line_start + 1};
+        result.push_back(misspelling);
+      }
+    }
+    else
+      i++;
+  }
+  return result;
+}
+
+template <typename Misspellings>
+bool SameMisspellings(const Misspellings &lhs, const Misspellings &rhs)
+{
+  if (lhs.size() != rhs.size())
+    return false;
+  for (size_t i = 0; i < lhs.size(); i++)
+  {
+    if (lhs[i].word != rhs[i].word || lhs[i].offset != rhs[i].offset || lhs[i].line != rhs[i].line ||
+        lhs[i].column != rhs[i].column)
+      return false;
+  }
+  return true;
+}
+
+void TestSpellCheckPipeline(void)
+{
+  const char *test = "TestSpellCheckPipeline";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    std::vector<std::string> words;
+    if (!LoadWords(words, gFile))
+      return;
+    AVLTree<std::string> tree;
+    for (size_t i = 0; i < words.size(); i++)
+      tree.insert(words[i]);
+
+    std::string corpus_file = std::string(gFile) + ".corpus";
+    const size_t corpus_bytes = 16 * 1024 * 1024;
+    WriteCorpus(words, corpus_file.c_str(), corpus_bytes);
+    std::string text;
+    {
+      std::ifstream infile(corpus_file.c_str(), std::ios::binary);
+      std::ostringstream contents;
+      contents << infile.rdbuf();
+      text = contents.str();
+    }
+    double megabytes = static_cast<double>(text.size()) / (1024.0 * 1024.0);
+    std::cout << "corpus: " << std::fixed << std::setprecision(1) << megabytes << " MB of words from " << gFile
+              << endl;
+
+    Clock::time_point start = Clock::now();
+    std::vector<SpellChecker<AVLTree<std::string> >::Misspelling> expected = CheckOneByOne(tree, text);
+    double serial_ms = ElapsedMs(start);
+    std::cout << "one by one (in memory): " << std::setw(8) << serial_ms << " ms, " << std::setw(7)
+              << megabytes * 1000.0 / serial_ms << " MB/s, " << expected.size() << " misspelled" << endl;
+
+    // small chunks so words and lines cross block and chunk boundaries
+    {
+      std::ifstream infile(corpus_file.c_str(), std::ios::binary);
+      SpellChecker<AVLTree<std::string> > checker(tree, 3, 1000);
+      if (!SameMisspellings(checker.check(infile), expected))
+        std::cout << "small chunks: results differ" << endl;
+    }
+
+    std::vector<unsigned> counts = ThreadCounts();
+    for (size_t t = 0; t < counts.size(); t++)
+    {
+      std::ifstream infile(corpus_file.c_str(), std::ios::binary);
+      SpellChecker<AVLTree<std::string> > checker(tree, counts[t]);
+      start = Clock::now();
+      std::vector<SpellChecker<AVLTree<std::string> >::Misspelling> found = checker.check(infile);
+      double ms = ElapsedMs(start);
+      std::cout << std::setw(2) << counts[t] << " threads (streamed):  " << std::setw(8) << ms << " ms, "
+                << std::setw(7) << megabytes * 1000.0 / ms << " MB/s, " << found.size() << " misspelled, "
+                << checker.lookups() << " lookups for " << checker.words() << " words"
+                << (SameMisspellings(found, expected) ? "" : " (results differ)") << endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+
+    if (!expected.empty())
+      std::cout << "first: " << expected[0].word << " at line " << expected[0].line << ", column "
+                << expected[0].column << endl;
+    std::remove(corpus_file.c_str());
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
+
+// Levenshtein distance with the full dynamic programming table, one row at a time.
+unsigned Levenshtein(const std::string &lhs, const std::string &rhs)
+{
+  std::vector<unsigned> row(rhs.size() + 1);
+  for (size_t j = 0; j <= rhs.size(); j++)
+    row[j] = static_cast<unsigned>(j);
+  for (size_t i = 1; i <= lhs.size(); i++)
+  {
+    unsigned diagonal = row[0];
+    row[0] = static_cast<unsigned>(i);
+    for (size_t j = 1; j <= rhs.size(); j++)
+    {
+      unsigned above = row[j];
+      row[j] = std::min(std::min(row[j] + 1, row[j - 1] + 1), diagonal + (lhs[i - 1] == rhs[j - 1] ? 0 : 1));
+      diagonal = above;
+    }
+  }
+  return row[rhs.size()];
+}
+
+// Scans every word of the dictionary for the k nearest words within max_distance.
+std::vector<SuggestionIndex::Suggestion> BruteForceSuggest(const std::vector<std::string> &words,
+                                                           const std::string &query, unsigned max_distance,
+                                                           unsigned k)
+{
+  std::vector<SuggestionIndex::Suggestion> result;
+  for (size_t i = 0; i < words.size(); i++)
+  {
+    unsigned distance = Levenshtein(query, words[i]);
+    if (distance <= max_distance)
+    {
+      SuggestionIndex::Suggestion suggestion = {words[i], distance};
+      result.push_back(suggestion);
+    }
+  }
+  std::sort(result.begin(), result.end(),
+            [](const SuggestionIndex::Suggestion &lhs, const SuggestionIndex::Suggestion &rhs) {
+              return lhs.distance < rhs.distance || (lhs.distance == rhs.distance && lhs.word < rhs.word);
+            });
+  if (result.size() > k)
+    result.resize(k);
+  return result;
+}
+
+bool SameSuggestions(const std::vector<SuggestionIndex::Suggestion> &lhs,
+                     const std::vector<SuggestionIndex::Suggestion> &rhs)
+{
+  if (lhs.size() != rhs.size())
+    return false;
+  for (size_t i = 0; i < lhs.size(); i++)
+  {
+    if (lhs[i].word != rhs[i].word || lhs[i].distance != rhs[i].distance)
+      return false;
+  }
+  return true;
+}
+
+void TestSuggestions(void)
+{
+  const char *test = "TestSuggestions";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    std::vector<std::string> words;
+    if (!LoadWords(words, gFile))
+      return;
+    AVLTree<std::string> tree;
+    for (size_t i = 0; i < words.size(); i++)
+      tree.insert(words[i]);
+
+    Clock::time_point start = Clock::now();
+    SuggestionIndex index(tree);
+    double build_ms = ElapsedMs(start);
+
+    // misspellings with one or two random edits
+    std::vector<std::string> queries;
+    for (int i = 0; i < 2000; i++)
+    {
+      std::string word = words[static_cast<size_t>(RandomInt(0, static_cast<int>(words.size()) - 1))];
+      int edits = RandomInt(1, 2);
+      for (int e = 0; e < edits; e++)
+      {
+        size_t at = static_cast<size_t>(RandomInt(0, static_cast<int>(word.size()) - 1));
+        char letter = static_cast<char>('A' + RandomInt(0, 25));
+        switch (RandomInt(0, 2))
+        {
+          case 0: word[at] = letter; break;
+          case 1: word.insert(at, 1, letter); break;
+          default: if (word.size() > 1) word.erase(at, 1); break;
+        }
+      }
+      queries.push_back(word);
+    }
+
+    const unsigned max_distance = 2;
+    const unsigned k = 5;
+    std::cout << index.size() << " words, index built in " << std::fixed << std::setprecision(1) << build_ms
+              << " ms; " << queries.size() << " queries, top " << k << " within distance " << max_distance << endl;
+
+    const size_t brute_queries = 100;
+    std::vector<std::vector<SuggestionIndex::Suggestion> > expected;
+    start = Clock::now();
+    for (size_t i = 0; i < brute_queries; i++)
+      expected.push_back(BruteForceSuggest(words, queries[i], max_distance, k));
+    double brute_ms = ElapsedMs(start) / static_cast<double>(brute_queries);
+
+    unsigned long distances = 0;
+    unsigned mismatches = 0;
+    std::vector<std::vector<SuggestionIndex::Suggestion> > single(queries.size());
+    start = Clock::now();
+    for (size_t i = 0; i < queries.size(); i++)
+    {
+      unsigned count = 0;
+      single[i] = index.suggest(queries[i], max_distance, k, count);
+      distances += count;
+    }
+    double index_ms = ElapsedMs(start) / static_cast<double>(queries.size());
+    for (size_t i = 0; i < brute_queries; i++)
+      mismatches += !SameSuggestions(single[i], expected[i]);
+
+    std::cout << std::setprecision(3);
+    std::cout << "brute force scan:  " << std::setw(9) << brute_ms << " ms/query, " << words.size()
+              << " distances" << endl;
+    std::cout << "BK-tree + Myers:   " << std::setw(9) << index_ms << " ms/query, "
+              << static_cast<double>(distances) / static_cast<double>(queries.size()) << " distances"
+              << (mismatches ? " (results differ)" : "") << endl;
+
+    std::vector<unsigned> counts = ThreadCounts();
+    for (size_t t = 0; t < counts.size(); t++)
+    {
+      start = Clock::now();
+      std::vector<std::vector<SuggestionIndex::Suggestion> > batch = index.suggest(queries, max_distance, k, counts[t]);
+      double ms = ElapsedMs(start);
+      unsigned differ = 0;
+      for (size_t i = 0; i < queries.size(); i++)
+        differ += !SameSuggestions(batch[i], single[i]);
+      std::cout << "batch, " << std::setw(2) << counts[t] << " threads: " << std::setw(9) << ms << " ms, "
+                << std::setprecision(0) << static_cast<double>(queries.size()) * 1000.0 / ms << " queries/s"
+                << std::setprecision(3) << (differ ? " (results differ)" : "") << endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+
+    std::cout << queries[0] << ":";
+    for (size_t i = 0; i < single[0].size(); i++)
+      std::cout << " " << single[0][i].word << " (" << single[0][i].distance << ")";
+    std::cout << endl;
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
+
+// Bytes of the tree nodes plus the heap buffers of strings too long for the
+// small-string buffer.
+size_t StringTreeBytes(const AVLTree<std::string> &tree)
+{
+  size_t bytes = NodeBytes(tree);
+  std::string small;
+  for (unsigned i = 0; i < tree.size(); i++)
+  {
+    const std::string &word = tree[static_cast<int>(i)]->data;
+    if (word.capacity() > small.capacity())
+      bytes += word.capacity() + 1;
+  }
+  return bytes;
+}
+
+template <typename Dictionary>
+double TimeLookups(const Dictionary &dictionary, const std::vector<std::string> &queries, double &compares_per_find,
+                   unsigned &found)
+{
+  unsigned long total = 0;
+  found = 0;
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < queries.size(); i++)
+  {
+    unsigned compares = 0;
+    found += dictionary.find(queries[i], compares);
+    total += compares;
+  }
+  double ms = ElapsedMs(start);
+  compares_per_find = static_cast<double>(total) / static_cast<double>(queries.size());
+  return ms;
+}
+
+void TestWordGraph(void)
+{
+  const char *test = "TestWordGraph";
+  std::cout << "\n====================== " << test << " ======================\n";
+
+  try
+  {
+    std::vector<std::string> words;
+    if (!LoadWords(words, gFile))
+      return;
+
+    Clock::time_point start = Clock::now();
+    AVLTree<std::string> tree;
+    for (size_t i = 0; i < words.size(); i++)
+      tree.insert(words[i]);
+    double tree_build_ms = ElapsedMs(start);
+
+    start = Clock::now();
+    DAWG dawg;
+    for (size_t i = 0; i < words.size(); i++)
+      dawg.insert(words[i]);
+    dawg.finish();
+    double dawg_build_ms = ElapsedMs(start);
+
+    std::vector<std::string> queries(words);
+    for (size_t i = 0; i < words.size(); i++)
+      queries.push_back(words[i] + "Q");
+    Shuffle(queries);
+
+    double tree_compares, dawg_compares;
+    unsigned tree_found, dawg_found;
+    double tree_ms = TimeLookups(tree, queries, tree_compares, tree_found);
+    double dawg_ms = TimeLookups(dawg, queries, dawg_compares, dawg_found);
+
+    std::cout << words.size() << " words from " << gFile << ", " << queries.size() << " lookups (half misses)"
+              << endl;
+    std::cout << "DAWG: " << dawg.states() << " states, " << dawg.transitions() << " transitions" << endl;
+    std::cout << std::setw(10) << std::left << "dictionary" << std::right << std::setw(10) << "build" << std::setw(10)
+              << "find" << std::setw(10) << "cmp/find" << std::setw(12) << "bytes" << std::setw(10) << "B/word"
+              << std::setw(10) << "found" << endl;
+    std::cout << std::fixed << std::setprecision(1);
+    size_t tree_bytes = StringTreeBytes(tree);
+    size_t dawg_bytes = dawg.memory();
+    double num_words = static_cast<double>(words.size());
+    std::cout << std::setw(10) << std::left << "AVLTree" << std::right << std::setw(10) << tree_build_ms << std::setw(10)
+              << tree_ms << std::setw(10) << tree_compares << std::setw(12) << tree_bytes << std::setw(10)
+              << static_cast<double>(tree_bytes) / num_words << std::setw(10) << tree_found << endl;
+    std::cout << std::setw(10) << std::left << "DAWG" << std::right << std::setw(10) << dawg_build_ms << std::setw(10)
+              << dawg_ms << std::setw(10) << dawg_compares << std::setw(12) << dawg_bytes << std::setw(10)
+              << static_cast<double>(dawg_bytes) / num_words << std::setw(10) << dawg_found << endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    // prefix queries: completions of every two-letter prefix
+    start = Clock::now();
+    size_t completions = 0;
+    unsigned prefixes = 0;
+    for (char first = 'A'; first <= 'Z'; first++)
+    {
+      for (char second = 'A'; second <= 'Z'; second++)
+      {
+        std::string prefix(1, first);
+        prefix += second;
+        if (dawg.has_prefix(prefix))
+        {
+          prefixes++;
+          completions += dawg.words_with_prefix(prefix, 10).size();
+        }
+      }
+    }
+    std::cout << prefixes << " two-letter prefixes in use, " << completions << " completions (10 each at most) in "
+              << std::fixed << std::setprecision(2) << ElapsedMs(start) << " ms" << endl;
+    std::cout.unsetf(std::ios::fixed);
+  }
+  catch (const BSTException &e)
+  {
+    std::cout << "Caught BSTException in: " << test << ": ";
+    int value = e.code();
+    if (value == BSTException::E_NO_MEMORY)
+      std::cout << "E_NO_MEMORY" << std::endl;
+    else
+      std::cout << "Unknown error code." << std::endl;
+  }
+  catch(...)
+  {
+    std::cout << "Unknown exception." << std::endl;
+  }
+}
+
+//***********************************************************************
+//***********************************************************************
+//***********************************************************************
+
+typedef void (*TestFn)(void);
+
+int main(int argc, char **argv)
+{
+    // Test number
+  int test_num = 0;
+  if (argc > 1)
+    test_num = std::atoi(argv[1]);
+
+    // Dictionary
+  if (argc > 2)
+    gFile = argv[2];
+
+    // Maximum number of threads
+  if (argc > 3)
+    gMaxThreads = static_cast<unsigned>(std::atoi(argv[3]));
+
+  TestFn Tests[] = {
+                    TestConcurrentReads,   // 1 read-mostly scaling, lock-free vs rwlock
+                    TestSetOperations,     // 2 join/split based set operations vs insert loop
+                    TestOrderedSets,       // 3 BSTree vs AVLTree vs BTree per workload
+                    TestDictionaryImage,   // 4 parse + build vs mapped dictionary image
+                    TestSpellCheckPipeline,// 5 batch multi-threaded spell check of a corpus
+                    TestSuggestions,       // 6 BK-tree suggestions vs brute-force scan
+                    TestWordGraph,         // 7 DAWG vs AVLTree as a string dictionary
+                   };
+
+  int num = sizeof(Tests) / sizeof(*Tests);
+  if (test_num == 0)
+  {
+    for (int i = 0; i < num; i++)
+      Tests[i]();
+  }
+  else if (test_num > 0 && test_num <= num)
+  {
+    Tests[test_num - 1]();
+  }
+
+  return 0;
+}
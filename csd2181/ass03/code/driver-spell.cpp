@@ -11,6 +11,7 @@
 
 #include "BSTree.h"
 #include "AVLTree.h"
+#include "DAWG.h"
 #include "PRNG.h"
 #include "ObjectAllocator.h"
 
@@ -136,9 +137,20 @@ void PrintBST(const BSTree<T> &tree)
   }
 }
 
+// A DAWG has no tree to draw, so list its words and the size of the graph
+void PrintBST(const DAWG &dawg)
+{
+  std::vector<std::string> words = dawg.words_with_prefix("", dawg.size());
+  for (size_t i = 0; i < words.size(); i++)
+    std::cout << words[i] << std::endl;
+  std::cout << "states: " << dawg.states() << ", transitions: " << dawg.transitions() << std::endl;
+}
+
 const char *ReadableType(const char *name)
 {
-  if (std::strstr(name, "AVL"))
+  if (std::strstr(name, "DAWG"))
+    return "DAWG";
+  else if (std::strstr(name, "AVL"))
     return "AVLTree";
   else
     return "BSTree";
@@ -201,6 +213,17 @@ char *mystrupr(char *string)
   return string;
 }
 
+// Only a DAWG has work left after the last insert
+template <typename T>
+void FinishDictionary(T&)
+{
+}
+
+void FinishDictionary(DAWG &dawg)
+{
+  dawg.finish();
+}
+
 template <typename T>
 bool LoadDictionary(T& tree, const char *filename)
 {
@@ -220,6 +243,7 @@ bool LoadDictionary(T& tree, const char *filename)
     mystrupr(const_cast<char *>(word.c_str()));
     tree.insert(word);
   }
+  FinishDictionary(tree);
   return true;
 }
 
@@ -444,6 +468,8 @@ int main(int argc, char **argv)
                        {TestSpellCheck1<AVLTree<U> >, 10000, 5000}, 
                        {TestSpellCheck2<BSTree<U> >,  10000, 5000}, 
                        {TestSpellCheck2<AVLTree<U> >, 10000, 5000}, 
+                       {TestSpellCheck1<DAWG>,        10000, 5000}, 
+                       {TestSpellCheck2<DAWG>,        10000, 5000}, 
                       };
 
   int num = sizeof(Tests) / sizeof(*Tests);
@@ -11,11 +11,555 @@
 #include "ALGraph.h"
 #include <queue>
 #include <algorithm>
+#include <cstddef>
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <cctype>
+#include <utility>
+#include <functional>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <exception>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ALGRAPH_SSE2
+#include <emmintrin.h> // _mm_add_epi32, _mm_cmpgt_epi32
+#endif
+
+namespace
+{
+const std::size_t FW_BLOCK = 64;     // Nodes per side of a Floyd-Warshall block, 16 KB of ints
+const int FW_INFINITY = 0x3fffffff;  // Floyd-Warshall cost of no path; two add up to at most INT_MAX
+
+/**
+ * @brief Relaxes one Floyd-Warshall block through the k of another.
+ * For each k of the block's round, in order, and each i and j,
+ * c[i][j] = min(c[i][j], a[i][k] + b[k][j]). With SSE2 four j are done at once.
+ * Any of the three blocks may be the same block.
+ * @param c The block to relax, row i at c + i * stride.
+ * @param a The block of c's rows and the round's columns.
+ * @param b The block of the round's rows and c's columns.
+ * @param stride The distance between rows of the matrix.
+ */
+void RelaxBlock(int *c, const int *a, const int *b, std::size_t stride)
+{
+    for (std::size_t k = 0; k < FW_BLOCK; ++k)
+    {
+        const int *b_row = b + k * stride;
+        for (std::size_t i = 0; i < FW_BLOCK; ++i)
+        {
+            int a_ik = a[i * stride + k];
+            if (a_ik >= FW_INFINITY)
+            {
+                continue;
+            }
+            int *c_row = c + i * stride;
+#ifdef ALGRAPH_SSE2
+            __m128i through = _mm_set1_epi32(a_ik);
+            for (std::size_t j = 0; j < FW_BLOCK; j += 4)
+            {
+                __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(c_row + j));
+                __m128i candidate = _mm_add_epi32(through, _mm_loadu_si128(reinterpret_cast<const __m128i *>(b_row + j)));
+                __m128i shorter = _mm_cmpgt_epi32(current, candidate);
+                current = _mm_or_si128(_mm_and_si128(shorter, candidate), _mm_andnot_si128(shorter, current));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(c_row + j), current);
+            }
+#else
+            for (std::size_t j = 0; j < FW_BLOCK; ++j)
+            {
+                c_row[j] = std::min(c_row[j], a_ik + b_row[j]);
+            }
+#endif
+        }
+    }
+}
+
+/**
+ * @brief Moves past white space.
+ * @param p The position in the text, moved to the next character that is not space.
+ * @param end The end of the text.
+ * @return True if there is more text, false at the end.
+ */
+bool SkipSpace(const char *&p, const char *end)
+{
+    while (p != end && std::isspace(static_cast<unsigned char>(*p)))
+    {
+        ++p;
+    }
+    return p != end;
+}
+/**
+ * @brief Reads an unsigned decimal number after optional white space.
+ * @param p The position in the text, moved past the number.
+ * @param end The end of the text.
+ * @param value Receives the number.
+ * @return True if there was a number that fits in an unsigned, false otherwise.
+ */
+bool ReadUnsigned(const char *&p, const char *end, unsigned &value)
+{
+    if (!SkipSpace(p, end) || !std::isdigit(static_cast<unsigned char>(*p)))
+    {
+        return false;
+    }
+    unsigned long long number = 0;
+    while (p != end && std::isdigit(static_cast<unsigned char>(*p)))
+    {
+        number = number * 10 + static_cast<unsigned>(*p - '0');
+        if (number > static_cast<unsigned>(-1))
+        {
+            return false;
+        }
+        ++p;
+    }
+    value = static_cast<unsigned>(number);
+    return p == end || std::isspace(static_cast<unsigned char>(*p));
+}
+
+typedef std::pair<unsigned, unsigned> CostNode; // (cost, 0-based node), ordered by cost then node
+
+/*!
+  std::priority_queue with lazy deletion: an improved cost is pushed again
+  and the stale entry is skipped by the search when it comes out.
+*/
+class BinaryHeap
+{
+public:
+    /**
+     * @brief Adds a node, or a lower cost for it.
+     * @param node The 0-based node.
+     * @param cost Its cost.
+     */
+    void push(unsigned node, unsigned cost)
+    {
+        heap_.emplace(cost, node);
+    }
+    /**
+     * @brief Removes the entry with the lowest (cost, node).
+     * @return Its node, which may already be settled.
+     */
+    unsigned pop(void)
+    {
+        unsigned node = heap_.top().second;
+        heap_.pop();
+        return node;
+    }
+    /**
+     * @brief Checks whether the queue is empty.
+     * @return True if there are no entries.
+     */
+    bool empty(void) const
+    {
+        return heap_.empty();
+    }
+
+private:
+    std::priority_queue<CostNode, std::vector<CostNode>, std::greater<CostNode>> heap_;
+};
+
+/*!
+  An indexed 4-ary min-heap of (cost, node). Each node is in the heap at most
+  once and position_ finds it for decrease-key, so the heap never holds more
+  entries than nodes. Four children per entry halve the depth of a binary
+  heap, and the children of an entry share a cache line.
+*/
+class FourAryHeap
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param nodes The number of nodes in the graph.
+     */
+    explicit FourAryHeap(unsigned nodes = 0) : position_(nodes, NONE)
+    {
+    }
+    /**
+     * @brief Empties the heap and sizes it for a graph.
+     * Only the positions of the entries left in the heap are cleared, unless
+     * the number of nodes changes.
+     * @param nodes The number of nodes in the graph.
+     */
+    void reset(unsigned nodes)
+    {
+        for (const CostNode &entry : heap_)
+        {
+            position_[entry.second] = NONE;
+        }
+        heap_.clear();
+        if (position_.size() != nodes)
+        {
+            position_.assign(nodes, NONE);
+        }
+    }
+    /**
+     * @brief Gets the lowest cost in the heap.
+     * @return The cost of the entry pop would remove.
+     */
+    unsigned top_cost(void) const
+    {
+        return heap_[0].first;
+    }
+    /**
+     * @brief Adds a node, or lowers its cost.
+     * @param node The 0-based node.
+     * @param cost Its cost, lower than any it has in the heap.
+     */
+    void push(unsigned node, unsigned cost)
+    {
+        std::size_t i = position_[node];
+        if (i == NONE)
+        {
+            i = heap_.size();
+            heap_.emplace_back(cost, node);
+        }
+        else
+        {
+            heap_[i].first = cost;
+        }
+        sift_up(i);
+    }
+    /**
+     * @brief Removes the entry with the lowest (cost, node).
+     * @return Its node.
+     */
+    unsigned pop(void)
+    {
+        unsigned node = heap_[0].second;
+        position_[node] = NONE;
+        heap_[0] = heap_.back();
+        heap_.pop_back();
+        if (!heap_.empty())
+        {
+            sift_down(0);
+        }
+        return node;
+    }
+    /**
+     * @brief Checks whether the heap is empty.
+     * @return True if there are no entries.
+     */
+    bool empty(void) const
+    {
+        return heap_.empty();
+    }
+
+private:
+    static const std::size_t NONE = static_cast<std::size_t>(-1);
+    std::vector<CostNode> heap_;         // The heap, children of i at 4i + 1 to 4i + 4
+    std::vector<std::size_t> position_;  // Index in heap_ of each node, NONE if absent
+
+    /**
+     * @brief Moves an entry up until its parent is lower.
+     * @param i The index of the entry.
+     */
+    void sift_up(std::size_t i)
+    {
+        CostNode entry = heap_[i];
+        while (i > 0)
+        {
+            std::size_t parent = (i - 1) / 4;
+            if (!(entry < heap_[parent]))
+            {
+                break;
+            }
+            heap_[i] = heap_[parent];
+            position_[heap_[i].second] = i;
+            i = parent;
+        }
+        heap_[i] = entry;
+        position_[entry.second] = i;
+    }
+    /**
+     * @brief Moves an entry down until its children are higher.
+     * @param i The index of the entry.
+     */
+    void sift_down(std::size_t i)
+    {
+        CostNode entry = heap_[i];
+        std::size_t size = heap_.size();
+        for (;;)
+        {
+            std::size_t first = 4 * i + 1;
+            if (first >= size)
+            {
+                break;
+            }
+            std::size_t last = std::min(first + 4, size);
+            std::size_t smallest = first;
+            for (std::size_t child = first + 1; child < last; ++child)
+            {
+                if (heap_[child] < heap_[smallest])
+                {
+                    smallest = child;
+                }
+            }
+            if (!(heap_[smallest] < entry))
+            {
+                break;
+            }
+            heap_[i] = heap_[smallest];
+            position_[heap_[i].second] = i;
+            i = smallest;
+        }
+        heap_[i] = entry;
+        position_[entry.second] = i;
+    }
+};
+const std::size_t FourAryHeap::NONE;
+
+const unsigned NO_COST = static_cast<unsigned>(-1); // Cost of a node no search has reached
+
+/*!
+  The arrays and queue of one point-to-point search. A query only reaches
+  a small part of a large graph, so the space is kept per thread between
+  queries and prepare resets just the nodes the last query reached, instead
+  of filling arrays of the size of the graph.
+*/
+class SearchSpace
+{
+public:
+    std::vector<unsigned> cost;        // Best cost found for each 0-based node, NO_COST if none
+    std::vector<unsigned> predecessor; // 1-based node a node was reached from, 0 for none
+    FourAryHeap heap;                  // Nodes to settle
+
+    /**
+     * @brief Makes the space empty, for a graph of a number of nodes.
+     * @param nodes The number of nodes in the graph.
+     */
+    void prepare(unsigned nodes)
+    {
+        if (cost.size() != nodes)
+        {
+            cost.assign(nodes, NO_COST);
+            predecessor.assign(nodes, 0);
+        }
+        else
+        {
+            for (unsigned node : reached_)
+            {
+                cost[node] = NO_COST;
+                predecessor[node] = 0;
+            }
+        }
+        reached_.clear();
+        heap.reset(nodes);
+    }
+    /**
+     * @brief Records a lower cost for a node.
+     * @param node The 0-based node.
+     * @param new_cost Its cost.
+     * @param from The 1-based node it was reached from, 0 for the start.
+     */
+    void reach(unsigned node, unsigned new_cost, unsigned from)
+    {
+        if (cost[node] == NO_COST)
+        {
+            reached_.push_back(node);
+        }
+        cost[node] = new_cost;
+        predecessor[node] = from;
+    }
+
+private:
+    std::vector<unsigned> reached_; // Nodes whose cost is not NO_COST
+};
+
+/**
+ * @brief Gets this thread's space for forward searches.
+ * @return The space.
+ */
+SearchSpace &ForwardSpace(void)
+{
+    static thread_local SearchSpace space;
+    return space;
+}
+/**
+ * @brief Gets this thread's space for backward searches.
+ * @return The space.
+ */
+SearchSpace &BackwardSpace(void)
+{
+    static thread_local SearchSpace space;
+    return space;
+}
+
+/*!
+  A barrier for a fixed number of threads that work in rounds. The last
+  thread to arrive runs a function before any thread leaves, to set up the
+  next round. Rounds are short, so the others yield instead of sleeping.
+*/
+class RoundBarrier
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param threads The number of threads that wait at the barrier.
+     */
+    explicit RoundBarrier(unsigned threads) : threads_(threads), arrived_(0), round_(0)
+    {
+    }
+    /**
+     * @brief Waits for every thread, the last one first calling a function.
+     * Everything a thread wrote before waiting is seen by every thread after.
+     * @param last Called by the last thread to arrive.
+     */
+    template <typename Function>
+    void wait(Function last)
+    {
+        unsigned round = round_.load(std::memory_order_acquire);
+        if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == threads_)
+        {
+            last();
+            arrived_.store(0, std::memory_order_relaxed);
+            round_.store(round + 1, std::memory_order_release);
+        }
+        else
+        {
+            while (round_.load(std::memory_order_acquire) == round)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    const unsigned threads_;         // Threads that wait
+    std::atomic<unsigned> arrived_;  // Threads waiting in this round
+    std::atomic<unsigned> round_;    // Rounds finished
+};
+
+const std::size_t DELTA_CHUNK = 64;          // Frontier nodes a delta-stepping thread takes at a time
+const std::size_t DELTA_RING = 64;           // Buckets from the frontier's a delta-stepping thread keeps in a ring
+
+const unsigned WITNESS_SETTLES = 500;        // Nodes a witness search settles before giving up
+const unsigned ESTIMATE_SETTLES = 30;        // The same, when only estimating a node's shortcuts for its priority
+const char HIERARCHY_MAGIC[8] = "ALGCH";     // The start of a file written by ContractionHierarchy::Save
+const unsigned HIERARCHY_VERSION = 1;        // The format of the file
+
+/*!
+  The start of a hierarchy file. It is followed by the rank of each node,
+  then the up offsets and arcs, then the down offsets and arcs.
+*/
+struct HierarchyHeader
+{
+    char magic[8];       // HIERARCHY_MAGIC
+    unsigned version;    // HIERARCHY_VERSION
+    unsigned nodes;      // The number of nodes
+    unsigned up_count;   // The number of up arcs
+    unsigned down_count; // The number of down arcs
+};
+
+/*!
+  A radix heap for the monotone costs of Dijkstra's algorithm: no pushed cost
+  is below the last popped one. An entry goes to the bucket of the highest bit
+  in which its cost differs from the last popped cost, so bucket b holds costs
+  within 2^b of it. When the nodes at the last cost run out, the lowest
+  non-empty bucket is emptied into lower ones around its smallest cost, and
+  each entry moves at most 32 times. Nodes at the current cost are kept in a
+  min-heap by node, so ties come out in the same order as the other queues.
+  Stale entries are skipped by the search, as with BinaryHeap.
+*/
+class RadixHeap
+{
+public:
+    /**
+     * @brief Constructor.
+     */
+    RadixHeap() : last_(0), size_(0)
+    {
+    }
+    /**
+     * @brief Adds a node, or a lower cost for it.
+     * @param node The 0-based node.
+     * @param cost Its cost, not below the last popped cost.
+     */
+    void push(unsigned node, unsigned cost)
+    {
+        ++size_;
+        if (cost == last_)
+        {
+            ties_.push(node);
+        }
+        else
+        {
+            buckets_[bucket_of(cost ^ last_)].emplace_back(cost, node);
+        }
+    }
+    /**
+     * @brief Removes the entry with the lowest (cost, node).
+     * @return Its node, which may already be settled.
+     */
+    unsigned pop(void)
+    {
+        if (ties_.empty())
+        {
+            unsigned b = 1;
+            while (buckets_[b].empty())
+            {
+                ++b;
+            }
+            std::vector<CostNode> &bucket = buckets_[b];
+            last_ = std::min_element(bucket.begin(), bucket.end())->first;
+            for (const CostNode &entry : bucket)
+            {
+                if (entry.first == last_)
+                {
+                    ties_.push(entry.second);
+                }
+                else
+                {
+                    buckets_[bucket_of(entry.first ^ last_)].push_back(entry);
+                }
+            }
+            bucket.clear();
+        }
+        --size_;
+        unsigned node = ties_.top();
+        ties_.pop();
+        return node;
+    }
+    /**
+     * @brief Checks whether the heap is empty.
+     * @return True if there are no entries.
+     */
+    bool empty(void) const
+    {
+        return size_ == 0;
+    }
+
+private:
+    unsigned last_;                    // The last popped cost
+    std::size_t size_;                 // Entries in ties_ and buckets_
+    std::priority_queue<unsigned, std::vector<unsigned>, std::greater<unsigned>> ties_; // Nodes at last_
+    std::vector<CostNode> buckets_[33]; // Bucket b: costs whose highest bit differing from last_ is bit b - 1
+
+    /**
+     * @brief Gets the bucket of a cost.
+     * @param difference The cost xor the last popped cost, not 0.
+     * @return The position of its highest set bit, 1 to 32.
+     */
+    static unsigned bucket_of(unsigned difference)
+    {
+#if defined(__GNUC__)
+        return 32 - static_cast<unsigned>(__builtin_clz(difference));
+#else
+        unsigned bits = 0;
+        while (difference)
+        {
+            ++bits;
+            difference >>= 1;
+        }
+        return bits;
+#endif
+    }
+};
+} // namespace
 /**
  * @brief Constructor.
  * @param size The size of the graph.
  */
-ALGraph::ALGraph(unsigned size) : size_(size), adj_list_(size)
+ALGraph::ALGraph(unsigned size) : size_(size), adj_list_(size), frozen_(false)
 {
 }
 /**
@@ -32,21 +576,16 @@ ALGraph::~ALGraph(void)
  */
 void ALGraph::AddDEdge(unsigned source, unsigned destination, unsigned weight)
 {
+    if (frozen_)
+    {
+        thaw();
+    }
+    drop_reverse();
     --source;
     AdjInfo adj_info{destination, weight};
-    adj_list_[source].emplace_back(adj_info);
-    // Sort the adjacency list for the source node.
-    std::sort(adj_list_[source].begin(), adj_list_[source].end(), [](const AdjInfo &lhs, const AdjInfo &rhs) -> bool
-              { if(lhs.cost < rhs.cost)
-                {
-                  return true;
-                }
-                else if(lhs.cost == rhs.cost && lhs.des < rhs.des)
-                {
-                  return true;
-                }
-                
-                  return false; });
+    // Keep the adjacency list sorted by (cost, des).
+    std::vector<AdjInfo> &list = adj_list_[source];
+    list.insert(std::upper_bound(list.begin(), list.end(), adj_info), adj_info);
 }
 /**
  * @brief Adds an undirected edge to the graph.
@@ -60,78 +599,915 @@ void ALGraph::AddUEdge(unsigned node1, unsigned node2, unsigned weight)
     AddDEdge(node2, node1, weight);
 }
 /**
- * @brief Performs Dijkstra's algorithm on the graph.
- * @param start_node The starting node for Dijkstra's algorithm.
- * @return A vector containing Dijkstra's algorithm information for each node.
+ * @brief Adds many directed edges, sorting each adjacency list once.
+ * Counts the new edges of each node to grow its list once, appends them, and
+ * then sorts the new tail of every list and merges it with the old, sorted
+ * part. Lists are independent, so blocks of nodes are sorted in parallel.
+ * @param edges The edges, with 1-based nodes as in AddDEdge.
+ * @param threads The number of threads sorting the lists, 0 for one per core.
+ */
+void ALGraph::AddDEdges(const std::vector<EdgeInfo> &edges, unsigned threads)
+{
+    if (frozen_)
+    {
+        thaw();
+    }
+    drop_reverse();
+    std::vector<unsigned> old_sizes(size_);
+    std::vector<unsigned> added(size_, 0);
+    for (const EdgeInfo &edge : edges)
+    {
+        ++added[edge.source - 1];
+    }
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        old_sizes[i] = static_cast<unsigned>(adj_list_[i].size());
+        if (added[i])
+        {
+            adj_list_[i].reserve(old_sizes[i] + added[i]);
+        }
+    }
+    for (const EdgeInfo &edge : edges)
+    {
+        adj_list_[edge.source - 1].emplace_back(edge.destination, edge.weight);
+    }
+
+    const unsigned block = 1024;
+    std::atomic<unsigned> next_block(0);
+    auto sort_blocks = [&]()
+    {
+        for (unsigned first = next_block.fetch_add(block); first < size_; first = next_block.fetch_add(block))
+        {
+            unsigned last = std::min(size_, first + block);
+            for (unsigned i = first; i < last; ++i)
+            {
+                if (added[i])
+                {
+                    std::vector<AdjInfo> &list = adj_list_[i];
+                    std::sort(list.begin() + old_sizes[i], list.end());
+                    std::inplace_merge(list.begin(), list.begin() + old_sizes[i], list.end());
+                }
+            }
+        }
+    };
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // A thread is not worth starting for less than about 64K edges.
+    threads = std::min(threads, static_cast<unsigned>(edges.size() / 65536 + 1));
+    threads = std::min(threads, (size_ + block - 1) / block);
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+    {
+        workers.emplace_back(sort_blocks);
+    }
+    sort_blocks();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+/**
+ * @brief Adds the directed edges listed in a text file.
+ * Reads every edge before adding any, so a bad file leaves the graph as it was.
+ * @param filename A file of "source destination weight" lines.
+ * @param threads The number of threads sorting the lists, 0 for one per core.
+ * @return True if every edge was read and added, false (adding none) if the
+ * file cannot be opened, is not a list of edges or names a node outside the graph.
+ */
+bool ALGraph::LoadDEdges(const char *filename, unsigned threads)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (length < 0)
+    {
+        return false;
+    }
+    std::vector<char> text(static_cast<std::size_t>(length));
+    if (!file.read(text.data(), length))
+    {
+        return false;
+    }
+    const char *p = text.data();
+    const char *end = p + text.size();
+    std::vector<EdgeInfo> edges;
+    edges.reserve(text.size() / 16); // About 16 characters per edge
+    EdgeInfo edge;
+    while (SkipSpace(p, end))
+    {
+        if (!ReadUnsigned(p, end, edge.source) || !ReadUnsigned(p, end, edge.destination) ||
+            !ReadUnsigned(p, end, edge.weight) ||
+            edge.source < 1 || edge.source > size_ || edge.destination < 1 || edge.destination > size_)
+        {
+            return false;
+        }
+        edges.push_back(edge);
+    }
+    AddDEdges(edges, threads);
+    return true;
+}
+/**
+ * @brief Performs Dijkstra's algorithm on the graph.
+ * Builds the shortest path tree, then each node's path from its predecessors.
+ * @param start_node The starting node for Dijkstra's algorithm.
+ * @param queue The priority queue to search with.
+ * @return A vector containing Dijkstra's algorithm information for each node.
+ */
+std::vector<DijkstraInfo> ALGraph::Dijkstra(unsigned start_node, PQType queue) const
+{
+    DijkstraTree tree = ShortestPathTree(start_node, queue);
+    std::vector<DijkstraInfo> dijkstra_info(size_);
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        dijkstra_info[i].cost = tree.cost[i];
+        dijkstra_info[i].path = tree.Path(i + 1);
+    }
+    return dijkstra_info;
+}
+/**
+ * @brief Performs Dijkstra's algorithm, keeping only costs and predecessors.
+ * A relaxed node records the node it was reached from instead of a copy of
+ * that node's path, so each relaxation is O(1). The paths are the same as
+ * Dijkstra's: a node's predecessor is settled, and its path final, before
+ * the node is relaxed from it.
+ * @param start_node The starting node for Dijkstra's algorithm.
+ * @param queue The priority queue to search with.
+ * @return The cost of and predecessor on the path to each node.
+ */
+DijkstraTree ALGraph::ShortestPathTree(unsigned start_node, PQType queue) const
+{
+    DijkstraTree tree;
+    tree.start = start_node;
+    std::vector<bool> visited;
+    with_queue(queue, [&](auto &heap) { search(tree, heap, visited); });
+    return tree;
+}
+/**
+ * @brief Finds the cost from each of many start nodes to every node, in parallel.
+ * @param sources The 1-based start nodes.
+ * @param threads The number of threads, 0 for one per core.
+ * @param queue The priority queue to search with.
+ * @return sources.size() rows of size costs: row r, column i is the cost from sources[r] to node i + 1.
+ */
+std::vector<unsigned> ALGraph::DistanceMatrix(const std::vector<unsigned> &sources, unsigned threads,
+                                              PQType queue) const
+{
+    std::vector<unsigned> matrix(sources.size() * size_);
+    auto sink = [&](std::size_t row, const DijkstraTree &tree)
+    {
+        std::copy(tree.cost.begin(), tree.cost.end(), matrix.begin() + static_cast<std::ptrdiff_t>(row * size_));
+    };
+    for_each_source(sources, threads, queue, sink);
+    return matrix;
+}
+/**
+ * @brief Builds the shortest path tree of each of many start nodes, in parallel.
+ * @param sources The 1-based start nodes.
+ * @param threads The number of threads, 0 for one per core.
+ * @param queue The priority queue to search with.
+ * @return The tree of sources[r] at index r.
+ */
+std::vector<DijkstraTree> ALGraph::ShortestPathTrees(const std::vector<unsigned> &sources, unsigned threads,
+                                                     PQType queue) const
+{
+    std::vector<DijkstraTree> trees(sources.size());
+    auto sink = [&](std::size_t row, const DijkstraTree &tree)
+    {
+        trees[row] = tree;
+    };
+    for_each_source(sources, threads, queue, sink);
+    return trees;
+}
+/**
+ * @brief Finds the cost between every pair of nodes with the Floyd-Warshall algorithm.
+ * The matrix is padded to whole blocks of FW_BLOCK nodes and each round of
+ * FW_BLOCK values of k is done block by block: first the block on the
+ * diagonal, then the other blocks in its row and column, which need only
+ * the diagonal, and then all the rest, which need only those. Every block
+ * is then worked on while it is in cache. Costs are ints with FW_INFINITY
+ * for no path, so the sum of two is never above INT_MAX.
+ * @return size rows of size costs: row r, column i is the cost from node r + 1 to node i + 1.
+ */
+std::vector<unsigned> ALGraph::FloydWarshall(void) const
+{
+    std::size_t blocks = (size_ + FW_BLOCK - 1) / FW_BLOCK;
+    std::size_t stride = blocks * FW_BLOCK;
+    std::vector<int> costs(stride * stride, FW_INFINITY);
+    for (std::size_t i = 0; i < stride; ++i)
+    {
+        costs[i * stride + i] = 0;
+    }
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        const AdjInfo *end = edges_end(i);
+        for (const AdjInfo *it = edges_begin(i); it != end; ++it)
+        {
+            int &cost = costs[i * stride + it->des - 1];
+            int weight = static_cast<int>(std::min(it->cost, static_cast<unsigned>(FW_INFINITY)));
+            cost = std::min(cost, weight);
+        }
+    }
+
+    int *matrix = costs.data();
+    for (std::size_t k = 0; k < blocks; ++k)
+    {
+        int *diagonal = matrix + (k * stride + k) * FW_BLOCK;
+        RelaxBlock(diagonal, diagonal, diagonal, stride);
+        for (std::size_t j = 0; j < blocks; ++j)
+        {
+            if (j != k)
+            {
+                int *row = matrix + (k * stride + j) * FW_BLOCK;
+                RelaxBlock(row, diagonal, row, stride);
+                int *column = matrix + (j * stride + k) * FW_BLOCK;
+                RelaxBlock(column, column, diagonal, stride);
+            }
+        }
+        for (std::size_t i = 0; i < blocks; ++i)
+        {
+            for (std::size_t j = 0; i != k && j < blocks; ++j)
+            {
+                if (j != k)
+                {
+                    RelaxBlock(matrix + (i * stride + j) * FW_BLOCK, matrix + (i * stride + k) * FW_BLOCK,
+                               matrix + (k * stride + j) * FW_BLOCK, stride);
+                }
+            }
+        }
+    }
+
+    std::vector<unsigned> result(static_cast<std::size_t>(size_) * size_);
+    for (std::size_t i = 0; i < size_; ++i)
+    {
+        for (std::size_t j = 0; j < size_; ++j)
+        {
+            int cost = costs[i * stride + j];
+            result[i * size_ + j] = cost >= FW_INFINITY ? INFINITY_ : static_cast<unsigned>(cost);
+        }
+    }
+    return result;
+}
+/**
+ * @brief Finds the cost from a node to every node with delta-stepping, in parallel.
+ * Costs are grouped in buckets of delta. The nodes of the lowest bucket that
+ * is not empty form the frontier, and the threads take chunks of it and
+ * relax their edges at once, lowering costs with compare-and-swap. A node
+ * whose cost drops goes into the bucket of its new cost, kept by the thread
+ * that lowered it. Then the threads gather the next frontier from their
+ * buckets, which is the same bucket again while edges land in it. No edge
+ * leads to a lower bucket, so each bucket is finished once it is empty, and
+ * every cost is the least over all paths, as Dijkstra's is. A small delta
+ * relaxes fewer edges more than once but takes more rounds, each ending
+ * at a barrier. Each thread keeps the buckets just above the frontier's in
+ * a ring and only the later ones that are not empty in a map, so neither
+ * memory nor the search for the next bucket grows with the costs. A thread that throws keeps meeting the others at the barriers
+ * until they all stop, and the first exception is thrown again here.
+ * @param start_node The 1-based start node.
+ * @param delta The width of a bucket of costs, 0 for the average edge weight.
+ * @param threads The number of threads, 0 for one per core.
+ * @return cost[i] is the cost to reach node i + 1, the same as Dijkstra's.
+ */
+std::vector<unsigned> ALGraph::DeltaStepping(unsigned start_node, unsigned delta, unsigned threads) const
+{
+    if (delta == 0)
+    {
+        unsigned long long total = 0;
+        unsigned long long count = 0;
+        for (unsigned i = 0; i < size_; ++i)
+        {
+            const AdjInfo *end = edges_end(i);
+            for (const AdjInfo *it = edges_begin(i); it != end; ++it)
+            {
+                total += it->cost;
+            }
+            count += static_cast<unsigned long long>(end - edges_begin(i));
+        }
+        delta = static_cast<unsigned>(std::max(1ull, count ? total / count : 1));
+    }
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    const std::size_t NO_BUCKET = static_cast<std::size_t>(-1);
+    std::vector<std::atomic<unsigned>> cost(size_);
+    for (std::atomic<unsigned> &node_cost : cost)
+    {
+        node_cost.store(INFINITY_, std::memory_order_relaxed);
+    }
+    cost[start_node - 1].store(0, std::memory_order_relaxed);
+    std::vector<unsigned> frontier(1, start_node - 1); // The nodes of the bucket, with some repeated or moved lower
+    std::size_t frontier_size = 1;
+    std::size_t bucket = 0;                             // The bucket of the frontier
+    std::atomic<std::size_t> next_chunk(0);             // The first frontier node no thread has taken
+    std::atomic<std::size_t> next_bucket(NO_BUCKET);    // The lowest bucket any thread holds nodes in
+    std::atomic<std::size_t> gathered(0);               // The nodes of the next frontier placed so far
+    RoundBarrier barrier(threads);
+
+    std::atomic<bool> failed(false);                    // Set once any thread has thrown
+    std::exception_ptr error;                           // The first exception thrown
+    std::mutex error_lock;                              // Guards error
+    auto fail = [&]()
+    {
+        std::lock_guard<std::mutex> lock(error_lock);
+        if (!error)
+        {
+            error = std::current_exception();
+        }
+        failed.store(true);
+    };
+
+    // Each thread's nodes by bucket: the DELTA_RING buckets from the
+    // frontier's in a ring, and only the later ones that are not empty in
+    // order, so memory does not depend on the costs.
+    std::vector<std::vector<std::vector<unsigned>>> rings(threads, std::vector<std::vector<unsigned>>(DELTA_RING));
+    auto run = [&](unsigned thread)
+    {
+        std::vector<std::vector<unsigned>> &near = rings[thread];
+        std::map<std::size_t, std::vector<unsigned>> far;
+        for (;;)
+        {
+            try
+            {
+                for (std::size_t begin = next_chunk.fetch_add(DELTA_CHUNK); begin < frontier_size;
+                     begin = next_chunk.fetch_add(DELTA_CHUNK))
+                {
+                    std::size_t end = std::min(begin + DELTA_CHUNK, frontier_size);
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        unsigned node = frontier[i];
+                        unsigned node_cost = cost[node].load(std::memory_order_relaxed);
+                        if (node_cost / delta < bucket)
+                        {
+                            continue; // Moved to a lower bucket and relaxed there
+                        }
+                        const AdjInfo *edge_end = edges_end(node);
+                        for (const AdjInfo *it = edges_begin(node); it != edge_end; ++it)
+                        {
+                            unsigned new_cost = node_cost + it->cost;
+                            std::atomic<unsigned> &next_cost = cost[it->des - 1];
+                            unsigned old_cost = next_cost.load(std::memory_order_relaxed);
+                            while (new_cost < old_cost)
+                            {
+                                if (next_cost.compare_exchange_weak(old_cost, new_cost, std::memory_order_relaxed))
+                                {
+                                    std::size_t index = new_cost / delta;
+                                    (index - bucket < DELTA_RING ? near[index % DELTA_RING] : far[index])
+                                        .push_back(it->des - 1);
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            catch (...)
+            {
+                fail(); // Keep meeting the others at the barriers until they all stop
+            }
+            std::size_t index = bucket;
+            while (index - bucket < DELTA_RING && near[index % DELTA_RING].empty())
+            {
+                ++index;
+            }
+            if (index - bucket == DELTA_RING)
+            {
+                index = far.empty() ? NO_BUCKET : far.begin()->first;
+            }
+            if (index != NO_BUCKET)
+            {
+                std::size_t lowest = next_bucket.load();
+                while (index < lowest && !next_bucket.compare_exchange_weak(lowest, index))
+                {
+                }
+            }
+            barrier.wait([&]()
+                         {
+                             bucket = failed.load() ? NO_BUCKET : next_bucket.load();
+                             next_bucket.store(NO_BUCKET);
+                             gathered.store(0);
+                             next_chunk.store(0); });
+            if (bucket == NO_BUCKET)
+            {
+                break;
+            }
+            // Buckets below the frontier's are empty, so the ring slots of
+            // the far buckets that are now near are free.
+            while (!far.empty() && far.begin()->first - bucket < DELTA_RING)
+            {
+                near[far.begin()->first % DELTA_RING].swap(far.begin()->second);
+                far.erase(far.begin());
+            }
+            std::vector<unsigned> &own = near[bucket % DELTA_RING];
+            std::size_t count = own.size();
+            std::size_t offset = gathered.fetch_add(count);
+            barrier.wait([&]()
+                         {
+                             frontier_size = gathered.load();
+                             try
+                             {
+                                 if (frontier.size() < frontier_size)
+                                 {
+                                     frontier.resize(frontier_size);
+                                 }
+                             }
+                             catch (...)
+                             {
+                                 fail();
+                                 frontier_size = 0;
+                             } });
+            if (frontier_size)
+            {
+                std::copy(own.begin(), own.end(), frontier.begin() + static_cast<std::ptrdiff_t>(offset));
+            }
+            own.clear();
+            barrier.wait([]() {});
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+    {
+        workers.emplace_back(run, t);
+    }
+    run(0);
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    std::vector<unsigned> result(size_);
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        result[i] = cost[i].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+/**
+ * @brief Finds the shortest path between two nodes, stopping when the destination is reached.
+ * This is Dijkstra's search until the destination is settled, so the path is
+ * the one Dijkstra gives, and only the nodes closer than the destination are
+ * settled.
+ * @param source The 1-based start node.
+ * @param destination The 1-based end node.
+ * @param settled If not 0, receives the number of nodes taken from the queue.
+ * @return The cost and path Dijkstra gives for destination.
+ */
+DijkstraInfo ALGraph::ShortestPath(unsigned source, unsigned destination, unsigned *settled) const
+{
+    return AStarPath(source, destination, HEURISTIC(), settled);
+}
+/**
+ * @brief Finds the shortest path between two nodes with A* search.
+ * The queue is ordered by cost plus the heuristic's estimate, so the search
+ * heads towards the destination. A node whose cost drops after it has been
+ * taken from the queue goes back in, so an admissible heuristic is enough.
+ * Without a heuristic this is Dijkstra's search.
+ * @param source The 1-based start node.
+ * @param destination The 1-based end node.
+ * @param heuristic An admissible estimate of the cost from a node to destination.
+ * @param settled If not 0, receives the number of nodes taken from the queue.
+ * @return The cost and a shortest path (among equal ones, not always Dijkstra's).
+ */
+DijkstraInfo ALGraph::AStarPath(unsigned source, unsigned destination, const HEURISTIC &heuristic,
+                                unsigned *settled) const
+{
+    SearchSpace &space = ForwardSpace();
+    space.prepare(size_);
+    unsigned count = 0;
+    space.reach(source - 1, 0, 0);
+    space.heap.push(source - 1, heuristic ? heuristic(source, destination) : 0);
+    while (!space.heap.empty())
+    {
+        unsigned current = space.heap.pop();
+        ++count;
+        if (current == destination - 1)
+        {
+            break;
+        }
+        unsigned current_cost = space.cost[current];
+        const AdjInfo *end = edges_end(current);
+        for (const AdjInfo *it = edges_begin(current); it != end; ++it)
+        {
+            if (space.cost[it->des - 1] > it->cost + current_cost)
+            {
+                space.reach(it->des - 1, it->cost + current_cost, current + 1);
+                unsigned estimate = heuristic ? heuristic(it->des, destination) : 0;
+                space.heap.push(it->des - 1, it->cost + current_cost + estimate);
+            }
+        }
+    }
+    if (settled)
+    {
+        *settled = count;
+    }
+
+    DijkstraInfo info;
+    info.cost = space.cost[destination - 1];
+    if (info.cost == NO_COST)
+    {
+        info.cost = INFINITY_;
+        return info;
+    }
+    for (unsigned node = destination; node != 0; node = space.predecessor[node - 1])
+    {
+        info.path.push_back(node);
+    }
+    std::reverse(info.path.begin(), info.path.end());
+    return info;
+}
+/**
+ * @brief Finds the shortest path between two nodes, searching from both ends.
+ * A forward search from the source on the edges out of each node and a
+ * backward search from the destination on the edges into each node take
+ * turns, the one with the lower next cost first. Every edge that reaches a
+ * node the other search has reached gives a path, and the search stops when
+ * the two next costs add up to no less than the best one. The edges into
+ * each node are packed by Freeze, or on a graph that is not frozen by the
+ * first call, and kept until an edge is added.
+ * @param source The 1-based start node.
+ * @param destination The 1-based end node.
+ * @param settled If not 0, receives the number of nodes taken from the queues.
+ * @return The cost and a shortest path (among equal ones, not always Dijkstra's).
+ */
+DijkstraInfo ALGraph::BidirectionalPath(unsigned source, unsigned destination, unsigned *settled) const
+{
+    ensure_reverse();
+    const std::vector<unsigned> &reverse_offsets = reverse_offsets_;
+    const std::vector<AdjInfo> &reverse_edges = reverse_edges_;
+
+    SearchSpace &forward = ForwardSpace();
+    SearchSpace &backward = BackwardSpace();
+    forward.prepare(size_);
+    backward.prepare(size_);
+    forward.reach(source - 1, 0, 0);
+    forward.heap.push(source - 1, 0);
+    backward.reach(destination - 1, 0, 0);
+    backward.heap.push(destination - 1, 0);
+    unsigned long long best = NO_COST;
+    unsigned meet = 0;
+    if (source == destination)
+    {
+        best = 0;
+        meet = source - 1;
+    }
+    unsigned count = 0;
+    while (!forward.heap.empty() && !backward.heap.empty() &&
+           static_cast<unsigned long long>(forward.heap.top_cost()) + backward.heap.top_cost() < best)
+    {
+        bool is_forward = forward.heap.top_cost() <= backward.heap.top_cost();
+        SearchSpace &space = is_forward ? forward : backward;
+        const SearchSpace &other = is_forward ? backward : forward;
+        unsigned current = space.heap.pop();
+        ++count;
+        unsigned current_cost = space.cost[current];
+        const AdjInfo *it = is_forward ? edges_begin(current) : reverse_edges.data() + reverse_offsets[current];
+        const AdjInfo *end = is_forward ? edges_end(current) : reverse_edges.data() + reverse_offsets[current + 1];
+        for (; it != end; ++it)
+        {
+            unsigned next = it->des - 1;
+            if (space.cost[next] > it->cost + current_cost)
+            {
+                space.reach(next, it->cost + current_cost, current + 1);
+                space.heap.push(next, space.cost[next]);
+            }
+            if (other.cost[next] != NO_COST &&
+                static_cast<unsigned long long>(space.cost[next]) + other.cost[next] < best)
+            {
+                best = static_cast<unsigned long long>(space.cost[next]) + other.cost[next];
+                meet = next;
+            }
+        }
+    }
+    if (settled)
+    {
+        *settled = count;
+    }
+
+    DijkstraInfo info;
+    if (best >= NO_COST)
+    {
+        info.cost = INFINITY_;
+        return info;
+    }
+    info.cost = static_cast<unsigned>(best);
+    for (unsigned node = meet + 1; node != 0; node = forward.predecessor[node - 1])
+    {
+        info.path.push_back(node);
+    }
+    std::reverse(info.path.begin(), info.path.end());
+    for (unsigned node = backward.predecessor[meet]; node != 0; node = backward.predecessor[node - 1])
+    {
+        info.path.push_back(node);
+    }
+    return info;
+}
+/**
+ * @brief Runs Dijkstra's algorithm with a given priority queue.
+ * Every queue pops the lowest (cost, node) first, so ties are settled in
+ * the same order and every queue gives the same predecessors.
+ * @param tree The tree to fill from its start. Its vectors are reused.
+ * @param queue An empty queue with push(node, cost), pop() and empty().
+ * @param visited Work space, reused.
+ */
+template <typename Queue>
+void ALGraph::search(DijkstraTree &tree, Queue &queue, std::vector<bool> &visited) const
+{
+    //cost of infinity
+    tree.cost.assign(size_, INFINITY_);
+    tree.predecessor.assign(size_, 0);
+    tree.cost[tree.start - 1] = 0;
+    queue.push(tree.start - 1, 0);
+    //visited nodes
+    visited.assign(size_, false);
+    while (!queue.empty())
+    {
+        unsigned current = queue.pop();
+        if (!visited[current])
+        {
+            visited[current] = true;
+        }
+        else
+        {
+            continue;
+        }
+        //if the cost is less than the current cost
+        //update the cost and predecessor
+        unsigned current_cost = tree.cost[current];
+        const AdjInfo *end = edges_end(current);
+        for (const AdjInfo *it = edges_begin(current); it != end; ++it)
+        {
+            if (tree.cost[it->des - 1] > it->cost + current_cost)
+            {
+                tree.cost[it->des - 1] = it->cost + current_cost;
+                tree.predecessor[it->des - 1] = current + 1;
+                queue.push(it->des - 1, tree.cost[it->des - 1]);
+            }
+        }
+    }
+}
+/**
+ * @brief Calls a function with an empty priority queue of a given type.
+ * A queue is empty again after a search, so the function may reuse it.
+ * @param queue The type of the queue.
+ * @param function Called with the queue.
+ */
+template <typename Function>
+void ALGraph::with_queue(PQType queue, Function function) const
+{
+    if (queue == pqFourAryHeap)
+    {
+        FourAryHeap heap(size_);
+        function(heap);
+    }
+    else if (queue == pqRadixHeap)
+    {
+        RadixHeap heap;
+        function(heap);
+    }
+    else
+    {
+        BinaryHeap heap;
+        function(heap);
+    }
+}
+/**
+ * @brief Builds the tree of each start node on a number of threads.
+ * Threads take the next start node from a shared counter, so a slow search
+ * does not hold up the others. Each thread reuses one tree, one visited
+ * array and one queue for all of the start nodes it takes.
+ * @param sources The 1-based start nodes.
+ * @param threads The number of threads, 0 for one per core.
+ * @param queue The priority queue to search with.
+ * @param sink Called as sink(r, tree) with the tree of sources[r], from any thread.
+ */
+template <typename Sink>
+void ALGraph::for_each_source(const std::vector<unsigned> &sources, unsigned threads, PQType queue, Sink &sink) const
+{
+    std::atomic<std::size_t> next_source(0);
+    auto run = [&]()
+    {
+        with_queue(queue, [&](auto &heap)
+                   {
+                       DijkstraTree tree;
+                       std::vector<bool> visited;
+                       for (std::size_t i = next_source++; i < sources.size(); i = next_source++)
+                       {
+                           tree.start = sources[i];
+                           search(tree, heap, visited);
+                           sink(i, tree);
+                       } });
+    };
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, sources.size())));
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+    {
+        workers.emplace_back(run);
+    }
+    run();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+}
+/**
+ * @brief Follows the predecessors back from a node to the start.
+ * @param node The 1-based node.
+ * @return The nodes from the start to node, or an empty path if node is unreachable.
+ */
+std::vector<unsigned> DijkstraTree::Path(unsigned node) const
+{
+    std::vector<unsigned> path;
+    if (node != start && predecessor[node - 1] == 0)
+    {
+        return path;
+    }
+    unsigned length = 1;
+    for (unsigned i = node; i != start; i = predecessor[i - 1])
+    {
+        ++length;
+    }
+    path.resize(length);
+    for (unsigned i = node; length > 0; i = predecessor[i - 1])
+    {
+        path[--length] = i;
+    }
+    return path;
+}
+/**
+ * @brief Gets the adjacency list representation of the graph.
+ * @return The adjacency list representation.
+ */
+ALIST ALGraph::GetAList(void) const
+{
+    ALIST alist{size_};
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        const AdjInfo *end = edges_end(i);
+        alist[i].reserve(static_cast<std::size_t>(end - edges_begin(i)));
+        for (const AdjInfo *it = edges_begin(i); it != end; ++it)
+        {
+            AdjacencyInfo adjacency_info{it->des, it->cost};
+            alist[i].emplace_back(adjacency_info);
+        }
+    }
+    return alist;
+}
+/**
+ * @brief Packs the adjacency lists into compressed sparse row arrays.
+ * The lists are copied in order into one edge array, with the start of each
+ * vertex's edges in an offset array, and then freed. Traversals then read
+ * every vertex's edges from one block of memory. The edges into each vertex
+ * are packed the same way, for BidirectionalPath.
+ */
+void ALGraph::Freeze(void)
+{
+    if (frozen_)
+    {
+        return;
+    }
+    offsets_.assign(size_ + 1, 0);
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        offsets_[i + 1] = offsets_[i] + static_cast<unsigned>(adj_list_[i].size());
+    }
+    edges_.clear();
+    edges_.reserve(offsets_[size_]);
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        edges_.insert(edges_.end(), adj_list_[i].begin(), adj_list_[i].end());
+    }
+    std::vector<std::vector<AdjInfo>>().swap(adj_list_);
+    frozen_ = true;
+    build_reverse(reverse_offsets_, reverse_edges_);
+    reverse_.ready.store(true);
+}
+/**
+ * @brief Checks whether the graph is packed.
+ * @return True from Freeze until the next added edge, false otherwise.
+ */
+bool ALGraph::IsFrozen(void) const
+{
+    return frozen_;
+}
+/**
+ * @brief Gets the first edge of a vertex.
+ * @param vertex The 0-based vertex.
+ * @return Pointer to the first edge, in adj_list_ or edges_.
+ */
+const ALGraph::AdjInfo *ALGraph::edges_begin(unsigned vertex) const
+{
+    if (frozen_)
+    {
+        return edges_.data() + offsets_[vertex];
+    }
+    return adj_list_[vertex].data();
+}
+/**
+ * @brief Gets the end of the edges of a vertex.
+ * @param vertex The 0-based vertex.
+ * @return Pointer one past the last edge, in adj_list_ or edges_.
+ */
+const ALGraph::AdjInfo *ALGraph::edges_end(unsigned vertex) const
+{
+    if (frozen_)
+    {
+        return edges_.data() + offsets_[vertex + 1];
+    }
+    return adj_list_[vertex].data() + adj_list_[vertex].size();
+}
+/**
+ * @brief Moves the packed edges back into per-vertex lists.
  */
-std::vector<DijkstraInfo> ALGraph::Dijkstra(unsigned start_node) const
+void ALGraph::thaw(void)
 {
-    //cost of infinity
-    std::vector<DijkstraInfo> dijkstra_info(size_);
-    std::priority_queue<AdjInfo, std::vector<AdjInfo>, std::greater<AdjInfo>> pq;
-    AdjInfo adj_info{start_node - 1, 0};
-    pq.emplace(adj_info);
-
+    adj_list_.resize(size_);
     for (unsigned i = 0; i < size_; ++i)
     {
-        dijkstra_info[i].cost = (i == start_node - 1) ? 0 : INFINITY_;
+        adj_list_[i].assign(edges_.begin() + offsets_[i], edges_.begin() + offsets_[i + 1]);
     }
-    //visited nodes
-    std::vector<bool> visited(size_, false);
-    while (!pq.empty())
+    std::vector<unsigned>().swap(offsets_);
+    std::vector<AdjInfo>().swap(edges_);
+    drop_reverse();
+    frozen_ = false;
+}
+/**
+ * @brief Builds the edges into each vertex in compressed sparse row form.
+ * Counts the edges into each vertex, turns the counts into offsets, and
+ * places every edge at its destination's next free slot, so the edges into
+ * a vertex are in order of their source.
+ * @param offsets Receives size + 1 offsets into edges.
+ * @param edges Receives the edges into each vertex, des holding their 1-based source.
+ */
+void ALGraph::build_reverse(std::vector<unsigned> &offsets, std::vector<AdjInfo> &edges) const
+{
+    offsets.assign(size_ + 1, 0);
+    for (unsigned i = 0; i < size_; ++i)
     {
-        
-        AdjInfo current = pq.top();
-        pq.pop();
-        if (!visited[current.des])
-        {
-            visited[current.des] = true;
-        }
-        else
-        {
-            continue;
-        }
-        //if the cost is less than the current cost
-        //update the cost and path
-        for (auto it = adj_list_[current.des].begin(); it != adj_list_[current.des].end(); ++it)
+        const AdjInfo *end = edges_end(i);
+        for (const AdjInfo *it = edges_begin(i); it != end; ++it)
         {
-            if (dijkstra_info[it->des - 1].cost > (it->cost + (dijkstra_info[current.des].cost == INFINITY_ ? 0 : dijkstra_info[current.des].cost)))
-            {
-                dijkstra_info[it->des - 1].cost = it->cost + (dijkstra_info[current.des].cost == INFINITY_ ? 0 : dijkstra_info[current.des].cost);
-                dijkstra_info[it->des - 1].path = dijkstra_info[current.des].path;
-                dijkstra_info[it->des - 1].path.emplace_back(it->des);
-                AdjInfo next{it->des - 1, dijkstra_info[it->des - 1].cost};
-                pq.emplace(next);
-            }
+            ++offsets[it->des];
         }
     }
-    //insert the start node to the path
-    for (auto &d : dijkstra_info)
+    for (unsigned i = 0; i < size_; ++i)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+    edges.resize(offsets[size_]);
+    std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+    for (unsigned i = 0; i < size_; ++i)
     {
-        if (d.cost == INFINITY_)
+        const AdjInfo *end = edges_end(i);
+        for (const AdjInfo *it = edges_begin(i); it != end; ++it)
         {
-            continue;
+            edges[next[it->des - 1]++] = AdjInfo(i + 1, it->cost);
         }
-        d.path.insert(d.path.begin(), start_node);
     }
-    return dijkstra_info;
 }
 /**
- * @brief Gets the adjacency list representation of the graph.
- * @return The adjacency list representation.
+ * @brief Builds reverse_offsets_ and reverse_edges_ unless they are up to date.
+ * The first caller builds them under the lock; the others wait and then
+ * reuse them, as do later calls until an edge is added.
  */
-ALIST ALGraph::GetAList(void) const
+void ALGraph::ensure_reverse(void) const
 {
-    ALIST alist{size_};
-    for (unsigned i = 0; i < size_; ++i)
+    if (reverse_.ready.load(std::memory_order_acquire))
     {
-        for (const AdjInfo &adj_info : adj_list_[i])
-        {
-            AdjacencyInfo adjacency_info{adj_info.des, adj_info.cost};
-            alist[i].emplace_back(adjacency_info);
-        }
+        return;
+    }
+    std::lock_guard<std::mutex> lock(reverse_.lock);
+    if (!reverse_.ready.load(std::memory_order_relaxed))
+    {
+        build_reverse(reverse_offsets_, reverse_edges_);
+        reverse_.ready.store(true, std::memory_order_release);
+    }
+}
+/**
+ * @brief Frees reverse_offsets_ and reverse_edges_, before the edges change.
+ */
+void ALGraph::drop_reverse(void)
+{
+    if (reverse_.ready.load(std::memory_order_relaxed))
+    {
+        std::vector<unsigned>().swap(reverse_offsets_);
+        std::vector<AdjInfo>().swap(reverse_edges_);
+        reverse_.ready.store(false, std::memory_order_relaxed);
     }
-    return alist;
 }
 /**
  * @brief Default constructor.
@@ -186,4 +1562,653 @@ bool ALGraph::AdjInfo::operator>(const AdjInfo &rhs) const
     {
         return false;
     }
-}
\ No newline at end of file
+}
+/*!
+  The graph while a hierarchy is built: the edges and shortcuts between the
+  nodes not contracted yet, with the cheapest one kept between any two
+  nodes. Nodes are taken in order of priority, the shortcuts contracting
+  them would add less the edges it removes, counted twice, plus the
+  neighbours already contracted to spread the contraction evenly over the
+  graph.
+*/
+class ContractionHierarchy::Contractor
+{
+public:
+    /**
+     * @brief Constructor.
+     * @param alist The adjacency lists of the graph.
+     */
+    explicit Contractor(const ALIST &alist)
+        : size_(static_cast<unsigned>(alist.size())), out_(size_), in_(size_), contracted_neighbours_(size_, 0),
+          through_(size_, NO_COST)
+    {
+        for (unsigned node = 0; node < size_; ++node)
+        {
+            for (const AdjacencyInfo &edge : alist[node])
+            {
+                if (edge.id != node + 1)
+                {
+                    add_arc(node, edge.id - 1, edge.weight, 0);
+                }
+            }
+        }
+    }
+    /**
+     * @brief Contracts every node and stores the result in a hierarchy.
+     * A node's priority is recomputed when a neighbour is contracted and
+     * again when it comes out of the queue, and it goes back in if it is
+     * no longer the lowest. Priorities come from short witness searches;
+     * only the node being contracted gets the full ones.
+     * @param hierarchy Receives the order and the arcs.
+     */
+    void run(ContractionHierarchy &hierarchy)
+    {
+        typedef std::pair<int, unsigned> Entry; // (priority, 0-based node)
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        std::vector<int> priorities(size_);
+        for (unsigned node = 0; node < size_; ++node)
+        {
+            priorities[node] = priority(node);
+            queue.emplace(priorities[node], node);
+        }
+        std::vector<bool> contracted(size_, false);
+        std::vector<std::vector<Arc>> up(size_), down(size_);
+        std::vector<unsigned> neighbours;
+        hierarchy.rank_.assign(size_, 0);
+        unsigned rank = 0;
+        while (!queue.empty())
+        {
+            Entry entry = queue.top();
+            queue.pop();
+            unsigned node = entry.second;
+            if (contracted[node] || entry.first != priorities[node])
+            {
+                continue;
+            }
+            priorities[node] = priority(node);
+            if (priorities[node] > entry.first && !queue.empty() && priorities[node] > queue.top().first)
+            {
+                queue.emplace(priorities[node], node);
+                continue;
+            }
+            find_shortcuts(node, WITNESS_SETTLES);
+            contract(node);
+            contracted[node] = true;
+            hierarchy.rank_[node] = rank++;
+            up[node].swap(out_[node]);
+            down[node].swap(in_[node]);
+
+            neighbours.clear();
+            for (const Arc &arc : up[node])
+            {
+                neighbours.push_back(arc.node - 1);
+            }
+            for (const Arc &arc : down[node])
+            {
+                neighbours.push_back(arc.node - 1);
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+            for (unsigned neighbour : neighbours)
+            {
+                ++contracted_neighbours_[neighbour];
+                priorities[neighbour] = priority(neighbour);
+                queue.emplace(priorities[neighbour], neighbour);
+            }
+        }
+        hierarchy.size_ = size_;
+        pack(up, hierarchy.up_offsets_, hierarchy.up_arcs_);
+        pack(down, hierarchy.down_offsets_, hierarchy.down_arcs_);
+    }
+
+private:
+    unsigned size_;
+    std::vector<std::vector<Arc>> out_;           // Arcs out of each node not contracted, to others
+    std::vector<std::vector<Arc>> in_;            // Arcs into each node not contracted, node holding their source
+    std::vector<unsigned> contracted_neighbours_; // Neighbours of each node contracted so far
+    std::vector<EdgeInfo> shortcuts_;             // The shortcuts the last find_shortcuts found
+    std::vector<unsigned> through_;               // During a witness search, the cost through the node to each destination
+    SearchSpace space_;                           // Witness searches
+
+    /**
+     * @brief Finds the shortcuts contracting a node would add.
+     * For each edge into the node, a search from its source, skipping the
+     * node, looks for a path no longer than the one through the node to each
+     * destination of an edge out of it. The search stops once it has found
+     * one for every destination, past the longest path through the node, or
+     * after settles nodes, so a shortcut may be added where a longer search
+     * would have found a path.
+     * @param node The 0-based node.
+     * @param settles The most nodes each search settles.
+     */
+    void find_shortcuts(unsigned node, unsigned settles)
+    {
+        shortcuts_.clear();
+        unsigned longest = 0;
+        for (const Arc &out : out_[node])
+        {
+            longest = std::max(longest, out.cost);
+        }
+        for (const Arc &in : in_[node])
+        {
+            unsigned source = in.node - 1;
+            unsigned limit = in.cost + longest;
+            unsigned missing = 0;
+            for (const Arc &out : out_[node])
+            {
+                if (out.node != in.node)
+                {
+                    through_[out.node - 1] = in.cost + out.cost;
+                    ++missing;
+                }
+            }
+            space_.prepare(size_);
+            space_.reach(source, 0, 0);
+            space_.heap.push(source, 0);
+            for (unsigned settled = 0; settled < settles && missing > 0 && !space_.heap.empty(); ++settled)
+            {
+                unsigned current = space_.heap.pop();
+                unsigned current_cost = space_.cost[current];
+                for (const Arc &arc : out_[current])
+                {
+                    unsigned next = arc.node - 1;
+                    unsigned cost = current_cost + arc.cost;
+                    if (next != node && cost <= limit && cost < space_.cost[next])
+                    {
+                        if (cost <= through_[next] && space_.cost[next] > through_[next])
+                        {
+                            --missing;
+                        }
+                        space_.reach(next, cost, current + 1);
+                        space_.heap.push(next, cost);
+                    }
+                }
+            }
+            for (const Arc &out : out_[node])
+            {
+                through_[out.node - 1] = NO_COST;
+                if (out.node != in.node && space_.cost[out.node - 1] > in.cost + out.cost)
+                {
+                    shortcuts_.push_back(EdgeInfo{in.node, out.node, in.cost + out.cost});
+                }
+            }
+        }
+    }
+    /**
+     * @brief Computes the priority of a node, estimating its shortcuts.
+     * The witness searches settle at most ESTIMATE_SETTLES nodes, so the
+     * shortcuts may be overcounted, but a priority is computed every time a
+     * neighbour is contracted and the full searches would dominate the build.
+     * @param node The 0-based node.
+     * @return Twice the shortcuts less the edges of the node, plus its contracted neighbours.
+     */
+    int priority(unsigned node)
+    {
+        find_shortcuts(node, ESTIMATE_SETTLES);
+        int difference = static_cast<int>(shortcuts_.size()) - static_cast<int>(out_[node].size() + in_[node].size());
+        return 2 * difference + static_cast<int>(contracted_neighbours_[node]);
+    }
+    /**
+     * @brief Adds the shortcuts of a node and removes its edges from its neighbours.
+     * @param node The 0-based node, whose shortcuts find_shortcuts left in shortcuts_.
+     */
+    void contract(unsigned node)
+    {
+        for (const EdgeInfo &shortcut : shortcuts_)
+        {
+            add_arc(shortcut.source - 1, shortcut.destination - 1, shortcut.weight, node + 1);
+        }
+        for (const Arc &out : out_[node])
+        {
+            remove_arc(in_[out.node - 1], node + 1);
+        }
+        for (const Arc &in : in_[node])
+        {
+            remove_arc(out_[in.node - 1], node + 1);
+        }
+    }
+    /**
+     * @brief Adds an edge or shortcut, unless one at least as cheap joins the same nodes.
+     * @param from The 0-based source.
+     * @param to The 0-based destination.
+     * @param cost The cost.
+     * @param middle The 1-based node of a shortcut, 0 for an edge.
+     */
+    void add_arc(unsigned from, unsigned to, unsigned cost, unsigned middle)
+    {
+        for (Arc &out : out_[from])
+        {
+            if (out.node == to + 1)
+            {
+                if (cost < out.cost)
+                {
+                    out.cost = cost;
+                    out.middle = middle;
+                    for (Arc &in : in_[to])
+                    {
+                        if (in.node == from + 1)
+                        {
+                            in.cost = cost;
+                            in.middle = middle;
+                        }
+                    }
+                }
+                return;
+            }
+        }
+        out_[from].push_back(Arc{to + 1, cost, middle});
+        in_[to].push_back(Arc{from + 1, cost, middle});
+    }
+    /**
+     * @brief Removes the arc to or from a node from a list.
+     * @param arcs The list.
+     * @param node The 1-based node.
+     */
+    static void remove_arc(std::vector<Arc> &arcs, unsigned node)
+    {
+        for (std::size_t i = 0; i < arcs.size(); ++i)
+        {
+            if (arcs[i].node == node)
+            {
+                arcs[i] = arcs.back();
+                arcs.pop_back();
+                return;
+            }
+        }
+    }
+    /**
+     * @brief Packs per-node lists into compressed sparse row form, freeing them.
+     * @param lists The lists.
+     * @param offsets Receives size + 1 offsets into arcs.
+     * @param arcs Receives the lists, one after another.
+     */
+    void pack(std::vector<std::vector<Arc>> &lists, std::vector<unsigned> &offsets, std::vector<Arc> &arcs) const
+    {
+        offsets.assign(size_ + 1, 0);
+        for (unsigned node = 0; node < size_; ++node)
+        {
+            offsets[node + 1] = offsets[node] + static_cast<unsigned>(lists[node].size());
+        }
+        arcs.clear();
+        arcs.reserve(offsets[size_]);
+        for (unsigned node = 0; node < size_; ++node)
+        {
+            arcs.insert(arcs.end(), lists[node].begin(), lists[node].end());
+            std::vector<Arc>().swap(lists[node]);
+        }
+    }
+};
+/**
+ * @brief Default constructor, for Load.
+ */
+ContractionHierarchy::ContractionHierarchy(void) : size_(0), up_offsets_(1, 0), down_offsets_(1, 0)
+{
+}
+/**
+ * @brief Builds the hierarchy of a graph.
+ * Contracts the nodes one at a time, cheapest first. Contracting a node adds
+ * a shortcut from each node with an edge into it to each node with an edge
+ * out of it, unless a search finds another path that is no longer. The edges
+ * of a node when it is contracted, shortcuts included, all lead to nodes
+ * contracted later and are kept as its up arcs (out of it) and down arcs
+ * (into it).
+ * @param graph The graph. Later changes to it are not seen.
+ */
+ContractionHierarchy::ContractionHierarchy(const ALGraph &graph) : size_(0)
+{
+    Contractor contractor(graph.GetAList());
+    contractor.run(*this);
+}
+/**
+ * @brief Writes the hierarchy to a file.
+ * The file is a HierarchyHeader followed by the arrays as they are in memory.
+ * @param filename The file.
+ * @return True if the whole hierarchy was written, false otherwise.
+ */
+bool ContractionHierarchy::Save(const char *filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    HierarchyHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, HIERARCHY_MAGIC, sizeof(header.magic));
+    header.version = HIERARCHY_VERSION;
+    header.nodes = size_;
+    header.up_count = static_cast<unsigned>(up_arcs_.size());
+    header.down_count = static_cast<unsigned>(down_arcs_.size());
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(rank_.data()),
+               static_cast<std::streamsize>(rank_.size() * sizeof(unsigned)));
+    file.write(reinterpret_cast<const char *>(up_offsets_.data()),
+               static_cast<std::streamsize>(up_offsets_.size() * sizeof(unsigned)));
+    file.write(reinterpret_cast<const char *>(up_arcs_.data()),
+               static_cast<std::streamsize>(up_arcs_.size() * sizeof(Arc)));
+    file.write(reinterpret_cast<const char *>(down_offsets_.data()),
+               static_cast<std::streamsize>(down_offsets_.size() * sizeof(unsigned)));
+    file.write(reinterpret_cast<const char *>(down_arcs_.data()),
+               static_cast<std::streamsize>(down_arcs_.size() * sizeof(Arc)));
+    file.close();
+    return !file.fail();
+}
+/**
+ * @brief Reads a hierarchy written by Save on a machine of the same byte order.
+ * Reads the whole file, checks that its size matches the header, and checks
+ * the arrays with is_valid before replacing the current hierarchy, so no
+ * file can make Query read outside the arrays.
+ * @param filename The file.
+ * @return True if a valid hierarchy was read, false (keeping the old one) if
+ * the file cannot be read or is not a valid hierarchy.
+ */
+bool ContractionHierarchy::Load(const char *filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+    HierarchyHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, HIERARCHY_MAGIC, sizeof(header.magic)) != 0 || header.version != HIERARCHY_VERSION)
+    {
+        return false;
+    }
+    file.seekg(0, std::ios::end);
+    std::streamoff length = file.tellg();
+    file.seekg(static_cast<std::streamoff>(sizeof(header)), std::ios::beg);
+    unsigned long long nodes = header.nodes;
+    unsigned long long expected = sizeof(header) + (3 * nodes + 2) * sizeof(unsigned) +
+                                  (static_cast<unsigned long long>(header.up_count) + header.down_count) * sizeof(Arc);
+    if (length < 0 || static_cast<unsigned long long>(length) != expected)
+    {
+        return false;
+    }
+
+    ContractionHierarchy loaded;
+    loaded.size_ = header.nodes;
+    loaded.rank_.resize(header.nodes);
+    loaded.up_offsets_.resize(nodes + 1);
+    loaded.up_arcs_.resize(header.up_count);
+    loaded.down_offsets_.resize(nodes + 1);
+    loaded.down_arcs_.resize(header.down_count);
+    file.read(reinterpret_cast<char *>(loaded.rank_.data()),
+              static_cast<std::streamsize>(loaded.rank_.size() * sizeof(unsigned)));
+    file.read(reinterpret_cast<char *>(loaded.up_offsets_.data()),
+              static_cast<std::streamsize>(loaded.up_offsets_.size() * sizeof(unsigned)));
+    file.read(reinterpret_cast<char *>(loaded.up_arcs_.data()),
+              static_cast<std::streamsize>(loaded.up_arcs_.size() * sizeof(Arc)));
+    file.read(reinterpret_cast<char *>(loaded.down_offsets_.data()),
+              static_cast<std::streamsize>(loaded.down_offsets_.size() * sizeof(unsigned)));
+    file.read(reinterpret_cast<char *>(loaded.down_arcs_.data()),
+              static_cast<std::streamsize>(loaded.down_arcs_.size() * sizeof(Arc)));
+    if (!file || !loaded.is_valid())
+    {
+        return false;
+    }
+    std::swap(*this, loaded);
+    return true;
+}
+/**
+ * @brief Finds the shortest path between two nodes.
+ * A forward search from the source on the up arcs and a backward search
+ * from the destination on the down arcs take turns, the one with the lower
+ * next cost first, and each stops once its next cost is no less than the
+ * best path through a node both have reached. Every shortest path has a
+ * highest node that both searches settle at its true cost. A node that
+ * a higher node already reached reaches for less is stalled: its cost is
+ * not its true cost, so its arcs are not followed. The shortcuts of the
+ * path found are then expanded into the edges of the graph.
+ * @param source The 1-based start node.
+ * @param destination The 1-based end node.
+ * @param settled If not 0, receives the number of nodes taken from the queues.
+ * @return The cost and a shortest path of the graph (among equal ones, not always Dijkstra's).
+ */
+DijkstraInfo ContractionHierarchy::Query(unsigned source, unsigned destination, unsigned *settled) const
+{
+    SearchSpace &forward = ForwardSpace();
+    SearchSpace &backward = BackwardSpace();
+    forward.prepare(size_);
+    backward.prepare(size_);
+    forward.reach(source - 1, 0, 0);
+    forward.heap.push(source - 1, 0);
+    backward.reach(destination - 1, 0, 0);
+    backward.heap.push(destination - 1, 0);
+    unsigned long long best = NO_COST;
+    unsigned meet = 0;
+    unsigned count = 0;
+    for (;;)
+    {
+        bool forward_open = !forward.heap.empty() && forward.heap.top_cost() < best;
+        bool backward_open = !backward.heap.empty() && backward.heap.top_cost() < best;
+        if (!forward_open && !backward_open)
+        {
+            break;
+        }
+        bool is_forward = forward_open && (!backward_open || forward.heap.top_cost() <= backward.heap.top_cost());
+        SearchSpace &space = is_forward ? forward : backward;
+        const SearchSpace &other = is_forward ? backward : forward;
+        const std::vector<unsigned> &offsets = is_forward ? up_offsets_ : down_offsets_;
+        const std::vector<Arc> &arcs = is_forward ? up_arcs_ : down_arcs_;
+        const std::vector<unsigned> &stall_offsets = is_forward ? down_offsets_ : up_offsets_;
+        const std::vector<Arc> &stall_arcs = is_forward ? down_arcs_ : up_arcs_;
+        unsigned current = space.heap.pop();
+        ++count;
+        unsigned current_cost = space.cost[current];
+        if (other.cost[current] != NO_COST &&
+            static_cast<unsigned long long>(current_cost) + other.cost[current] < best)
+        {
+            best = static_cast<unsigned long long>(current_cost) + other.cost[current];
+            meet = current;
+        }
+        bool stalled = false;
+        for (unsigned i = stall_offsets[current]; i < stall_offsets[current + 1] && !stalled; ++i)
+        {
+            unsigned higher_cost = space.cost[stall_arcs[i].node - 1];
+            stalled = higher_cost != NO_COST && higher_cost + stall_arcs[i].cost < current_cost;
+        }
+        if (stalled)
+        {
+            continue;
+        }
+        for (unsigned i = offsets[current]; i < offsets[current + 1]; ++i)
+        {
+            unsigned next = arcs[i].node - 1;
+            if (space.cost[next] > current_cost + arcs[i].cost)
+            {
+                space.reach(next, current_cost + arcs[i].cost, current + 1);
+                space.heap.push(next, space.cost[next]);
+            }
+        }
+    }
+    if (settled)
+    {
+        *settled = count;
+    }
+
+    DijkstraInfo info;
+    if (best >= NO_COST)
+    {
+        info.cost = static_cast<unsigned>(-1);
+        return info;
+    }
+    info.cost = static_cast<unsigned>(best);
+    std::vector<unsigned> up_path;
+    for (unsigned node = meet + 1; node != 0; node = forward.predecessor[node - 1])
+    {
+        up_path.push_back(node);
+    }
+    info.path.push_back(source);
+    for (std::size_t i = up_path.size() - 1; i > 0; --i)
+    {
+        unpack(up_path[i], up_path[i - 1], info.path);
+    }
+    for (unsigned node = meet + 1; backward.predecessor[node - 1] != 0; node = backward.predecessor[node - 1])
+    {
+        unpack(node, backward.predecessor[node - 1], info.path);
+    }
+    return info;
+}
+/**
+ * @brief Gets the number of nodes.
+ * @return The size of the graph the hierarchy was built from.
+ */
+unsigned ContractionHierarchy::Size(void) const
+{
+    return size_;
+}
+/**
+ * @brief Gets the number of edges of the hierarchy, shortcuts included.
+ * Each edge is either an up arc of its source or a down arc of its destination.
+ * @return The number of edges.
+ */
+unsigned ContractionHierarchy::EdgeCount(void) const
+{
+    return static_cast<unsigned>(up_arcs_.size() + down_arcs_.size());
+}
+/**
+ * @brief Gets the number of shortcuts.
+ * @return The number of edges that stand for a path of two or more edges.
+ */
+unsigned ContractionHierarchy::ShortcutCount(void) const
+{
+    unsigned count = 0;
+    for (const Arc &arc : up_arcs_)
+    {
+        count += arc.middle != 0;
+    }
+    for (const Arc &arc : down_arcs_)
+    {
+        count += arc.middle != 0;
+    }
+    return count;
+}
+/**
+ * @brief Finds the arc of an edge or shortcut.
+ * It is an up arc of from if to was contracted later, and a down arc of to
+ * otherwise.
+ * @param from The 1-based source.
+ * @param to The 1-based destination.
+ * @return The arc, in up_arcs_ or down_arcs_, or 0 if there is none.
+ */
+const ContractionHierarchy::Arc *ContractionHierarchy::find_arc(unsigned from, unsigned to) const
+{
+    bool up = rank_[to - 1] > rank_[from - 1];
+    const std::vector<unsigned> &offsets = up ? up_offsets_ : down_offsets_;
+    const std::vector<Arc> &arcs = up ? up_arcs_ : down_arcs_;
+    unsigned node = up ? from : to;
+    unsigned other = up ? to : from;
+    for (unsigned i = offsets[node - 1]; i < offsets[node]; ++i)
+    {
+        if (arcs[i].node == other)
+        {
+            return &arcs[i];
+        }
+    }
+    return 0;
+}
+/**
+ * @brief Appends the nodes of the path an edge or shortcut stands for.
+ * A shortcut is replaced by its two halves until only edges are left, on a
+ * stack rather than by recursion, as shortcuts can nest deeply.
+ * @param from The 1-based source, not appended.
+ * @param to The 1-based destination.
+ * @param path Receives the nodes after from, up to to.
+ */
+void ContractionHierarchy::unpack(unsigned from, unsigned to, std::vector<unsigned> &path) const
+{
+    std::vector<std::pair<unsigned, unsigned>> stack(1, std::make_pair(from, to));
+    while (!stack.empty())
+    {
+        std::pair<unsigned, unsigned> part = stack.back();
+        stack.pop_back();
+        unsigned middle = find_arc(part.first, part.second)->middle;
+        if (middle == 0)
+        {
+            path.push_back(part.second);
+        }
+        else
+        {
+            stack.emplace_back(middle, part.second);
+            stack.emplace_back(part.first, middle);
+        }
+    }
+}
+/**
+ * @brief Checks that the arrays read by Load form a hierarchy.
+ * The ranks must be an order of the nodes, the offsets must rise to the
+ * number of arcs, and every arc must join two nodes with its far end higher.
+ * A shortcut's middle must be lower than both of its ends, so expanding it
+ * ends, and its halves must exist and add up to its cost.
+ * @return True if the arrays form a hierarchy, false otherwise.
+ */
+bool ContractionHierarchy::is_valid(void) const
+{
+    std::vector<bool> ranked(size_, false);
+    for (unsigned rank : rank_)
+    {
+        if (rank >= size_ || ranked[rank])
+        {
+            return false;
+        }
+        ranked[rank] = true;
+    }
+    for (int direction = 0; direction < 2; ++direction)
+    {
+        const std::vector<unsigned> &offsets = direction == 0 ? up_offsets_ : down_offsets_;
+        const std::vector<Arc> &arcs = direction == 0 ? up_arcs_ : down_arcs_;
+        if (offsets[0] != 0 || offsets[size_] != arcs.size())
+        {
+            return false;
+        }
+        for (unsigned node = 0; node < size_; ++node)
+        {
+            if (offsets[node] > offsets[node + 1])
+            {
+                return false;
+            }
+        }
+        for (unsigned node = 0; node < size_; ++node)
+        {
+            for (unsigned i = offsets[node]; i < offsets[node + 1]; ++i)
+            {
+                if (arcs[i].node < 1 || arcs[i].node > size_ || rank_[arcs[i].node - 1] <= rank_[node] ||
+                    arcs[i].middle > size_)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    for (int direction = 0; direction < 2; ++direction)
+    {
+        const std::vector<unsigned> &offsets = direction == 0 ? up_offsets_ : down_offsets_;
+        const std::vector<Arc> &arcs = direction == 0 ? up_arcs_ : down_arcs_;
+        for (unsigned node = 0; node < size_; ++node)
+        {
+            for (unsigned i = offsets[node]; i < offsets[node + 1]; ++i)
+            {
+                unsigned middle = arcs[i].middle;
+                if (middle == 0)
+                {
+                    continue;
+                }
+                unsigned from = direction == 0 ? node + 1 : arcs[i].node;
+                unsigned to = direction == 0 ? arcs[i].node : node + 1;
+                if (rank_[middle - 1] >= rank_[node])
+                {
+                    return false;
+                }
+                const Arc *first = find_arc(from, middle);
+                const Arc *second = find_arc(middle, to);
+                if (!first || !second ||
+                    static_cast<unsigned long long>(first->cost) + second->cost != arcs[i].cost)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
@@ -13,6 +13,9 @@
 #define ALGRAPH_H
 //---------------------------------------------------------------------------
 #include <vector>
+#include <functional>
+#include <atomic>
+#include <mutex>
 
 struct DijkstraInfo
 {
@@ -28,9 +31,40 @@ struct AdjacencyInfo
 
 typedef std::vector<std::vector<AdjacencyInfo>> ALIST;
 
+struct DijkstraTree
+{
+  unsigned start;                     // The 1-based start node
+  std::vector<unsigned> cost;         // cost[i] is the cost to reach node i + 1
+  std::vector<unsigned> predecessor;  // The node before node i + 1 on its path, 0 for the start and unreachable nodes
+
+  /**
+   * @brief Follows the predecessors back from a node to the start.
+   * @param node The 1-based node.
+   * @return The nodes from the start to node, or an empty path if node is unreachable.
+   */
+  std::vector<unsigned> Path(unsigned node) const;
+};
+
+struct EdgeInfo
+{
+  unsigned source;
+  unsigned destination;
+  unsigned weight;
+};
+
+  // A* estimate of the cost from a node to the destination (both 1-based).
+  // Never more than the real cost, and the same every time for the same node.
+typedef std::function<unsigned(unsigned node, unsigned destination)> HEURISTIC;
+
 class ALGraph
 {
 public:
+  // The priority queue of a shortest path search. All give the same result.
+  // pqBinaryHeap: std::priority_queue, holding a stale entry per improved cost
+  // pqFourAryHeap: an indexed 4-ary heap with decrease-key, one entry per node
+  // pqRadixHeap: buckets by the highest bit that differs from the last cost
+  enum PQType { pqBinaryHeap, pqFourAryHeap, pqRadixHeap };
+
   /**
    * @brief Constructor.
    * @param size The size of the graph.
@@ -54,17 +88,107 @@ public:
    * @param weight The weight of the edge.
    */
   void AddUEdge(unsigned node1, unsigned node2, unsigned weight);
+  /**
+   * @brief Adds many directed edges, sorting each adjacency list once.
+   * @param edges The edges, with 1-based nodes as in AddDEdge.
+   * @param threads The number of threads sorting the lists, 0 for one per core.
+   */
+  void AddDEdges(const std::vector<EdgeInfo> &edges, unsigned threads = 0);
+  /**
+   * @brief Adds the directed edges listed in a text file.
+   * @param filename A file of "source destination weight" lines.
+   * @param threads The number of threads sorting the lists, 0 for one per core.
+   * @return True if every edge was read and added, false (adding none) otherwise.
+   */
+  bool LoadDEdges(const char *filename, unsigned threads = 0);
   /**
    * @brief Performs Dijkstra's algorithm on the graph.
    * @param start_node The starting node for Dijkstra's algorithm.
+   * @param queue The priority queue to search with.
    * @return A vector containing Dijkstra's algorithm information for each node.
    */
-  std::vector<DijkstraInfo> Dijkstra(unsigned start_node) const;
+  std::vector<DijkstraInfo> Dijkstra(unsigned start_node, PQType queue = pqFourAryHeap) const;
+  /**
+   * @brief Performs Dijkstra's algorithm, keeping only costs and predecessors.
+   * @param start_node The starting node for Dijkstra's algorithm.
+   * @param queue The priority queue to search with.
+   * @return The cost of and predecessor on the path to each node.
+   */
+  DijkstraTree ShortestPathTree(unsigned start_node, PQType queue = pqFourAryHeap) const;
+  /**
+   * @brief Finds the cost from each of many start nodes to every node, in parallel.
+   * @param sources The 1-based start nodes.
+   * @param threads The number of threads, 0 for one per core.
+   * @param queue The priority queue to search with.
+   * @return sources.size() rows of size costs: row r, column i is the cost from sources[r] to node i + 1.
+   */
+  std::vector<unsigned> DistanceMatrix(const std::vector<unsigned> &sources, unsigned threads = 0,
+                                       PQType queue = pqFourAryHeap) const;
+  /**
+   * @brief Builds the shortest path tree of each of many start nodes, in parallel.
+   * @param sources The 1-based start nodes.
+   * @param threads The number of threads, 0 for one per core.
+   * @param queue The priority queue to search with.
+   * @return The tree of sources[r] at index r.
+   */
+  std::vector<DijkstraTree> ShortestPathTrees(const std::vector<unsigned> &sources, unsigned threads = 0,
+                                              PQType queue = pqFourAryHeap) const;
+  /**
+   * @brief Finds the cost between every pair of nodes with the Floyd-Warshall algorithm.
+   * Meant for small, dense graphs. Path costs must be below 2^30 - 1.
+   * @return size rows of size costs: row r, column i is the cost from node r + 1 to node i + 1.
+   */
+  std::vector<unsigned> FloydWarshall(void) const;
+  /**
+   * @brief Finds the cost from a node to every node with delta-stepping, in parallel.
+   * Path costs must be below 2^32 - 1.
+   * @param start_node The 1-based start node.
+   * @param delta The width of a bucket of costs, 0 for the average edge weight.
+   * @param threads The number of threads, 0 for one per core.
+   * @return cost[i] is the cost to reach node i + 1, the same as Dijkstra's.
+   */
+  std::vector<unsigned> DeltaStepping(unsigned start_node, unsigned delta = 0, unsigned threads = 0) const;
+  /**
+   * @brief Finds the shortest path between two nodes, stopping when the destination is reached.
+   * @param source The 1-based start node.
+   * @param destination The 1-based end node.
+   * @param settled If not 0, receives the number of nodes taken from the queue.
+   * @return The cost and path Dijkstra gives for destination.
+   */
+  DijkstraInfo ShortestPath(unsigned source, unsigned destination, unsigned *settled = 0) const;
+  /**
+   * @brief Finds the shortest path between two nodes, searching from both ends.
+   * @param source The 1-based start node.
+   * @param destination The 1-based end node.
+   * @param settled If not 0, receives the number of nodes taken from the queues.
+   * @return The cost and a shortest path (among equal ones, not always Dijkstra's).
+   */
+  DijkstraInfo BidirectionalPath(unsigned source, unsigned destination, unsigned *settled = 0) const;
+  /**
+   * @brief Finds the shortest path between two nodes with A* search.
+   * @param source The 1-based start node.
+   * @param destination The 1-based end node.
+   * @param heuristic An admissible estimate of the cost from a node to destination.
+   * @param settled If not 0, receives the number of nodes taken from the queue.
+   * @return The cost and a shortest path (among equal ones, not always Dijkstra's).
+   */
+  DijkstraInfo AStarPath(unsigned source, unsigned destination, const HEURISTIC &heuristic,
+                         unsigned *settled = 0) const;
   /**
    * @brief Gets the adjacency list representation of the graph.
    * @return The adjacency list representation.
    */
   ALIST GetAList(void) const;
+  /**
+   * @brief Packs the adjacency lists into compressed sparse row arrays.
+   * Adding an edge afterwards unpacks them again.
+   */
+  void Freeze(void);
+  /**
+   * @brief Checks whether the graph is packed.
+   * @return True from Freeze until the next added edge, false otherwise.
+   */
+  bool IsFrozen(void) const;
 
 private:
   // An EXAMPLE of some other classes you may want to create and
@@ -101,7 +225,182 @@ private:
   // Other private fields and methods
   const unsigned INFINITY_ = static_cast<unsigned>(-1);
   unsigned size_;
-  std::vector<std::vector<AdjInfo>> adj_list_;
+  std::vector<std::vector<AdjInfo>> adj_list_; // Empty while frozen
+  bool frozen_;
+  std::vector<unsigned> offsets_; // Frozen: the edges of vertex i are edges_[offsets_[i]] to edges_[offsets_[i + 1] - 1]
+  std::vector<AdjInfo> edges_;    // Frozen: every adjacency list, one after another
+  mutable std::vector<unsigned> reverse_offsets_; // Once built: like offsets_, for the edges into each vertex
+  mutable std::vector<AdjInfo> reverse_edges_;    // Once built: the edges into each vertex, des holding their source
+
+  /*!
+    Guards building the reverse arrays on the first BidirectionalPath. A copy
+    starts unbuilt, so the graph stays copyable.
+  */
+  struct ReverseGuard
+  {
+    std::mutex lock;         // Held while building
+    std::atomic<bool> ready; // reverse_offsets_ and reverse_edges_ match the edges
+
+    ReverseGuard(void) : ready(false) {}
+    ReverseGuard(const ReverseGuard &) : ready(false) {}
+    ReverseGuard &operator=(const ReverseGuard &)
+    {
+      ready.store(false);
+      return *this;
+    }
+  };
+  mutable ReverseGuard reverse_;
+
+  /**
+   * @brief Gets the first edge of a vertex.
+   * @param vertex The 0-based vertex.
+   * @return Pointer to the first edge, in adj_list_ or edges_.
+   */
+  const AdjInfo *edges_begin(unsigned vertex) const;
+  /**
+   * @brief Gets the end of the edges of a vertex.
+   * @param vertex The 0-based vertex.
+   * @return Pointer one past the last edge, in adj_list_ or edges_.
+   */
+  const AdjInfo *edges_end(unsigned vertex) const;
+  /**
+   * @brief Moves the packed edges back into per-vertex lists.
+   */
+  void thaw(void);
+  /**
+   * @brief Builds the edges into each vertex in compressed sparse row form.
+   * @param offsets Receives size + 1 offsets into edges.
+   * @param edges Receives the edges into each vertex, des holding their 1-based source.
+   */
+  void build_reverse(std::vector<unsigned> &offsets, std::vector<AdjInfo> &edges) const;
+  /**
+   * @brief Builds reverse_offsets_ and reverse_edges_ unless they are up to date.
+   * Safe to call from many threads at once.
+   */
+  void ensure_reverse(void) const;
+  /**
+   * @brief Frees reverse_offsets_ and reverse_edges_, before the edges change.
+   */
+  void drop_reverse(void);
+  /**
+   * @brief Runs Dijkstra's algorithm with a given priority queue.
+   * @param tree The tree to fill from its start. Its vectors are reused.
+   * @param queue An empty queue with push(node, cost), pop() and empty().
+   * @param visited Work space, reused.
+   */
+  template <typename Queue>
+  void search(DijkstraTree &tree, Queue &queue, std::vector<bool> &visited) const;
+  /**
+   * @brief Calls a function with an empty priority queue of a given type.
+   * @param queue The type of the queue.
+   * @param function Called with the queue.
+   */
+  template <typename Function>
+  void with_queue(PQType queue, Function function) const;
+  /**
+   * @brief Builds the tree of each start node on a number of threads.
+   * Each thread reuses one tree, one visited array and one queue for all of
+   * the start nodes it takes.
+   * @param sources The 1-based start nodes.
+   * @param threads The number of threads, 0 for one per core.
+   * @param queue The priority queue to search with.
+   * @param sink Called as sink(r, tree) with the tree of sources[r], from any thread.
+   */
+  template <typename Sink>
+  void for_each_source(const std::vector<unsigned> &sources, unsigned threads, PQType queue, Sink &sink) const;
+};
+
+/*!
+  A contraction hierarchy of a graph, for many point-to-point queries on a
+  graph that does not change. Building it contracts the nodes one at a time,
+  adding a shortcut between two neighbours of a node wherever the node was on
+  their only shortest path. A query then only follows edges to nodes
+  contracted later, from both ends.
+*/
+class ContractionHierarchy
+{
+public:
+  /**
+   * @brief Default constructor, for Load.
+   */
+  ContractionHierarchy(void);
+  /**
+   * @brief Builds the hierarchy of a graph.
+   * @param graph The graph. Later changes to it are not seen.
+   */
+  explicit ContractionHierarchy(const ALGraph &graph);
+  /**
+   * @brief Writes the hierarchy to a file.
+   * @param filename The file.
+   * @return True if the whole hierarchy was written, false otherwise.
+   */
+  bool Save(const char *filename) const;
+  /**
+   * @brief Reads a hierarchy written by Save on a machine of the same byte order.
+   * @param filename The file.
+   * @return True if a valid hierarchy was read, false (keeping the old one) otherwise.
+   */
+  bool Load(const char *filename);
+  /**
+   * @brief Finds the shortest path between two nodes.
+   * @param source The 1-based start node.
+   * @param destination The 1-based end node.
+   * @param settled If not 0, receives the number of nodes taken from the queues.
+   * @return The cost and a shortest path of the graph (among equal ones, not always Dijkstra's).
+   */
+  DijkstraInfo Query(unsigned source, unsigned destination, unsigned *settled = 0) const;
+  /**
+   * @brief Gets the number of nodes.
+   * @return The size of the graph the hierarchy was built from.
+   */
+  unsigned Size(void) const;
+  /**
+   * @brief Gets the number of edges of the hierarchy, shortcuts included.
+   * @return The number of edges.
+   */
+  unsigned EdgeCount(void) const;
+  /**
+   * @brief Gets the number of shortcuts.
+   * @return The number of edges that stand for a path of two or more edges.
+   */
+  unsigned ShortcutCount(void) const;
+
+private:
+  struct Arc
+  {
+    unsigned node;   // The 1-based node at the other end
+    unsigned cost;   // The cost of the edge or shortcut
+    unsigned middle; // The 1-based node a shortcut was added for, 0 for an edge of the graph
+  };
+  class Contractor;
+
+  unsigned size_;
+  std::vector<unsigned> rank_;         // The position of node i in the order of contraction
+  std::vector<unsigned> up_offsets_;   // The arcs out of node i are up_arcs_[up_offsets_[i]] onwards
+  std::vector<Arc> up_arcs_;           // Edges to nodes contracted later, by node
+  std::vector<unsigned> down_offsets_; // The arcs into node i are down_arcs_[down_offsets_[i]] onwards
+  std::vector<Arc> down_arcs_;         // Edges from nodes contracted later, node holding their source
+
+  /**
+   * @brief Finds the arc of an edge or shortcut.
+   * @param from The 1-based source.
+   * @param to The 1-based destination.
+   * @return The arc, in up_arcs_ or down_arcs_, or 0 if there is none.
+   */
+  const Arc *find_arc(unsigned from, unsigned to) const;
+  /**
+   * @brief Checks that the arrays read by Load form a hierarchy.
+   * @return True if every arc leads up the order, and every shortcut stands
+   * for two arcs through a node lower than both of its ends.
+   */
+  bool is_valid(void) const;
+  /**
+   * @brief Appends the nodes of the path an edge or shortcut stands for.
+   * @param from The 1-based source, not appended.
+   * @param to The 1-based destination.
+   * @param path Receives the nodes after from, up to to.
+   */
+  void unpack(unsigned from, unsigned to, std::vector<unsigned> &path) const;
 };
 
 #endif
@@ -0,0 +1,803 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <thread>
+
+#include "ALGraph.h"
+
+unsigned gVertices = 1000000; // vertices in the largest graphs
+unsigned gMaxThreads = 0;     // 0 means std::thread::hardware_concurrency()
+
+using std::cout;
+using std::endl;
+
+//*********************************************************************
+// Helpers
+//*********************************************************************
+typedef std::chrono::steady_clock Clock;
+
+double ElapsedMs(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+typedef EdgeInfo Edge;
+
+// 1, 2, 4, ... up to gMaxThreads (or the number of cores)
+std::vector<unsigned> ThreadCounts(void)
+{
+  unsigned max_threads = gMaxThreads;
+  if (max_threads == 0)
+    max_threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<unsigned> counts;
+  for (unsigned n = 1; n < max_threads; n *= 2)
+    counts.push_back(n);
+  counts.push_back(max_threads);
+  return counts;
+}
+
+// A side x side grid of crossings joined to their 4 neighbours in both
+// directions, with weights 10 to 99 like road segments of different
+// lengths. About 4 edges per vertex and paths of O(side) hops.
+std::vector<Edge> MakeGrid(unsigned side, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned> weight(10, 99);
+  std::vector<Edge> edges;
+  edges.reserve(static_cast<size_t>(side) * side * 4);
+  for (unsigned row = 0; row < side; row++)
+  {
+    for (unsigned col = 0; col < side; col++)
+    {
+      unsigned v = row * side + col + 1;
+      if (col + 1 < side)
+      {
+        unsigned w = weight(rng);
+        edges.push_back(Edge{v, v + 1, w});
+        edges.push_back(Edge{v + 1, v, w});
+      }
+      if (row + 1 < side)
+      {
+        unsigned w = weight(rng);
+        edges.push_back(Edge{v, v + side, w});
+        edges.push_back(Edge{v + side, v, w});
+      }
+    }
+  }
+  return edges;
+}
+
+// degree random out-edges per vertex, weights 1 to 100. Paths are
+// O(log vertices) hops.
+std::vector<Edge> MakeRandom(unsigned vertices, unsigned degree, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned> vertex(1, vertices);
+  std::uniform_int_distribution<unsigned> weight(1, 100);
+  std::vector<Edge> edges;
+  edges.reserve(static_cast<size_t>(vertices) * degree);
+  for (unsigned v = 1; v <= vertices; v++)
+    for (unsigned i = 0; i < degree; i++)
+      edges.push_back(Edge{v, vertex(rng), weight(rng)});
+  return edges;
+}
+
+// A side x side grid with a quarter of the streets missing and a fast
+// road (weights 2 to 10) along every 32nd row and column, like a road
+// network of local streets and arterials.
+std::vector<Edge> MakeRoad(unsigned side, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<unsigned> street(10, 99);
+  std::uniform_int_distribution<unsigned> arterial(2, 10);
+  std::uniform_int_distribution<unsigned> percent(0, 99);
+  std::vector<Edge> edges;
+  edges.reserve(static_cast<size_t>(side) * side * 4);
+  for (unsigned row = 0; row < side; row++)
+  {
+    for (unsigned col = 0; col < side; col++)
+    {
+      unsigned v = row * side + col + 1;
+      if (col + 1 < side && (row % 32 == 0 || percent(rng) >= 25))
+      {
+        unsigned w = row % 32 == 0 ? arterial(rng) : street(rng);
+        edges.push_back(Edge{v, v + 1, w});
+        edges.push_back(Edge{v + 1, v, w});
+      }
+      if (row + 1 < side && (col % 32 == 0 || percent(rng) >= 25))
+      {
+        unsigned w = col % 32 == 0 ? arterial(rng) : street(rng);
+        edges.push_back(Edge{v, v + side, w});
+        edges.push_back(Edge{v + side, v, w});
+      }
+    }
+  }
+  return edges;
+}
+
+// vertices / degree vertices with degree out-edges each to random others,
+// like a dense region of a graph. Lists of this length were slow to build
+// when AddDEdge sorted the whole list on every edge.
+std::vector<Edge> MakeDense(unsigned vertices, unsigned degree, unsigned seed)
+{
+  return MakeRandom(std::max(1u, vertices / degree), degree, seed);
+}
+
+// Adds every edge with AddDEdge
+void AddEdges(ALGraph &graph, const std::vector<Edge> &edges)
+{
+  for (size_t i = 0; i < edges.size(); i++)
+    graph.AddDEdge(edges[i].source, edges[i].destination, edges[i].weight);
+}
+
+// Sum of the reachable costs, to compare two runs
+unsigned long long CostSum(const std::vector<DijkstraInfo> &info)
+{
+  unsigned long long sum = 0;
+  for (size_t i = 0; i < info.size(); i++)
+    if (info[i].cost != static_cast<unsigned>(-1))
+      sum += info[i].cost;
+  return sum;
+}
+
+//*********************************************************************
+// Tests
+//*********************************************************************
+
+// Builds a graph, then times GetAList and (if run_dijkstra) Dijkstra from
+// vertex 1 before and after Freeze.
+void FreezeWorkload(const char *label, unsigned vertices, const std::vector<Edge> &edges,
+                    bool run_dijkstra)
+{
+  ALGraph graph(vertices);
+  Clock::time_point start = Clock::now();
+  AddEdges(graph, edges);
+  double build_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  size_t lists = graph.GetAList().size();
+  double alist_ms = ElapsedMs(start);
+
+  double dijkstra_ms = 0;
+  unsigned long long sum = 0;
+  if (run_dijkstra)
+  {
+    start = Clock::now();
+    sum = CostSum(graph.Dijkstra(1));
+    dijkstra_ms = ElapsedMs(start);
+  }
+
+  start = Clock::now();
+  graph.Freeze();
+  double freeze_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  bool ok = graph.GetAList().size() == lists;
+  double frozen_alist_ms = ElapsedMs(start);
+
+  double frozen_dijkstra_ms = 0;
+  if (run_dijkstra)
+  {
+    start = Clock::now();
+    ok = ok && CostSum(graph.Dijkstra(1)) == sum;
+    frozen_dijkstra_ms = ElapsedMs(start);
+  }
+
+  cout << std::left << std::setw(26) << label << std::right
+       << std::setw(10) << build_ms
+       << std::setw(9) << freeze_ms
+       << std::setw(10) << alist_ms
+       << std::setw(10) << frozen_alist_ms;
+  if (run_dijkstra)
+    cout << std::setw(10) << dijkstra_ms << std::setw(10) << frozen_dijkstra_ms;
+  else
+    cout << std::setw(10) << "-" << std::setw(10) << "-";
+  cout << (ok ? "" : "  WRONG") << endl;
+}
+
+void TestFreeze(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices)));
+  unsigned small_side = side / 4;
+  cout << "\n========== Adjacency lists vs Freeze (up to " << gVertices << " vertices) ==========\n";
+  cout << "Times in ms, before Freeze and then 'frozen'. Dijkstra runs from vertex 1.\n"
+          "It is skipped on the large grid: its paths are O(side) hops and one path\n"
+          "vector per vertex would not fit in memory.\n";
+
+  cout << std::fixed << std::setprecision(1);
+  cout << std::left << std::setw(26) << "graph" << std::right
+       << std::setw(10) << "build" << std::setw(9) << "freeze"
+       << std::setw(10) << "GetAList" << std::setw(10) << "frozen"
+       << std::setw(10) << "Dijkstra" << std::setw(10) << "frozen" << endl;
+
+  char label[64];
+  std::sprintf(label, "grid %ux%u", side, side);
+  FreezeWorkload(label, side * side, MakeGrid(side, 1), false);
+  std::sprintf(label, "grid %ux%u", small_side, small_side);
+  FreezeWorkload(label, small_side * small_side, MakeGrid(small_side, 2), true);
+  std::sprintf(label, "random %u, degree 4", gVertices);
+  FreezeWorkload(label, gVertices, MakeRandom(gVertices, 4, 3), true);
+}
+
+// Loads the edges of a graph one way and prints the time and a checksum of
+// the lists. mode 0: AddDEdge per edge, 1: AddDEdges, 2: LoadDEdges from a file.
+void LoadWorkload(const char *label, int mode, unsigned threads, unsigned vertices,
+                  const std::vector<Edge> &edges, const char *path)
+{
+  ALGraph graph(vertices);
+  Clock::time_point start = Clock::now();
+  bool ok = true;
+  if (mode == 0)
+    AddEdges(graph, edges);
+  else if (mode == 1)
+    graph.AddDEdges(edges, threads);
+  else
+    ok = graph.LoadDEdges(path, threads);
+  double load_ms = ElapsedMs(start);
+
+  unsigned long long checksum = 0;
+  ALIST alist = graph.GetAList();
+  for (size_t i = 0; i < alist.size(); i++)
+    for (size_t j = 0; j < alist[i].size(); j++)
+      checksum = checksum * 31 + alist[i][j].id * 101 + alist[i][j].weight;
+
+  cout << std::left << std::setw(26) << label << std::right
+       << std::setw(10) << load_ms
+       << std::setw(10) << load_ms * 1e6 / static_cast<double>(edges.size())
+       << std::setw(22) << checksum
+       << (ok ? "" : "  FAILED") << endl;
+}
+
+// Times every way of loading one graph. The edges are shuffled, as in a
+// file that is not grouped by source.
+void LoadGraph(const char *name, unsigned vertices, std::vector<Edge> edges)
+{
+  std::shuffle(edges.begin(), edges.end(), std::mt19937(4));
+  const char *path = "driver-bench.edges";
+  std::FILE *file = std::fopen(path, "w");
+  for (size_t i = 0; file && i < edges.size(); i++)
+    std::fprintf(file, "%u %u %u\n", edges[i].source, edges[i].destination, edges[i].weight);
+  if (file)
+    std::fclose(file);
+
+  cout << name << ", " << edges.size() << " edges\n";
+  LoadWorkload("  AddDEdge", 0, 0, vertices, edges, path);
+  std::vector<unsigned> counts = ThreadCounts();
+  char label[64];
+  for (size_t i = 0; i < counts.size(); i++)
+  {
+    std::sprintf(label, "  AddDEdges, %u thread%s", counts[i], counts[i] == 1 ? "" : "s");
+    LoadWorkload(label, 1, counts[i], vertices, edges, path);
+  }
+  LoadWorkload("  LoadDEdges", 2, 0, vertices, edges, path);
+  std::remove(path);
+}
+
+void TestBulkLoad(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices)));
+  cout << "\n========== Loading edges (up to " << gVertices << " vertices) ==========\n";
+  cout << "Total in ms, then ns per edge. LoadDEdges includes reading the text file.\n"
+          "Equal checksums mean equal adjacency lists.\n";
+
+  cout << std::fixed << std::setprecision(1);
+  cout << std::left << std::setw(26) << "load" << std::right
+       << std::setw(10) << "total" << std::setw(10) << "per edge"
+       << std::setw(22) << "checksum" << endl;
+
+  char name[64];
+  std::sprintf(name, "grid %ux%u", side, side);
+  LoadGraph(name, side * side, MakeGrid(side, 1));
+  std::sprintf(name, "random %u, degree 4", gVertices);
+  LoadGraph(name, gVertices, MakeRandom(gVertices, 4, 3));
+  std::sprintf(name, "dense %u, degree 1000", std::max(1u, gVertices / 1000));
+  LoadGraph(name, std::max(1u, gVertices / 1000), MakeDense(gVertices, 1000, 5));
+}
+
+// Times Dijkstra (if run_dijkstra) and ShortestPathTree from vertex 1 on a
+// frozen graph, and the path to the last vertex from the tree.
+void PathTreeWorkload(const char *label, unsigned vertices, const std::vector<Edge> &edges,
+                      bool run_dijkstra)
+{
+  ALGraph graph(vertices);
+  graph.AddDEdges(edges);
+  graph.Freeze();
+
+  double dijkstra_ms = 0;
+  unsigned long long sum = 0;
+  if (run_dijkstra)
+  {
+    Clock::time_point start = Clock::now();
+    sum = CostSum(graph.Dijkstra(1));
+    dijkstra_ms = ElapsedMs(start);
+  }
+
+  Clock::time_point start = Clock::now();
+  DijkstraTree tree = graph.ShortestPathTree(1);
+  double tree_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  size_t hops = tree.Path(vertices).size();
+  double path_ms = ElapsedMs(start);
+
+  unsigned long long tree_sum = 0;
+  for (size_t i = 0; i < tree.cost.size(); i++)
+    if (tree.cost[i] != static_cast<unsigned>(-1))
+      tree_sum += tree.cost[i];
+  bool ok = !run_dijkstra || sum == tree_sum;
+
+  cout << std::left << std::setw(26) << label << std::right;
+  if (run_dijkstra)
+    cout << std::setw(10) << dijkstra_ms;
+  else
+    cout << std::setw(10) << "-";
+  cout << std::setw(10) << tree_ms
+       << std::setw(10) << path_ms * 1000.0
+       << std::setw(8) << hops
+       << (ok ? "" : "  WRONG") << endl;
+}
+
+void TestPathTree(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices)));
+  unsigned small_side = side / 4;
+  cout << "\n========== Dijkstra vs ShortestPathTree (up to " << gVertices << " vertices) ==========\n";
+  cout << "Times in ms from vertex 1 on frozen graphs, then the path to the last vertex in us.\n"
+          "Dijkstra builds every path. It is skipped on the large grid, where they would not fit.\n";
+
+  cout << std::fixed << std::setprecision(1);
+  cout << std::left << std::setw(26) << "graph" << std::right
+       << std::setw(10) << "Dijkstra" << std::setw(10) << "tree"
+       << std::setw(10) << "Path" << std::setw(8) << "hops" << endl;
+
+  char label[64];
+  std::sprintf(label, "grid %ux%u", side, side);
+  PathTreeWorkload(label, side * side, MakeGrid(side, 1), false);
+  std::sprintf(label, "grid %ux%u", small_side, small_side);
+  PathTreeWorkload(label, small_side * small_side, MakeGrid(small_side, 2), true);
+  std::sprintf(label, "random %u, degree 4", gVertices);
+  PathTreeWorkload(label, gVertices, MakeRandom(gVertices, 4, 3), true);
+}
+
+// Times ShortestPathTree from a few start vertices with each queue on one
+// frozen graph, and checks that every queue gives the same tree.
+void QueueWorkload(const char *label, unsigned vertices, const std::vector<Edge> &edges)
+{
+  ALGraph graph(vertices);
+  graph.AddDEdges(edges);
+  graph.Freeze();
+
+  const unsigned starts = 3;
+  ALGraph::PQType queues[] = {ALGraph::pqBinaryHeap, ALGraph::pqFourAryHeap, ALGraph::pqRadixHeap};
+  double ms[3];
+  unsigned long long checksum[3];
+  for (unsigned q = 0; q < 3; q++)
+  {
+    checksum[q] = 0;
+    Clock::time_point start = Clock::now();
+    for (unsigned s = 0; s < starts; s++)
+    {
+      DijkstraTree tree = graph.ShortestPathTree(1 + s * (vertices / starts), queues[q]);
+      for (unsigned i = 0; i < vertices; i++)
+        checksum[q] = checksum[q] * 31 + tree.cost[i] * 7 + tree.predecessor[i];
+    }
+    ms[q] = ElapsedMs(start) / starts;
+  }
+  bool ok = checksum[0] == checksum[1] && checksum[0] == checksum[2];
+
+  cout << std::left << std::setw(26) << label << std::right
+       << std::setw(10) << edges.size()
+       << std::setw(10) << ms[0]
+       << std::setw(10) << ms[1]
+       << std::setw(10) << ms[2]
+       << (ok ? "" : "  DIFFERENT") << endl;
+}
+
+void TestQueues(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices)));
+  cout << "\n========== Dijkstra priority queues (up to " << gVertices << " vertices) ==========\n";
+  cout << "ms per ShortestPathTree on frozen graphs, averaged over 3 start vertices.\n"
+          "binary: std::priority_queue, 4-ary: indexed with decrease-key, radix: radix heap.\n";
+
+  cout << std::fixed << std::setprecision(1);
+  cout << std::left << std::setw(26) << "graph" << std::right
+       << std::setw(10) << "edges" << std::setw(10) << "binary"
+       << std::setw(10) << "4-ary" << std::setw(10) << "radix" << endl;
+
+  char label[64];
+  std::sprintf(label, "grid %ux%u", side, side);
+  QueueWorkload(label, side * side, MakeGrid(side, 1));
+  std::sprintf(label, "road %ux%u", side, side);
+  QueueWorkload(label, side * side, MakeRoad(side, 6));
+  std::sprintf(label, "random %u, degree 4", gVertices);
+  QueueWorkload(label, gVertices, MakeRandom(gVertices, 4, 3));
+  std::sprintf(label, "random %u, degree 16", gVertices / 4);
+  QueueWorkload(label, gVertices / 4, MakeRandom(gVertices / 4, 16, 7));
+}
+
+// Costs from count sources spread over a graph, by a loop of
+// ShortestPathTree and by DistanceMatrix on 1 to N threads.
+void SourcesWorkload(const char *label, unsigned vertices, const std::vector<Edge> &edges, unsigned count)
+{
+  ALGraph graph(vertices);
+  graph.AddDEdges(edges);
+  graph.Freeze();
+  std::vector<unsigned> sources(count);
+  for (unsigned i = 0; i < count; i++)
+    sources[i] = 1 + static_cast<unsigned>(static_cast<unsigned long long>(i) * vertices / count);
+
+  cout << label << ", " << count << " sources\n";
+  Clock::time_point start = Clock::now();
+  std::vector<unsigned> loop(static_cast<size_t>(count) * vertices);
+  for (unsigned i = 0; i < count; i++)
+  {
+    DijkstraTree tree = graph.ShortestPathTree(sources[i]);
+    std::copy(tree.cost.begin(), tree.cost.end(), loop.begin() + static_cast<std::ptrdiff_t>(i) * vertices);
+  }
+  double loop_ms = ElapsedMs(start);
+  cout << std::left << std::setw(28) << "  ShortestPathTree loop" << std::right
+       << std::setw(10) << loop_ms << std::setw(10) << loop_ms / count << endl;
+
+  std::vector<unsigned> counts = ThreadCounts();
+  char name[64];
+  for (size_t t = 0; t < counts.size(); t++)
+  {
+    start = Clock::now();
+    bool ok = graph.DistanceMatrix(sources, counts[t]) == loop;
+    double ms = ElapsedMs(start);
+    std::sprintf(name, "  DistanceMatrix, %u thread%s", counts[t], counts[t] == 1 ? "" : "s");
+    cout << std::left << std::setw(28) << name << std::right
+         << std::setw(10) << ms << std::setw(10) << ms / count
+         << (ok ? "" : "  WRONG") << endl;
+  }
+}
+
+// All pairs of a dense graph, by DistanceMatrix from every vertex and by
+// FloydWarshall.
+void AllPairsWorkload(unsigned vertices, unsigned degree)
+{
+  ALGraph graph(vertices);
+  graph.AddDEdges(MakeRandom(vertices, degree, 8));
+  graph.Freeze();
+  std::vector<unsigned> sources(vertices);
+  for (unsigned i = 0; i < vertices; i++)
+    sources[i] = i + 1;
+
+  Clock::time_point start = Clock::now();
+  std::vector<unsigned> matrix = graph.DistanceMatrix(sources);
+  double dijkstra_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  bool ok = graph.FloydWarshall() == matrix;
+  double floyd_ms = ElapsedMs(start);
+
+  char label[64];
+  std::sprintf(label, "all pairs %u, degree %u", vertices, degree);
+  cout << std::left << std::setw(28) << label << std::right
+       << std::setw(12) << dijkstra_ms << std::setw(14) << floyd_ms
+       << (ok ? "" : "  WRONG") << endl;
+}
+
+void TestManySources(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices))) / 4;
+  cout << "\n========== Many sources (" << side * side << " vertices) and all pairs ==========\n";
+  cout << "Total ms, then ms per source. DistanceMatrix runs the sources on a number of\n"
+          "threads, each reusing its own workspace. Every result is checked against the loop.\n";
+  cout << std::fixed << std::setprecision(1);
+
+  char label[64];
+  std::sprintf(label, "road %ux%u", side, side);
+  SourcesWorkload(label, side * side, MakeRoad(side, 6), 128);
+  std::sprintf(label, "random %u, degree 4", side * side);
+  SourcesWorkload(label, side * side, MakeRandom(side * side, 4, 3), 128);
+
+  cout << "\nms for every pair of a dense graph: DistanceMatrix from every vertex (one per\n"
+          "core) vs FloydWarshall (one thread, 64x64 blocks, SSE2 when available).\n";
+  cout << std::left << std::setw(28) << "graph" << std::right
+       << std::setw(12) << "Dijkstra" << std::setw(14) << "FloydWarshall" << endl;
+  AllPairsWorkload(256, 64);
+  AllPairsWorkload(1024, 256);
+}
+
+// Point-to-point queries on a frozen side x side grid graph, by a full
+// ShortestPathTree, ShortestPath, BidirectionalPath and AStarPath with
+// min_weight times the Manhattan distance as the heuristic. Destinations
+// are anywhere (radius 0) or within radius rows and columns of the source.
+void PointToPointWorkload(const char *label, unsigned side, const ALGraph &graph, unsigned min_weight,
+                          unsigned radius, unsigned queries)
+{
+  unsigned vertices = side * side;
+  std::mt19937 rng(9);
+  std::uniform_int_distribution<unsigned> coordinate(0, side - 1);
+  std::uniform_int_distribution<unsigned> offset(0, 2 * radius);
+  std::vector<unsigned> from(queries), to(queries);
+  for (unsigned q = 0; q < queries; q++)
+  {
+    unsigned row = coordinate(rng), col = coordinate(rng);
+    from[q] = row * side + col + 1;
+    if (radius)
+    {
+      row += offset(rng);
+      col += offset(rng);
+      row = std::min(side - 1, row >= radius ? row - radius : 0);
+      col = std::min(side - 1, col >= radius ? col - radius : 0);
+    }
+    else
+    {
+      row = coordinate(rng);
+      col = coordinate(rng);
+    }
+    to[q] = row * side + col + 1;
+  }
+  HEURISTIC manhattan = [side, min_weight](unsigned node, unsigned destination)
+  {
+    unsigned row = (node - 1) / side, col = (node - 1) % side;
+    unsigned to_row = (destination - 1) / side, to_col = (destination - 1) % side;
+    unsigned rows = row > to_row ? row - to_row : to_row - row;
+    unsigned cols = col > to_col ? col - to_col : to_col - col;
+    return (rows + cols) * min_weight;
+  };
+
+  std::vector<unsigned> costs(queries);
+  const unsigned tree_queries = 3;
+  Clock::time_point start = Clock::now();
+  for (unsigned q = 0; q < tree_queries; q++)
+    costs[q] = graph.ShortestPathTree(from[q]).cost[to[q] - 1];
+  double tree_ms = ElapsedMs(start) / tree_queries;
+
+  cout << label << endl;
+  cout << std::left << std::setw(26) << "  ShortestPathTree" << std::right
+       << std::setw(10) << tree_ms << std::setw(10) << 100.0 << endl;
+
+  const char *names[] = {"  ShortestPath", "  BidirectionalPath", "  AStarPath"};
+  for (int method = 0; method < 3; method++)
+  {
+    unsigned long long settled = 0;
+    bool ok = true;
+    start = Clock::now();
+    for (unsigned q = 0; q < queries; q++)
+    {
+      unsigned count = 0;
+      DijkstraInfo info;
+      if (method == 0)
+        info = graph.ShortestPath(from[q], to[q], &count);
+      else if (method == 1)
+        info = graph.BidirectionalPath(from[q], to[q], &count);
+      else
+        info = graph.AStarPath(from[q], to[q], manhattan, &count);
+      settled += count;
+      if (method == 0 && q >= tree_queries)
+        costs[q] = info.cost;
+      ok = ok && info.cost == costs[q];
+    }
+    double ms = ElapsedMs(start) / queries;
+    cout << std::left << std::setw(26) << names[method] << std::right
+         << std::setw(10) << ms
+         << std::setw(10) << 100.0 * static_cast<double>(settled) / queries / vertices
+         << (ok ? "" : "  WRONG") << endl;
+  }
+}
+
+void TestPointToPoint(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices)));
+  cout << "\n========== Point-to-point queries (" << side * side << " vertices) ==========\n";
+  cout << "ms per query on frozen graphs, and the share of vertices taken from the queue.\n"
+          "Grid weights are 10-99; road weights are 2-10 on every 32nd row and column and\n"
+          "10-99 elsewhere. A* estimates the smallest weight times the grid distance.\n";
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(26) << "query" << std::right
+       << std::setw(10) << "ms" << std::setw(10) << "settled%" << endl;
+
+  for (int family = 0; family < 2; family++)
+  {
+    ALGraph graph(side * side);
+    graph.AddDEdges(family == 0 ? MakeGrid(side, 1) : MakeRoad(side, 6));
+    graph.Freeze();
+    const char *name = family == 0 ? "grid" : "road";
+    unsigned min_weight = family == 0 ? 10 : 2;
+    char label[64];
+    std::sprintf(label, "%s %ux%u, random pairs", name, side, side);
+    PointToPointWorkload(label, side, graph, min_weight, 0, 20);
+    std::sprintf(label, "%s %ux%u, pairs within 32", name, side, side);
+    PointToPointWorkload(label, side, graph, min_weight, 32, 200);
+  }
+}
+
+// Builds the contraction hierarchy of a frozen graph, saves and loads it,
+// and times queries between random pairs by ShortestPath, BidirectionalPath
+// and the loaded hierarchy, checking every cost against ShortestPath.
+void HierarchyWorkload(const char *label, unsigned vertices, const std::vector<Edge> &edges, unsigned queries)
+{
+  ALGraph graph(vertices);
+  graph.AddDEdges(edges);
+  graph.Freeze();
+  Clock::time_point start = Clock::now();
+  ContractionHierarchy built(graph);
+  double build_ms = ElapsedMs(start);
+
+  const char *path = "driver-bench.ch";
+  start = Clock::now();
+  bool ok = built.Save(path);
+  double save_ms = ElapsedMs(start);
+  ContractionHierarchy hierarchy;
+  start = Clock::now();
+  ok = hierarchy.Load(path) && ok;
+  double load_ms = ElapsedMs(start);
+  long bytes = 0;
+  std::FILE *file = std::fopen(path, "rb");
+  if (file && std::fseek(file, 0, SEEK_END) == 0)
+    bytes = std::ftell(file);
+  if (file)
+    std::fclose(file);
+  std::remove(path);
+
+  cout << label << endl;
+  cout << "  build " << build_ms / 1000 << " s: " << hierarchy.EdgeCount() - hierarchy.ShortcutCount()
+       << " edges + " << hierarchy.ShortcutCount() << " shortcuts (graph has " << edges.size() << " edges)\n";
+  cout << "  Save " << save_ms << " ms, Load " << load_ms << " ms, "
+       << static_cast<double>(bytes) / (1 << 20) << " MB" << (ok ? "" : "  FAILED") << endl;
+
+  std::mt19937 rng(9);
+  std::uniform_int_distribution<unsigned> vertex(1, vertices);
+  std::vector<unsigned> from(queries), to(queries), costs(queries);
+  for (unsigned q = 0; q < queries; q++)
+  {
+    from[q] = vertex(rng);
+    to[q] = vertex(rng);
+  }
+  const char *names[] = {"  ShortestPath", "  BidirectionalPath", "  ContractionHierarchy"};
+  double ms[3];
+  for (int method = 0; method < 3; method++)
+  {
+    unsigned long long settled = 0;
+    ok = true;
+    start = Clock::now();
+    for (unsigned q = 0; q < queries; q++)
+    {
+      unsigned count = 0;
+      DijkstraInfo info;
+      if (method == 0)
+        info = graph.ShortestPath(from[q], to[q], &count);
+      else if (method == 1)
+        info = graph.BidirectionalPath(from[q], to[q], &count);
+      else
+        info = hierarchy.Query(from[q], to[q], &count);
+      settled += count;
+      if (method == 0)
+        costs[q] = info.cost;
+      ok = ok && info.cost == costs[q];
+    }
+    ms[method] = ElapsedMs(start) / queries;
+    cout << std::left << std::setw(26) << names[method] << std::right
+         << std::setw(10) << ms[method]
+         << std::setw(10) << settled / queries
+         << (ok ? "" : "  WRONG") << endl;
+  }
+  cout << "  the build pays for itself after " << static_cast<unsigned long long>(build_ms / (ms[1] - ms[2]) + 1)
+       << " queries against BidirectionalPath" << endl;
+}
+
+void TestHierarchy(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices))) / 4;
+  cout << "\n========== Contraction hierarchy (" << side * side << " vertices) ==========\n";
+  cout << "Build, Save and Load times, then ms per query between random pairs and the\n"
+          "vertices taken from the queues. Queries use the hierarchy read back by Load.\n";
+  cout << std::fixed << std::setprecision(3);
+  cout << std::left << std::setw(26) << "query" << std::right
+       << std::setw(10) << "ms" << std::setw(10) << "settled" << endl;
+
+  char label[64];
+  std::sprintf(label, "road %ux%u", side, side);
+  HierarchyWorkload(label, side * side, MakeRoad(side, 6), 200);
+  std::sprintf(label, "grid %ux%u", side, side);
+  HierarchyWorkload(label, side * side, MakeGrid(side, 1), 200);
+}
+
+// Times DeltaStepping from one vertex against ShortestPathTree, for bucket
+// widths of a quarter, one and four times the average weight, on 1 to N
+// threads. Every result is checked against the tree's costs.
+void DeltaWorkload(const char *label, unsigned vertices, const std::vector<Edge> &edges)
+{
+  ALGraph graph(vertices);
+  graph.AddDEdges(edges);
+  graph.Freeze();
+  unsigned long long total = 0;
+  for (size_t i = 0; i < edges.size(); i++)
+    total += edges[i].weight;
+  unsigned average = static_cast<unsigned>(std::max<unsigned long long>(1, total / edges.size()));
+
+  Clock::time_point start = Clock::now();
+  DijkstraTree tree = graph.ShortestPathTree(1);
+  double tree_ms = ElapsedMs(start);
+  cout << label << endl;
+  cout << std::left << std::setw(30) << "  ShortestPathTree" << std::right
+       << std::setw(10) << tree_ms << std::setw(10) << 1.0 << endl;
+
+  unsigned deltas[] = {std::max(1u, average / 4), average, average * 4};
+  std::vector<unsigned> counts = ThreadCounts();
+  char name[64];
+  for (size_t d = 0; d < 3; d++)
+  {
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+      start = Clock::now();
+      std::vector<unsigned> cost = graph.DeltaStepping(1, deltas[d], counts[i]);
+      double ms = ElapsedMs(start);
+      std::sprintf(name, "  delta %u, %u thread%s", deltas[d], counts[i], counts[i] == 1 ? "" : "s");
+      cout << std::left << std::setw(30) << name << std::right
+           << std::setw(10) << ms << std::setw(10) << tree_ms / ms
+           << (cost == tree.cost ? "" : "  WRONG") << endl;
+    }
+  }
+}
+
+void TestDeltaStepping(void)
+{
+  unsigned side = static_cast<unsigned>(std::sqrt(static_cast<double>(gVertices)));
+  cout << "\n========== Delta-stepping (up to " << gVertices << " vertices) ==========\n";
+  cout << "ms for the cost of every vertex from vertex 1, and the speedup over\n"
+          "ShortestPathTree (one thread, 4-ary heap). delta is the bucket width.\n";
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(30) << "search" << std::right
+       << std::setw(10) << "ms" << std::setw(10) << "speedup" << endl;
+
+  char label[64];
+  std::sprintf(label, "random %u, degree 4", gVertices);
+  DeltaWorkload(label, gVertices, MakeRandom(gVertices, 4, 3));
+  std::sprintf(label, "grid %ux%u", side, side);
+  DeltaWorkload(label, side * side, MakeGrid(side, 1));
+}
+
+//*********************************************************************
+//*********************************************************************
+typedef void (*TestFn)(void);
+
+int main(int argc, char **argv)
+{
+    // Test number
+  int test_num = 0;
+  if (argc > 1)
+    test_num = std::atoi(argv[1]);
+
+    // Number of vertices
+  if (argc > 2)
+    gVertices = static_cast<unsigned>(std::atoi(argv[2]));
+
+    // Maximum number of threads
+  if (argc > 3)
+    gMaxThreads = static_cast<unsigned>(std::atoi(argv[3]));
+
+  TestFn Tests[] = {
+                    TestFreeze,      // 1 adjacency lists vs compressed sparse row arrays
+                    TestBulkLoad,    // 2 AddDEdge per edge vs AddDEdges on 1 to N threads vs LoadDEdges
+                    TestPathTree,    // 3 Dijkstra with every path vs costs and predecessors only
+                    TestQueues,      // 4 binary heap vs indexed 4-ary heap vs radix heap
+                    TestManySources, // 5 many sources on 1 to N threads, Dijkstra vs Floyd-Warshall
+                    TestPointToPoint,// 6 full tree vs early exit vs bidirectional vs A*
+                    TestHierarchy,   // 7 contraction hierarchy build, Save/Load and queries
+                    TestDeltaStepping,// 8 Dijkstra vs delta-stepping on 1 to N threads
+                   };
+
+  int num = sizeof(Tests) / sizeof(*Tests);
+  if (test_num == 0)
+  {
+    for (int i = 0; i < num; i++)
+      Tests[i]();
+  }
+  else if (test_num > 0 && test_num <= num)
+  {
+    Tests[test_num - 1]();
+  }
+
+  return 0;
+}
@@ -0,0 +1,371 @@
+/*!
+@file ChHashMap.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the definition of the ChHashMap class.
+*/
+#include "ChHashMap.h"
+/**
+ * @brief Constructor for ChHashMap class.
+ *
+ * Constructs a ChHashMap object with the given configuration, allocator and
+ * hash function object.
+ *
+ * @param Config The configuration for the hash table.
+ * @param allocator An optional allocator for the nodes.
+ * @param hasher The hash function object.
+ */
+template <typename K, typename T, typename Hasher>
+ChHashMap<K, T, Hasher>::ChHashMap(const HTConfig &Config, ObjectAllocator *allocator, const Hasher &hasher)
+    : config_(Config), allocator_(allocator), hasher_(hasher)
+{
+    table_ = new ChHMHeadNode[config_.InitialTableSize_];
+    stats_ = new HTStats();
+    stats_->TableSize_ = config_.InitialTableSize_;
+    stats_->Allocator_ = allocator;
+}
+/**
+ * @brief Destructor for ChHashMap class.
+ *
+ * Destructs the ChHashMap object and frees allocated memory.
+ */
+template <typename K, typename T, typename Hasher>
+ChHashMap<K, T, Hasher>::~ChHashMap()
+{
+    clear();
+    delete[] table_;
+    delete stats_;
+}
+/**
+ * @brief Inserts an element into the hash table.
+ *
+ * Grows the table first if the insertion would pass the maximum load
+ * factor, then inserts at the head of the key's list.
+ *
+ * @param Key The key associated with the data to be inserted.
+ * @param Data The data to be inserted into the hash table.
+ * @throws HashTableException if the insertion fails due to a duplicate key or memory allocation failure.
+ */
+template <typename K, typename T, typename Hasher>
+void ChHashMap<K, T, Hasher>::insert(const K &Key, const T &Data)
+{
+    double loadFactor = static_cast<double>((stats_->Count_ + 1)) / static_cast<double>(stats_->TableSize_);
+    if (loadFactor > config_.MaxLoadFactor_)
+    {
+        grow_table();
+    }
+    unsigned keyHash = hash(Key);
+    ChHMHeadNode *head = &table_[keyHash % stats_->TableSize_];
+    stats_->Probes_++;
+    for (ChHMNode *node = head->Nodes; node; node = node->Next)
+    {
+        stats_->Probes_++;
+        if (node->Hash == keyHash)
+        {
+            stats_->KeyCompares_++;
+            if (Traits::equal(node->Key, Key))
+            {
+                throw HashTableException(HashTableException::E_DUPLICATE, "Duplicate key");
+            }
+        }
+    }
+    ChHMNode *newNode = new_node(Data);
+    try
+    {
+        Traits::store(newNode->Key, Key, arena_);
+    }
+    catch (const std::bad_alloc &e)
+    {
+        release_node(newNode);
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    newNode->Hash = keyHash;
+    newNode->Next = head->Nodes;
+    head->Nodes = newNode;
+    head->Count++;
+    stats_->Count_++;
+}
+/**
+ * @brief Removes an element from the hash table.
+ *
+ * Removes the element with the specified key from the hash table, then
+ * compacts the key arena if enough of it is dead.
+ *
+ * @param Key The key of the element to be removed.
+ */
+template <typename K, typename T, typename Hasher>
+void ChHashMap<K, T, Hasher>::remove(const K &Key)
+{
+    unsigned keyHash = hash(Key);
+    ChHMHeadNode *head = &table_[keyHash % stats_->TableSize_];
+    ChHMNode *prev = nullptr;
+    for (ChHMNode *node = head->Nodes; node; prev = node, node = node->Next)
+    {
+        stats_->Probes_++;
+        if (node->Hash == keyHash)
+        {
+            stats_->KeyCompares_++;
+            if (Traits::equal(node->Key, Key))
+            {
+                if (prev)
+                {
+                    prev->Next = node->Next;
+                }
+                else
+                {
+                    head->Nodes = node->Next;
+                }
+                arena_.release(Traits::arena_bytes(node->Key));
+                delete_node(node);
+                head->Count--;
+                stats_->Count_--;
+                compact_arena();
+                return;
+            }
+        }
+    }
+}
+/**
+ * @brief Finds an element in the hash table.
+ *
+ * Finds and returns the element with the specified key from the hash table.
+ *
+ * @param Key The key of the element to be found.
+ * @return The reference to the found element.
+ * @throws HashTableException if the element with the specified key is not found.
+ */
+template <typename K, typename T, typename Hasher>
+const T &ChHashMap<K, T, Hasher>::find(const K &Key) const
+{
+    unsigned keyHash = hash(Key);
+    for (ChHMNode *node = table_[keyHash % stats_->TableSize_].Nodes; node; node = node->Next)
+    {
+        stats_->Probes_++;
+        if (node->Hash == keyHash)
+        {
+            stats_->KeyCompares_++;
+            if (Traits::equal(node->Key, Key))
+            {
+                return node->Data;
+            }
+        }
+    }
+    throw HashTableException(HashTableException::E_ITEM_NOT_FOUND, "Item not found");
+}
+/**
+ * @brief Clears the hash table.
+ *
+ * Removes all elements from the hash table and frees the bytes of long keys.
+ */
+template <typename K, typename T, typename Hasher>
+void ChHashMap<K, T, Hasher>::clear()
+{
+    for (unsigned i = 0; i < stats_->TableSize_; i++)
+    {
+        ChHMNode *node = table_[i].Nodes;
+        while (node)
+        {
+            ChHMNode *temp = node->Next;
+            delete_node(node);
+            node = temp;
+        }
+        table_[i].Nodes = nullptr;
+        table_[i].Count = 0;
+    }
+    arena_.clear();
+    stats_->Count_ = 0;
+}
+/**
+ * @brief Gets the statistics of the hash table.
+ *
+ * Returns the statistics of the hash table. There is no HASHFUNC, so
+ * HashFunc_ is 0.
+ *
+ * @return The statistics of the hash table.
+ */
+template <typename K, typename T, typename Hasher>
+HTStats ChHashMap<K, T, Hasher>::GetStats() const
+{
+    return *stats_;
+}
+/**
+ * @brief Gets the table of the hash table.
+ *
+ * Returns the underlying table of the hash table.
+ *
+ * @return The table of the hash table.
+ */
+template <typename K, typename T, typename Hasher>
+const typename ChHashMap<K, T, Hasher>::ChHMHeadNode *ChHashMap<K, T, Hasher>::GetTable() const
+{
+    return table_;
+}
+/**
+ * @brief Returns the bytes used by the table.
+ *
+ * Counts the lists, one node per item and the chunks of the key arena.
+ *
+ * @return The bytes used by the lists, the nodes and the key arena.
+ */
+template <typename K, typename T, typename Hasher>
+std::size_t ChHashMap<K, T, Hasher>::memory() const
+{
+    return stats_->TableSize_ * sizeof(ChHMHeadNode) + stats_->Count_ * sizeof(ChHMNode) + arena_.reserved();
+}
+/**
+ * @brief Hashes a key.
+ *
+ * Calls the hasher and folds a 64-bit result into 32 bits, so no bits of
+ * the hash are simply dropped.
+ *
+ * @param Key The key.
+ * @return The hash of the key.
+ */
+template <typename K, typename T, typename Hasher>
+unsigned ChHashMap<K, T, Hasher>::hash(const K &Key) const
+{
+    unsigned long long value = static_cast<unsigned long long>(hasher_(Key));
+    return static_cast<unsigned>(value ^ (value >> 32));
+}
+/**
+ * @brief Creates a new node with the given data.
+ *
+ * Creates a new node with the specified data.
+ *
+ * @param Data The data to be stored in the new node.
+ * @return Pointer to the newly created node.
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename K, typename T, typename Hasher>
+typename ChHashMap<K, T, Hasher>::ChHMNode *ChHashMap<K, T, Hasher>::new_node(const T &Data)
+{
+    try
+    {
+        if (allocator_)
+        {
+            return new (allocator_->Allocate()) ChHMNode(Data);
+        }
+        else
+        {
+            return new ChHMNode(Data);
+        }
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+}
+/**
+ * @brief Deletes the specified node.
+ *
+ * Calls the free proc on its data and frees the node.
+ *
+ * @param node Pointer to the node to be deleted.
+ */
+template <typename K, typename T, typename Hasher>
+void ChHashMap<K, T, Hasher>::delete_node(ChHMNode *node)
+{
+    if (config_.FreeProc_)
+    {
+        config_.FreeProc_(node->Data);
+    }
+    release_node(node);
+}
+/**
+ * @brief Frees a node without calling the free proc.
+ *
+ * Used for nodes whose data the table never owned.
+ *
+ * @param node Pointer to the node to be freed.
+ */
+template <typename K, typename T, typename Hasher>
+void ChHashMap<K, T, Hasher>::release_node(ChHMNode *node)
+{
+    if (allocator_)
+    {
+        node->~ChHMNode();
+        allocator_->Free(node);
+    }
+    else
+    {
+        delete node;
+    }
+}
+/**
+ * @brief Grows the hash table.
+ *
+ * Allocates a table GrowthFactor_ times larger (rounded to a prime) and
+ * relinks every node by its stored hash, so no key is hashed again.
+ *
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename K, typename T, typename Hasher>
+void ChHashMap<K, T, Hasher>::grow_table()
+{
+    unsigned oldSize = stats_->TableSize_;
+    unsigned newSize = GetClosestPrime(static_cast<unsigned>(std::ceil(oldSize * config_.GrowthFactor_)));
+    ChHMHeadNode *newTable;
+    try
+    {
+        newTable = new ChHMHeadNode[newSize];
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    for (unsigned i = 0; i < oldSize; i++)
+    {
+        ChHMNode *node = table_[i].Nodes;
+        while (node)
+        {
+            stats_->Probes_++;
+            ChHMNode *temp = node->Next;
+            ChHMHeadNode *head = &newTable[node->Hash % newSize];
+            node->Next = head->Nodes;
+            head->Nodes = node;
+            head->Count++;
+            node = temp;
+        }
+    }
+    delete[] table_;
+    table_ = newTable;
+    stats_->TableSize_ = newSize;
+    stats_->Expansions_++;
+}
+/**
+ * @brief Copies the live long keys into a fresh arena.
+ *
+ * Runs once the arena spans more than two chunks and less than half of it
+ * is still used. The fresh arena reserves every live byte up front, so
+ * either every key moves or, if that allocation fails, none does and the
+ * old arena is kept.
+ */
+template <typename K, typename T, typename Hasher>
+void ChHashMap<K, T, Hasher>::compact_arena()
+{
+    if (arena_.reserved() <= 2 * KeyArena::CHUNK_SIZE || arena_.used() >= arena_.reserved() / 2)
+    {
+        return;
+    }
+    KeyArena fresh;
+    try
+    {
+        fresh.reserve(arena_.used());
+    }
+    catch (const std::bad_alloc &e)
+    {
+        return;
+    }
+    for (unsigned i = 0; i < stats_->TableSize_; i++)
+    {
+        for (ChHMNode *node = table_[i].Nodes; node; node = node->Next)
+        {
+            Traits::move(node->Key, fresh);
+        }
+    }
+    arena_.swap(fresh);
+}
@@ -0,0 +1,327 @@
+/*!
+@file ChHashMap.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the declaration of the ChHashMap class, a chained
+       hash table with any key type and a hasher functor.
+*/
+//---------------------------------------------------------------------------
+#ifndef CHHASHMAPH
+#define CHHASHMAPH
+//---------------------------------------------------------------------------
+
+#include "ChHashTable.h" // HTStats, HashTableException, GetClosestPrime
+#include "KeyArena.h"
+#include <cstddef>       // std::size_t
+#include <cstring>       // std::memcmp, std::memcpy
+#include <functional>    // std::hash
+#include <string>        // std::string
+
+/*!
+  How ChHashMap stores keys of type K in its nodes.
+
+  By default the key is stored as it is, so a node holds exactly sizeof(K)
+  bytes of key. K must be copyable and comparable with ==.
+*/
+template <typename K>
+struct ChKeyTraits
+{
+  typedef K Stored; //!< What a node holds
+
+  /**
+   * @brief Stores a key in a node.
+   *
+   * @param stored Receives the key.
+   * @param key The key.
+   * @param arena Unused.
+   */
+  static void store(Stored &stored, const K &key, KeyArena &arena)
+  {
+    (void)arena;
+    stored = key;
+  }
+  /**
+   * @brief Compares a stored key with a key.
+   *
+   * @param stored The stored key.
+   * @param key The key.
+   * @return true if they are equal.
+   */
+  static bool equal(const Stored &stored, const K &key)
+  {
+    return stored == key;
+  }
+  /**
+   * @brief Returns the arena bytes a stored key holds.
+   *
+   * @param stored The stored key.
+   * @return 0; the key lives in the node.
+   */
+  static std::size_t arena_bytes(const Stored &stored)
+  {
+    (void)stored;
+    return 0;
+  }
+  /**
+   * @brief Copies the arena bytes of a stored key into another arena.
+   *
+   * @param stored The stored key.
+   * @param arena Unused.
+   */
+  static void move(Stored &stored, KeyArena &arena)
+  {
+    (void)stored;
+    (void)arena;
+  }
+};
+
+/*!
+  A string key as held in a node: its length, then either the bytes
+  themselves (up to INLINE_SIZE) or a pointer to them in the table's arena.
+*/
+struct ChStringKey
+{
+  //! Longest key kept inside the node
+  static const unsigned INLINE_SIZE = 12;
+
+  unsigned length;         //!< Length of the key in bytes
+  char bytes[INLINE_SIZE]; //!< The key, or a const char* to it if longer
+
+  /**
+   * @brief Returns the bytes of the key.
+   *
+   * @return The key's bytes (not null-terminated).
+   */
+  const char *data() const
+  {
+    if (length <= INLINE_SIZE)
+    {
+      return bytes;
+    }
+    const char *text;
+    std::memcpy(&text, bytes, sizeof(text));
+    return text;
+  }
+};
+
+/*!
+  std::string keys: short keys are stored inline in the node and longer ones
+  are copied once into the table's KeyArena.
+*/
+template <>
+struct ChKeyTraits<std::string>
+{
+  typedef ChStringKey Stored; //!< What a node holds
+
+  /**
+   * @brief Stores a key in a node.
+   *
+   * @param stored Receives the key.
+   * @param key The key.
+   * @param arena Receives the bytes of a key longer than INLINE_SIZE.
+   */
+  static void store(Stored &stored, const std::string &key, KeyArena &arena)
+  {
+    stored.length = static_cast<unsigned>(key.size());
+    if (key.size() <= ChStringKey::INLINE_SIZE)
+    {
+      std::memcpy(stored.bytes, key.data(), key.size());
+    }
+    else
+    {
+      const char *text = arena.allocate(key.size());
+      std::memcpy(const_cast<char *>(text), key.data(), key.size());
+      std::memcpy(stored.bytes, &text, sizeof(text));
+    }
+  }
+  /**
+   * @brief Compares a stored key with a key.
+   *
+   * @param stored The stored key.
+   * @param key The key.
+   * @return true if they are equal.
+   */
+  static bool equal(const Stored &stored, const std::string &key)
+  {
+    return stored.length == key.size() && std::memcmp(stored.data(), key.data(), key.size()) == 0;
+  }
+  /**
+   * @brief Returns the arena bytes a stored key holds.
+   *
+   * @param stored The stored key.
+   * @return The key's length if it is kept in the arena, 0 otherwise.
+   */
+  static std::size_t arena_bytes(const Stored &stored)
+  {
+    return stored.length > ChStringKey::INLINE_SIZE ? stored.length : 0;
+  }
+  /**
+   * @brief Copies the arena bytes of a stored key into another arena.
+   *
+   * @param stored The stored key, repointed at its copy.
+   * @param arena The arena receiving the bytes.
+   */
+  static void move(Stored &stored, KeyArena &arena)
+  {
+    if (stored.length > ChStringKey::INLINE_SIZE)
+    {
+      char *text = arena.allocate(stored.length);
+      std::memcpy(text, stored.data(), stored.length);
+      std::memcpy(stored.bytes, &text, sizeof(text));
+    }
+  }
+};
+
+/*!
+  A chained hash table from keys of type K to data of type T.
+
+  It works like ChHashTable (grow before inserting, insert at the head of the
+  list, same probe counting) but the key type is a template parameter,
+  hashed by a Hasher functor, and stored in the node through ChKeyTraits, so
+  keys are never truncated and a node is only as big as its key needs. Each
+  node keeps its key's hash, which is compared before the key and reused
+  when the table grows.
+
+  Removing a long string key leaves its bytes dead in the arena. Once more
+  than half of the arena is dead, the live keys are copied into a fresh
+  arena and the old one is freed, so churn does not grow it without bound.
+*/
+template <typename K, typename T, typename Hasher = std::hash<K> >
+class ChHashMap
+{
+  public:
+
+    typedef void (*FREEPROC)(T); // client-provided free proc (we own the data)
+    typedef ChKeyTraits<K> Traits;
+
+    struct HTConfig
+    {
+        HTConfig(unsigned InitialTableSize,
+                 double MaxLoadFactor = 3.0,
+                 double GrowthFactor = 2.0,
+                 FREEPROC FreeProc = 0) :
+
+        // The number of slots in the table initially.
+        InitialTableSize_(InitialTableSize),
+        // The maximum "fullness" of the table.
+        MaxLoadFactor_(MaxLoadFactor),
+        // The factor by which the table grows.
+        GrowthFactor_(GrowthFactor),
+        // The method provided by the client that may need to be called when
+        // data in the table is removed.
+        FreeProc_(FreeProc) {}
+
+      unsigned InitialTableSize_;
+      double MaxLoadFactor_;
+      double GrowthFactor_;
+      FREEPROC FreeProc_;
+    };
+
+      // Nodes that will hold the key/data pairs
+    struct ChHMNode
+    {
+      ChHMNode *Next;
+      unsigned Hash;                // Hash of Key
+      typename Traits::Stored Key;  // The key
+      T Data;                       // Client data
+      ChHMNode(const T& data) : Data(data) {}; // constructor
+    };
+
+      // Each list has a special head pointer
+    struct ChHMHeadNode
+    {
+      ChHMNode *Nodes;
+      ChHMHeadNode() : Nodes(0), Count(0) {};
+      int Count; // For testing
+    };
+
+      // ObjectAllocator: the usual (sized for ChHMNode).
+      // Config: the configuration for the hash table.
+      // hasher: the hash function object.
+    ChHashMap(const HTConfig& Config, ObjectAllocator* allocator = 0, const Hasher &hasher = Hasher());
+    ~ChHashMap();
+
+      // Insert a key/data pair into table. Throws an exception if the
+      // insertion is unsuccessful.(E_DUPLICATE, E_NO_MEMORY)
+    void insert(const K &Key, const T& Data);
+
+      // Delete an item by key. Does nothing if the key doesn't exist.
+    void remove(const K &Key);
+
+      // Find and return data by key. throws exception if key doesn't exist.
+      // (E_ITEM_NOT_FOUND)
+    const T& find(const K &Key) const;
+
+      // Removes all items from the table (Doesn't deallocate table)
+    void clear();
+
+      // Returns the statistics of the table. HashFunc_ is always 0.
+    HTStats GetStats() const;
+    const ChHMHeadNode *GetTable() const;
+
+      // Returns the bytes used by the lists, the nodes and the key arena.
+    std::size_t memory() const;
+
+  private:
+
+    ChHMHeadNode *table_;        // The table
+    HTStats *stats_;             // Stats
+    HTConfig config_;            // Config
+    ObjectAllocator *allocator_; // Allocator
+    Hasher hasher_;              // Hash function
+    KeyArena arena_;             // Bytes of long keys
+
+    ChHashMap(const ChHashMap &) = delete;
+    ChHashMap &operator=(const ChHashMap &) = delete;
+
+    /**
+     * @brief Hashes a key.
+     *
+     * @param Key The key.
+     * @return The hasher's result folded to 32 bits.
+     */
+    unsigned hash(const K &Key) const;
+    /**
+     * @brief Creates a new node with the given data.
+     *
+     * @param Data The data to be stored in the new node.
+     * @return Pointer to the newly created node.
+     * @throws HashTableException if memory allocation fails.
+     */
+    ChHMNode *new_node(const T& Data);
+    /**
+     * @brief Deletes the specified node.
+     *
+     * @param node Pointer to the node to be deleted.
+     */
+    void delete_node(ChHMNode *node);
+    /**
+     * @brief Frees a node without calling the free proc.
+     *
+     * @param node Pointer to the node to be freed.
+     */
+    void release_node(ChHMNode *node);
+    /**
+     * @brief Grows the hash table.
+     *
+     * Relinks every node into a larger table by its stored hash.
+     *
+     * @throws HashTableException if memory allocation fails.
+     */
+    void grow_table();
+    /**
+     * @brief Copies the live long keys into a fresh arena.
+     *
+     * Does nothing unless more than half of the arena is dead, or if the
+     * fresh arena cannot be allocated.
+     */
+    void compact_arena();
+};
+
+#include "ChHashMap.cpp"
+
+#endif
@@ -0,0 +1,390 @@
+/*!
+@file ChHashSnapshot.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the definition of the ChHashSnapshot class.
+*/
+#include "ChHashSnapshot.h"
+#include <cstdio>     // std::fopen, std::fwrite, std::fclose
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX      // this file is included by clients, keep std::min and std::max usable
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>    // open
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#include <unistd.h>   // close
+#endif
+/**
+ * @brief Writes a table to a file as an image.
+ *
+ * Builds the whole image in memory and writes it at once. Items are grouped
+ * by bucket with a counting sort: the first pass counts the items of each
+ * bucket, and the second places each item at the end of its bucket's range
+ * and moves that end down, which leaves every offset at the start of its
+ * bucket.
+ *
+ * @param table The table. Its hash function must match HashId.
+ * @param Path The file to write.
+ * @param HashId The client's id for the table's hash function.
+ * @throws SnapshotException if the file cannot be written (E_FILE) or the
+ *         table is still moving lists after an incremental growth (E_GROWING;
+ *         reserve finishes it).
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename T>
+void ChHashSnapshot<T>::write(const ChHashTable<T> &table, const char *Path, unsigned HashId)
+{
+    typedef typename ChHashTable<T>::ChHTHeadNode HeadNode;
+    typedef typename ChHashTable<T>::ChHTNode Node;
+
+    HTStats stats = table.GetStats();
+    const HeadNode *lists = table.GetTable();
+    unsigned count = 0;
+    for (unsigned i = 0; i < stats.TableSize_; i++)
+    {
+        for (const Node *node = lists[i].Nodes; node; node = node->Next)
+        {
+            count++;
+        }
+    }
+    if (count != stats.Count_)
+    {
+        throw SnapshotException(SnapshotException::E_GROWING, "Table is growing");
+    }
+    unsigned buckets = 1;
+    while (buckets < count)
+    {
+        buckets *= 2;
+    }
+    std::size_t bucketsOffset = sizeof(ChHSHeader);
+    std::size_t entriesOffset = bucketsOffset + (buckets + 1) * sizeof(unsigned);
+    entriesOffset = (entriesOffset + alignof(Entry) - 1) / alignof(Entry) * alignof(Entry);
+    std::size_t imageSize = entriesOffset + count * sizeof(Entry);
+
+    char *image;
+    unsigned *hashes;
+    try
+    {
+        image = new char[imageSize]();
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    try
+    {
+        hashes = new unsigned[count];
+    }
+    catch (const std::bad_alloc &e)
+    {
+        delete[] image;
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+
+    ChHSHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.Magic, "CHHSNAP", 8);
+    header.Version = VERSION;
+    header.HashId = HashId;
+    header.EntrySize = sizeof(Entry);
+    header.DataSize = sizeof(T);
+    header.BucketCount = buckets;
+    header.Count = count;
+    header.BucketsOffset = bucketsOffset;
+    header.EntriesOffset = entriesOffset;
+    header.ImageSize = imageSize;
+    std::memcpy(image, &header, sizeof(header));
+
+    unsigned *offsets = reinterpret_cast<unsigned *>(image + bucketsOffset);
+    unsigned item = 0;
+    for (unsigned i = 0; i < stats.TableSize_; i++)
+    {
+        for (const Node *node = lists[i].Nodes; node; node = node->Next)
+        {
+            hashes[item] = stats.HashFunc_(node->Key, FULL_HASH_RANGE);
+            offsets[bucket_of(hashes[item], buckets)]++;
+            item++;
+        }
+    }
+    for (unsigned b = 1; b < buckets; b++)
+    {
+        offsets[b] += offsets[b - 1];
+    }
+    offsets[buckets] = count;
+    item = 0;
+    for (unsigned i = 0; i < stats.TableSize_; i++)
+    {
+        for (const Node *node = lists[i].Nodes; node; node = node->Next)
+        {
+            Entry entry;
+            std::memset(&entry, 0, sizeof(entry));
+            entry.Hash = hashes[item];
+            strncpy(entry.Key, node->Key, MAX_KEYLEN);
+            std::memcpy(&entry.Data, &node->Data, sizeof(T));
+            unsigned position = --offsets[bucket_of(hashes[item], buckets)];
+            std::memcpy(image + entriesOffset + position * sizeof(Entry), &entry, sizeof(entry));
+            item++;
+        }
+    }
+    delete[] hashes;
+
+    std::FILE *file = std::fopen(Path, "wb");
+    bool written = file && std::fwrite(image, 1, imageSize, file) == imageSize;
+    if (file && std::fclose(file) != 0)
+    {
+        written = false;
+    }
+    delete[] image;
+    if (!written)
+    {
+        throw SnapshotException(SnapshotException::E_FILE, std::string("Cannot write ") + Path);
+    }
+}
+/**
+ * @brief Constructor for ChHashSnapshot class.
+ *
+ * Maps the file read-only and checks that it is an image this build can
+ * read, written with the same hash function.
+ *
+ * @param Path The file to map.
+ * @param HashFunc The hash function the image was written with.
+ * @param HashId The client's id for HashFunc.
+ * @throws SnapshotException if the file cannot be mapped (E_FILE), is not a
+ *         valid image for T (E_FORMAT) or has another hash id (E_HASH).
+ */
+template <typename T>
+ChHashSnapshot<T>::ChHashSnapshot(const char *Path, HASHFUNC HashFunc, unsigned HashId)
+    : image_(0), size_(0), header_(0), buckets_(0), entries_(0), hash_(HashFunc), probes_(0), compares_(0)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw SnapshotException(SnapshotException::E_FILE, std::string("Cannot open ") + Path);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+        CloseHandle(file);
+        throw SnapshotException(SnapshotException::E_FILE, std::string("Cannot stat ") + Path);
+    }
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size_ < sizeof(ChHSHeader))
+    {
+        CloseHandle(file);
+        throw SnapshotException(SnapshotException::E_FORMAT, "Not a snapshot");
+    }
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    // The view keeps the mapping alive after its handle is closed
+    void *image = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (mapping)
+    {
+        CloseHandle(mapping);
+    }
+    if (image == NULL)
+    {
+        throw SnapshotException(SnapshotException::E_FILE, std::string("Cannot map ") + Path);
+    }
+#else
+    int fd = open(Path, O_RDONLY);
+    if (fd < 0)
+    {
+        throw SnapshotException(SnapshotException::E_FILE, std::string("Cannot open ") + Path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        throw SnapshotException(SnapshotException::E_FILE, std::string("Cannot stat ") + Path);
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    if (size_ < sizeof(ChHSHeader))
+    {
+        close(fd);
+        throw SnapshotException(SnapshotException::E_FORMAT, "Not a snapshot");
+    }
+    void *image = mmap(0, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED)
+    {
+        throw SnapshotException(SnapshotException::E_FILE, std::string("Cannot map ") + Path);
+    }
+#endif
+    image_ = static_cast<const char *>(image);
+    header_ = reinterpret_cast<const ChHSHeader *>(image_);
+    try
+    {
+        validate(HashId);
+    }
+    catch (...)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(image);
+#else
+        munmap(image, size_);
+#endif
+        throw;
+    }
+    buckets_ = reinterpret_cast<const unsigned *>(image_ + header_->BucketsOffset);
+    entries_ = reinterpret_cast<const Entry *>(image_ + header_->EntriesOffset);
+}
+/**
+ * @brief Destructor for ChHashSnapshot class.
+ *
+ * Unmaps the image.
+ */
+template <typename T>
+ChHashSnapshot<T>::~ChHashSnapshot()
+{
+#ifdef _WIN32
+    UnmapViewOfFile(image_);
+#else
+    munmap(const_cast<char *>(image_), size_);
+#endif
+}
+/**
+ * @brief Finds an element in the image.
+ *
+ * Calls try_find and throws on a miss, which allocates the exception; use
+ * try_find where misses are common.
+ *
+ * @param Key The key of the element to be found.
+ * @return The reference to the found element, valid while the image is mapped.
+ * @throws HashTableException if the element with the specified key is not found.
+ */
+template <typename T>
+const T &ChHashSnapshot<T>::find(const char *Key) const
+{
+    const T *data = try_find(Key);
+    if (!data)
+    {
+        throw HashTableException(HashTableException::E_ITEM_NOT_FOUND, "Item not found");
+    }
+    return *data;
+}
+/**
+ * @brief Finds an element in the image without throwing.
+ *
+ * Hashes the key once, then compares the stored hash, and only if it is
+ * equal the key, of each entry of the key's bucket. Nothing is allocated.
+ *
+ * @param Key The key of the element to be found.
+ * @return Pointer to the found element, valid while the image is mapped, or
+ *         0 if the key is not in the image.
+ */
+template <typename T>
+const T *ChHashSnapshot<T>::try_find(const char *Key) const
+{
+    unsigned hash = hash_(Key, FULL_HASH_RANGE);
+    unsigned bucket = bucket_of(hash, header_->BucketCount);
+    for (unsigned i = buckets_[bucket]; i < buckets_[bucket + 1]; i++)
+    {
+        probes_++;
+        if (entries_[i].Hash == hash)
+        {
+            compares_++;
+            if (strncmp(entries_[i].Key, Key, MAX_KEYLEN) == 0)
+            {
+                return &entries_[i].Data;
+            }
+        }
+    }
+    return 0;
+}
+/**
+ * @brief Gets the statistics of the image.
+ *
+ * TableSize_ is the number of buckets. Probes_ and KeyCompares_ count the
+ * work of find since the image was mapped.
+ *
+ * @return The statistics of the image.
+ */
+template <typename T>
+HTStats ChHashSnapshot<T>::GetStats() const
+{
+    HTStats stats;
+    stats.Count_ = header_->Count;
+    stats.TableSize_ = header_->BucketCount;
+    stats.Probes_ = probes_;
+    stats.KeyCompares_ = compares_;
+    stats.HashFunc_ = hash_;
+    stats.Allocator_ = 0;
+    return stats;
+}
+/**
+ * @brief Returns the number of bytes mapped.
+ *
+ * @return The size of the image.
+ */
+template <typename T>
+std::size_t ChHashSnapshot<T>::size() const
+{
+    return size_;
+}
+/**
+ * @brief Returns the bucket of a full hash.
+ *
+ * Multiplies the hash by 2^32 / phi and keeps its top log2(buckets) bits,
+ * like ChHashTable with PowerOfTwo_.
+ *
+ * @param hash The full hash of a key.
+ * @param buckets The number of buckets, a power of two.
+ * @return The bucket.
+ */
+template <typename T>
+unsigned ChHashSnapshot<T>::bucket_of(unsigned hash, unsigned buckets)
+{
+    unsigned mixed = hash * 2654435769u;
+    return static_cast<unsigned>((static_cast<unsigned long long>(mixed) * buckets) >> 32);
+}
+/**
+ * @brief Checks that the mapped bytes are a valid image.
+ *
+ * Checks the header against this build, that every array lies inside the
+ * mapping, and that the bucket offsets never decrease and end at Count, so
+ * find cannot read outside the image.
+ *
+ * @param HashId The expected hash function id.
+ * @throws SnapshotException if the image is invalid (E_FORMAT) or has
+ *         another hash id (E_HASH).
+ */
+template <typename T>
+void ChHashSnapshot<T>::validate(unsigned HashId) const
+{
+    const ChHSHeader &header = *header_;
+    if (std::memcmp(header.Magic, "CHHSNAP", 8) != 0 || header.Version != VERSION ||
+        header.EntrySize != sizeof(Entry) || header.DataSize != sizeof(T) || header.ImageSize != size_)
+    {
+        throw SnapshotException(SnapshotException::E_FORMAT, "Not a snapshot of this format");
+    }
+    if (header.HashId != HashId)
+    {
+        throw SnapshotException(SnapshotException::E_HASH, "Snapshot uses another hash function");
+    }
+    bool valid = header.BucketCount && (header.BucketCount & (header.BucketCount - 1)) == 0 &&
+                 header.BucketsOffset % alignof(unsigned) == 0 && header.BucketsOffset <= size_ &&
+                 (size_ - header.BucketsOffset) / sizeof(unsigned) > header.BucketCount &&
+                 header.EntriesOffset % alignof(Entry) == 0 && header.EntriesOffset <= size_ &&
+                 (size_ - header.EntriesOffset) / sizeof(Entry) >= header.Count;
+    if (valid)
+    {
+        const unsigned *offsets = reinterpret_cast<const unsigned *>(image_ + header.BucketsOffset);
+        valid = offsets[0] == 0 && offsets[header.BucketCount] == header.Count;
+        for (unsigned b = 0; valid && b < header.BucketCount; b++)
+        {
+            valid = offsets[b] <= offsets[b + 1];
+        }
+    }
+    if (!valid)
+    {
+        throw SnapshotException(SnapshotException::E_FORMAT, "Corrupt snapshot");
+    }
+}
@@ -0,0 +1,160 @@
+/*!
+@file ChHashSnapshot.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the declaration of the ChHashSnapshot class, a
+       read-only image of a ChHashTable that is searched in mapped memory.
+*/
+//---------------------------------------------------------------------------
+#ifndef CHHASHSNAPSHOTH
+#define CHHASHSNAPSHOTH
+//---------------------------------------------------------------------------
+
+#include "ChHashTable.h" // HTStats, HashTableException, HASHFUNC, MAX_KEYLEN
+#include <cstddef>       // std::size_t
+#include <cstring>       // strncmp, strncpy
+#include <string>        // std::string
+#include <type_traits>   // std::is_trivially_copyable
+
+class SnapshotException
+{
+  private:
+    int error_code_;
+    std::string message_;
+
+  public:
+    SnapshotException(int ErrCode, const std::string& Message) :
+        error_code_(ErrCode), message_(Message) {};
+
+    virtual ~SnapshotException() {
+    }
+
+    virtual int code() const {
+      return error_code_;
+    }
+
+    virtual const char *what() const {
+      return message_.c_str();
+    }
+      // E_FILE: the file could not be written, opened or mapped
+      // E_FORMAT: not an image of this version, T or layout
+      // E_HASH: written with another hash function id
+      // E_GROWING: the table is in the middle of an incremental growth
+    enum SNAPSHOT_EXCEPTION {E_FILE, E_FORMAT, E_HASH, E_GROWING};
+};
+
+/*!
+  The start of an image. Offsets are from the start of the image, so the
+  image can be mapped anywhere.
+*/
+struct ChHSHeader
+{
+  char Magic[8];                    // "CHHSNAP"
+  unsigned Version;                 // ChHashSnapshot::VERSION
+  unsigned HashId;                  // The client's id for the hash function
+  unsigned EntrySize;               // sizeof(Entry) of the writer
+  unsigned DataSize;                // sizeof(T) of the writer
+  unsigned BucketCount;             // A power of two
+  unsigned Count;                   // Number of entries
+  unsigned long long BucketsOffset; // BucketCount + 1 entry indices
+  unsigned long long EntriesOffset; // Count entries, grouped by bucket
+  unsigned long long ImageSize;     // Bytes in the whole image
+};
+
+/*!
+  A read-only copy of a ChHashTable<T> that lives in a file.
+
+  write stores every item of a table as a position-independent image: a
+  header, an array of bucket offsets and the entries (full hash, key and
+  data) packed bucket by bucket. The constructor maps the file read-only and
+  find searches the mapped bytes directly, so opening costs one mapping and
+  no lookup allocates, except for the exception find throws on a miss;
+  try_find returns 0 instead.
+
+  Keys are placed by the full hash (the hash function for FULL_HASH_RANGE)
+  times 2^32 / phi, keeping the top log2(BucketCount) bits. The function
+  itself cannot be stored, so the image records an id the client gives it,
+  and opening with another id fails.
+
+  T must be trivially copyable (no pointers into the writer's memory) and
+  the image is only readable by a build with the same sizeof(T), struct
+  layout and byte order. Maps with POSIX open and mmap, or on Windows with
+  CreateFileMapping and MapViewOfFile.
+*/
+template <typename T>
+class ChHashSnapshot
+{
+  public:
+    static_assert(std::is_trivially_copyable<T>::value, "ChHashSnapshot needs a trivially copyable T");
+
+    //! Format version written in the header
+    static const unsigned VERSION = 1;
+
+      // An item in the image
+    struct Entry
+    {
+      unsigned Hash;        // Full hash of Key
+      char Key[MAX_KEYLEN]; // Key, null padded
+      T Data;               // Client data
+    };
+
+      // Writes every item of table to the file at Path, tagged with HashId.
+      // (E_FILE, E_GROWING, HashTableException::E_NO_MEMORY)
+    static void write(const ChHashTable<T> &table, const char *Path, unsigned HashId);
+
+      // Maps the image at Path. HashFunc must be the function the image was
+      // written with, and HashId its id. (E_FILE, E_FORMAT, E_HASH)
+    ChHashSnapshot(const char *Path, HASHFUNC HashFunc, unsigned HashId);
+    ~ChHashSnapshot();
+
+      // Find and return data by key, in the mapped image. throws exception if
+      // key doesn't exist. (HashTableException::E_ITEM_NOT_FOUND)
+    const T& find(const char *Key) const;
+
+      // Find data by key, in the mapped image. Returns 0 if the key doesn't
+      // exist.
+    const T* try_find(const char *Key) const;
+
+      // Count_, TableSize_ (buckets), Probes_, KeyCompares_ and HashFunc_.
+    HTStats GetStats() const;
+
+      // Returns the number of bytes mapped.
+    std::size_t size() const;
+
+  private:
+    const char *image_;         // The mapped image
+    std::size_t size_;          // Bytes mapped
+    const ChHSHeader *header_;  // Start of image_
+    const unsigned *buckets_;   // Bucket offsets in image_
+    const Entry *entries_;      // Entries in image_
+    HASHFUNC hash_;             // Hash function
+    mutable unsigned probes_;   // Entries visited by find
+    mutable unsigned compares_; // Keys compared by find
+
+    ChHashSnapshot(const ChHashSnapshot &) = delete;
+    ChHashSnapshot &operator=(const ChHashSnapshot &) = delete;
+
+    /**
+     * @brief Returns the bucket of a full hash.
+     *
+     * @param hash The full hash of a key.
+     * @param buckets The number of buckets, a power of two.
+     * @return The top log2(buckets) bits of hash times 2^32 / phi.
+     */
+    static unsigned bucket_of(unsigned hash, unsigned buckets);
+    /**
+     * @brief Checks that the mapped bytes are a valid image.
+     *
+     * @param HashId The expected hash function id.
+     * @throws SnapshotException if they are not.
+     */
+    void validate(unsigned HashId) const;
+};
+
+#include "ChHashSnapshot.cpp"
+
+#endif
@@ -18,13 +18,23 @@
  * @param allocator An optional allocator for memory management.
  */
 template <typename T>
-ChHashTable<T>::ChHashTable(const HTConfig &Config, ObjectAllocator *allocator) : config_(Config), allocator_(allocator)
+ChHashTable<T>::ChHashTable(const HTConfig &Config, ObjectAllocator *allocator)
+    : config_(Config), allocator_(allocator), old_table_(0), old_size_(0), migrated_(0),
+      filter_(0), filter_words_(0), filter_capacity_(0), filter_removed_(0),
+      filter_hashes_(0)
 {
-    table_ = new ChHTHeadNode[config_.InitialTableSize_];
+    unsigned size = config_.PowerOfTwo_ ? table_size(config_.InitialTableSize_) : config_.InitialTableSize_;
+    table_ = new ChHTHeadNode[size];
     stats_ = new HTStats();
-    stats_->TableSize_ = config_.InitialTableSize_;
+    stats_->TableSize_ = size;
     stats_->HashFunc_ = config_.HashFunc_;
     stats_->Allocator_ = allocator;
+    if (config_.FilterBits_)
+    {
+        filter_hashes_ = config_.FilterBits_ / 2;
+        filter_hashes_ = filter_hashes_ < 1 ? 1 : filter_hashes_ > 8 ? 8 : filter_hashes_;
+        rebuild_filter(size < 16 ? 16 : size);
+    }
 }
 /**
  * @brief Destructor for ChHashTable class.
@@ -36,12 +46,16 @@ ChHashTable<T>::~ChHashTable()
 {
     clear();
     delete[] table_;
+    delete[] filter_;
     delete stats_;
 }
 /**
  * @brief Inserts an element into the hash table.
  *
  * Inserts the specified element with the given key into the hash table.
+ * While the table grows incrementally, the key's list in the old table is
+ * also searched for a duplicate. With FilterBits_, lists are not searched
+ * for a key the filter rules out, and the key is added to the filter.
  *
  * @param Key The key associated with the data to be inserted.
  * @param Data The data to be inserted into the hash table.
@@ -57,25 +71,51 @@ void ChHashTable<T>::insert(const char *Key, const T &Data)
         {
             grow_table();
         }
-        unsigned index = config_.HashFunc_(Key, stats_->TableSize_);
+        if (old_table_)
+        {
+            migrate(config_.RehashStep_);
+        }
+        if (filter_ && stats_->Count_ + 1 > filter_capacity_)
+        {
+            rebuild_filter(filter_capacity_ * 2);
+        }
+        unsigned hash = full_hash(Key);
+        unsigned index = index_of(Key, hash, stats_->TableSize_);
         ChHTHeadNode *head = &table_[index];
         ChHTNode *node = head->Nodes;
         stats_->Probes_++;
-        while (node)
+        if (!filter_ || filter_may_contain(hash))
         {
-            stats_->Probes_++;
-            if (strncmp(node->Key, Key, MAX_KEYLEN) == 0)
+            while (node)
             {
-                throw HashTableException(HashTableException::E_DUPLICATE, "Duplicate key");
+                stats_->Probes_++;
+                if (same_key(node, Key, hash))
+                {
+                    throw HashTableException(HashTableException::E_DUPLICATE, "Duplicate key");
+                }
+                node = node->Next;
+            }
+            ChHTHeadNode *old = old_list(Key, hash);
+            for (node = old ? old->Nodes : nullptr; node; node = node->Next)
+            {
+                stats_->Probes_++;
+                if (same_key(node, Key, hash))
+                {
+                    throw HashTableException(HashTableException::E_DUPLICATE, "Duplicate key");
+                }
             }
-            node = node->Next;
         }
         ChHTNode *newNode = new_node(Data);
-        strncpy(newNode->Key, Key, MAX_KEYLEN);
+        copy_key(newNode, Key);
+        newNode->Hash = hash;
         newNode->Next = head->Nodes;
         head->Nodes = newNode;
         head->Count++;
         stats_->Count_++;
+        if (filter_)
+        {
+            filter_block(hash) |= filter_mask(hash);
+        }
     }
     catch (HashTableException &e)
     {
@@ -83,45 +123,197 @@ void ChHashTable<T>::insert(const char *Key, const T &Data)
     }
 }
 /**
- * @brief Removes an element from the hash table.
+ * @brief Makes room for a number of items.
  *
- * Removes the element with the specified key from the hash table.
+ * Finishes any growth in progress, then grows the table once to the
+ * smallest size that holds Count items within MaxLoadFactor_, so inserting
+ * up to Count items never grows it. Does not grow a table big enough. The
+ * filter, if any, is resized for Count items too.
  *
- * @param Key The key of the element to be removed.
+ * @param Count The number of items the table should hold.
+ * @throws HashTableException if memory allocation fails or the table would
+ *         need more lists than an unsigned can count.
  */
 template <typename T>
-void ChHashTable<T>::remove(const char *Key)
+void ChHashTable<T>::reserve(unsigned Count)
 {
-    unsigned index = stats_->HashFunc_(Key, stats_->TableSize_);
-    ChHTHeadNode *head = &table_[index];
-    ChHTNode *node = head->Nodes;
-    ChHTNode *prev = nullptr;
-    while (node)
+    if (old_table_)
+    {
+        migrate(old_size_);
+    }
+    double needed = std::ceil(Count / config_.MaxLoadFactor_);
+    // table_size cannot round past the top power of two an unsigned holds,
+    // and no table that large could be allocated anyway
+    if (!(needed <= static_cast<double>(std::numeric_limits<unsigned>::max() / 2 + 1)))
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    if (needed > stats_->TableSize_)
+    {
+        rehash(table_size(static_cast<unsigned>(needed)));
+    }
+    if (filter_ && Count > filter_capacity_)
+    {
+        rebuild_filter(Count);
+    }
+}
+/**
+ * @brief Inserts many elements into the hash table.
+ *
+ * Reserves room for every element, then works in passes: hashes every key,
+ * allocates every node, and links the nodes into their lists, checking each
+ * list for a duplicate. If a node cannot be allocated, the ones already
+ * allocated are freed and the table holds the same items, though reserve
+ * may already have grown the table and its filter. On a duplicate, the keys
+ * before it stay inserted and the rest are not.
+ *
+ * @param Keys The keys.
+ * @param Data The data of each key.
+ * @param Count The number of keys.
+ * @throws HashTableException if a key is a duplicate or memory allocation fails.
+ */
+template <typename T>
+void ChHashTable<T>::insert_range(const char *const *Keys, const T *Data, unsigned Count)
+{
+    reserve(stats_->Count_ + Count);
+    BulkItem *items;
+    try
+    {
+        items = new BulkItem[Count];
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    for (unsigned i = 0; i < Count; i++)
+    {
+        items[i].hash = full_hash(Keys[i]);
+        items[i].index = index_of(Keys[i], items[i].hash, stats_->TableSize_);
+    }
+    unsigned allocated = 0;
+    try
+    {
+        for (; allocated < Count; allocated++)
+        {
+            items[allocated].node = new_node(Data[allocated]);
+        }
+    }
+    catch (...)
+    {
+        while (allocated)
+        {
+            release_node(items[--allocated].node);
+        }
+        delete[] items;
+        throw;
+    }
+    for (unsigned i = 0; i < Count; i++)
     {
+        ChHTHeadNode *head = &table_[items[i].index];
         stats_->Probes_++;
-        if (strncmp(node->Key, Key, MAX_KEYLEN) == 0)
+        bool check = !filter_ || filter_may_contain(items[i].hash);
+        for (ChHTNode *node = check ? head->Nodes : nullptr; node; node = node->Next)
         {
-            if (prev)
+            stats_->Probes_++;
+            if (same_key(node, Keys[i], items[i].hash))
             {
-                prev->Next = node->Next;
+                for (unsigned j = i; j < Count; j++)
+                {
+                    release_node(items[j].node);
+                }
+                delete[] items;
+                throw HashTableException(HashTableException::E_DUPLICATE, "Duplicate key");
             }
-            else
+        }
+        ChHTNode *newNode = items[i].node;
+        copy_key(newNode, Keys[i]);
+        newNode->Hash = items[i].hash;
+        newNode->Next = head->Nodes;
+        head->Nodes = newNode;
+        head->Count++;
+        stats_->Count_++;
+        if (filter_)
+        {
+            filter_block(items[i].hash) |= filter_mask(items[i].hash);
+        }
+    }
+    delete[] items;
+}
+/**
+ * @brief Removes an element from the hash table.
+ *
+ * Removes the element with the specified key from the hash table. While the
+ * table grows incrementally, the key's list in the old table is searched too.
+ * With FilterBits_ a key the filter rules out is not searched for. Its bits
+ * stay in the filter until the filter is next rebuilt, which happens at the
+ * same capacity once half as many items as it holds have been removed, so
+ * churn does not fill it with stale bits.
+ *
+ * @param Key The key of the element to be removed.
+ */
+template <typename T>
+void ChHashTable<T>::remove(const char *Key)
+{
+    if (old_table_)
+    {
+        migrate(config_.RehashStep_);
+    }
+    unsigned hash = full_hash(Key);
+    if (filter_ && !filter_may_contain(hash))
+    {
+        stats_->FilterRejects_++;
+        return;
+    }
+    unsigned index = index_of(Key, hash, stats_->TableSize_);
+    ChHTHeadNode *lists[2] = {&table_[index], old_list(Key, hash)};
+    for (unsigned i = 0; i < 2 && lists[i]; i++)
+    {
+        ChHTHeadNode *head = lists[i];
+        ChHTNode *node = head->Nodes;
+        ChHTNode *prev = nullptr;
+        while (node)
+        {
+            stats_->Probes_++;
+            if (same_key(node, Key, hash))
             {
-                head->Nodes = node->Next;
+                if (prev)
+                {
+                    prev->Next = node->Next;
+                }
+                else
+                {
+                    head->Nodes = node->Next;
+                }
+                delete_node(node);
+                head->Count--;
+                stats_->Count_--;
+                if (filter_ && ++filter_removed_ >= filter_capacity_ / 2)
+                {
+                    try
+                    {
+                        rebuild_filter(filter_capacity_);
+                    }
+                    catch (const HashTableException &e)
+                    {
+                        // The old filter is still correct, only less selective
+                    }
+                }
+                return;
             }
-            delete_node(node);
-            head->Count--;
-            stats_->Count_--;
-            return;
+            prev = node;
+            node = node->Next;
         }
-        prev = node;
-        node = node->Next;
+    }
+    if (filter_)
+    {
+        stats_->FilterFalsePositives_++;
     }
 }
 /**
  * @brief Finds an element in the hash table.
  *
- * Finds and returns the element with the specified key from the hash table.
+ * Finds and returns the element with the specified key from the hash table
+ * (see try_find).
  *
  * @param Key The key of the element to be found.
  * @return The reference to the found element.
@@ -130,24 +322,64 @@ void ChHashTable<T>::remove(const char *Key)
 template <typename T>
 const T &ChHashTable<T>::find(const char *Key) const
 {
-    unsigned index = stats_->HashFunc_(Key, stats_->TableSize_);
+    const T *data = try_find(Key);
+    if (!data)
+    {
+        throw HashTableException(HashTableException::E_ITEM_NOT_FOUND, "Item not found");
+    }
+    return *data;
+}
+/**
+ * @brief Finds an element in the hash table without throwing.
+ *
+ * With FilterBits_ a key the filter rules out costs no probe at all. While
+ * the table grows incrementally, the key's list in the old table is
+ * searched if the key is not in the new one. Nothing is moved.
+ *
+ * @param Key The key of the element to be found.
+ * @return Pointer to the found element, or 0 if the key is not in the table.
+ */
+template <typename T>
+const T *ChHashTable<T>::try_find(const char *Key) const
+{
+    unsigned hash = full_hash(Key);
+    if (filter_ && !filter_may_contain(hash))
+    {
+        stats_->FilterRejects_++;
+        return 0;
+    }
+    unsigned index = index_of(Key, hash, stats_->TableSize_);
     ChHTNode *node = table_[index].Nodes;
     while (node)
     {
-        if (strncmp(node->Key, Key, MAX_KEYLEN) == 0)
+        if (same_key(node, Key, hash))
         {
             stats_->Probes_++;
-            return node->Data;
+            return &node->Data;
         }
         node = node->Next;
         stats_->Probes_++;
     }
-    throw HashTableException(HashTableException::E_ITEM_NOT_FOUND, "Item not found");
+    ChHTHeadNode *old = old_list(Key, hash);
+    for (node = old ? old->Nodes : nullptr; node; node = node->Next)
+    {
+        stats_->Probes_++;
+        if (same_key(node, Key, hash))
+        {
+            return &node->Data;
+        }
+    }
+    if (filter_)
+    {
+        stats_->FilterFalsePositives_++;
+    }
+    return 0;
 }
 /**
  * @brief Clears the hash table.
  *
- * Removes all elements from the hash table.
+ * Removes all elements from the hash table, and frees the old table if the
+ * table is growing incrementally.
  */
 template <typename T>
 void ChHashTable<T>::clear()
@@ -157,13 +389,32 @@ void ChHashTable<T>::clear()
         ChHTNode *node = table_[i].Nodes;
         while (node)
         {
-            ChHTNode *temp = node;
+            ChHTNode *temp = node->Next;
             delete_node(node);
-            node = temp->Next;
+            node = temp;
         }
         table_[i].Nodes = nullptr;
     }
+    for (unsigned i = migrated_; i < old_size_; i++)
+    {
+        ChHTNode *node = old_table_[i].Nodes;
+        while (node)
+        {
+            ChHTNode *temp = node->Next;
+            delete_node(node);
+            node = temp;
+        }
+    }
+    delete[] old_table_;
+    old_table_ = 0;
+    old_size_ = 0;
+    migrated_ = 0;
     stats_->Count_ = 0;
+    for (unsigned i = 0; i < filter_words_; i++)
+    {
+        filter_[i] = 0;
+    }
+    filter_removed_ = 0;
 }
 /**
  * @brief Gets the statistics of the hash table.
@@ -231,6 +482,18 @@ void ChHashTable<T>::delete_node(ChHTNode *&node)
     {
         config_.FreeProc_(node->Data);
     }
+    release_node(node);
+}
+/**
+ * @brief Frees a node without calling the free proc.
+ *
+ * Used for nodes whose data the table never owned.
+ *
+ * @param node Pointer to the node to be freed.
+ */
+template <typename T>
+void ChHashTable<T>::release_node(ChHTNode *node)
+{
     if (allocator_)
     {
         allocator_->Free(node);
@@ -243,7 +506,9 @@ void ChHashTable<T>::delete_node(ChHTNode *&node)
 /**
  * @brief Grows the hash table.
  *
- * Increases the size of the hash table and rehashes all elements.
+ * Increases the size of the hash table and rehashes all elements. With a
+ * RehashStep_ the old table is kept instead, and its lists are moved by
+ * later inserts and removes (see migrate).
  *
  * @throws HashTableException if memory allocation fails.
  */
@@ -252,10 +517,48 @@ void ChHashTable<T>::grow_table()
 {
     try
     {
+        if (old_table_)
+        {
+            // the previous growth has not finished; finish it first
+            migrate(old_size_);
+        }
         unsigned oldSize = stats_->TableSize_;
-        unsigned newSize = GetClosestPrime(static_cast<unsigned>(std::ceil(oldSize * config_.GrowthFactor_)));
+        unsigned newSize = table_size(static_cast<unsigned>(std::ceil(oldSize * config_.GrowthFactor_)));
+        if (!config_.RehashStep_)
+        {
+            rehash(newSize);
+            return;
+        }
+        ChHTHeadNode *newTable = new ChHTHeadNode[newSize];
+        stats_->TableSize_ = newSize;
+        old_table_ = table_;
+        old_size_ = oldSize;
+        migrated_ = 0;
+        table_ = newTable;
+        stats_->Expansions_++;
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+}
+/**
+ * @brief Moves every node into a table of another size at once.
+ *
+ * Relinks each node at the head of its list in the new table and frees the
+ * old one. No growth may be in progress.
+ *
+ * @param newSize The size of the new table.
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename T>
+void ChHashTable<T>::rehash(unsigned newSize)
+{
+    try
+    {
+        unsigned oldSize = stats_->TableSize_;
+        ChHTHeadNode *newTable = new ChHTHeadNode[newSize];
         stats_->TableSize_ = newSize;
-        ChHTHeadNode *newTable = new ChHTHeadNode[stats_->TableSize_];
         for (unsigned i = 0; i < oldSize; i++)
         {
             ChHTNode *node = table_[i].Nodes;
@@ -263,19 +566,12 @@ void ChHashTable<T>::grow_table()
             {
                 stats_->Probes_++;
                 ChHTNode *temp = node->Next;
-                unsigned index = stats_->HashFunc_(node->Key, stats_->TableSize_);
-                if (newTable[index].Nodes)
+                unsigned index = index_of(node->Key, node->Hash, stats_->TableSize_);
+                // Keys are unique, so the list is only walked to count its
+                // probes; comparing keys here would inflate KeyCompares_.
+                for (ChHTNode *head = newTable[index].Nodes; head; head = head->Next)
                 {
-                    ChHTNode *head = newTable[index].Nodes;
-                    while (head)
-                    {
-                        stats_->Probes_++;
-                        if (strncmp(head->Key, node->Key, MAX_KEYLEN) == 0)
-                        {
-                            break;
-                        }
-                        head = head->Next;
-                    }
+                    stats_->Probes_++;
                 }
                 node->Next = newTable[index].Nodes;
                 newTable[index].Nodes = node;
@@ -290,4 +586,267 @@ void ChHashTable<T>::grow_table()
     {
         throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
     }
-}
\ No newline at end of file
+}
+/**
+ * @brief Moves lists from the old table into the new one.
+ *
+ * Moves up to count lists of the table being emptied while growing, in
+ * order, relinking their nodes at the heads of the new lists. Frees the old
+ * table once every list has moved.
+ *
+ * @param count The number of lists to move.
+ */
+template <typename T>
+void ChHashTable<T>::migrate(unsigned count)
+{
+    for (; count && migrated_ < old_size_; count--, migrated_++)
+    {
+        ChHTNode *node = old_table_[migrated_].Nodes;
+        while (node)
+        {
+            stats_->Probes_++;
+            ChHTNode *temp = node->Next;
+            ChHTHeadNode *head = &table_[index_of(node->Key, node->Hash, stats_->TableSize_)];
+            node->Next = head->Nodes;
+            head->Nodes = node;
+            head->Count++;
+            node = temp;
+        }
+        old_table_[migrated_].Nodes = nullptr;
+    }
+    if (migrated_ == old_size_)
+    {
+        delete[] old_table_;
+        old_table_ = 0;
+        old_size_ = 0;
+        migrated_ = 0;
+    }
+}
+/**
+ * @brief Finds the list of the old table that may hold a key.
+ *
+ * @param Key The key.
+ * @param hash The full hash of the key (see full_hash).
+ * @return The list of old_table_ the key hashes to, or 0 if no growth is
+ *         in progress or that list has already moved.
+ */
+template <typename T>
+typename ChHashTable<T>::ChHTHeadNode *ChHashTable<T>::old_list(const char *Key, unsigned hash) const
+{
+    if (!old_table_)
+    {
+        return 0;
+    }
+    unsigned index = index_of(Key, hash, old_size_);
+    return index >= migrated_ ? &old_table_[index] : 0;
+}
+/**
+ * @brief Returns the full hash of a key.
+ *
+ * The full hash is the client hash for a table of FULL_HASH_RANGE, so it
+ * does not depend on the size of the table and can be kept in the node.
+ *
+ * @param Key The key.
+ * @return The full hash if StoreHash_, PowerOfTwo_ or FilterBits_, 0
+ *         otherwise.
+ */
+template <typename T>
+unsigned ChHashTable<T>::full_hash(const char *Key) const
+{
+    if (config_.StoreHash_ || config_.PowerOfTwo_ || config_.FilterBits_)
+    {
+        return stats_->HashFunc_(Key, FULL_HASH_RANGE);
+    }
+    return 0;
+}
+/**
+ * @brief Returns the list of a table of some size that holds a key.
+ *
+ * With StoreHash_ the full hash is reduced to the table size, so a key is
+ * hashed once when it is inserted and never again when the table grows.
+ * With PowerOfTwo_ the full hash is multiplied by 2^32 / phi and its top
+ * log2(size) bits are the index (Fibonacci hashing): a multiply and a shift
+ * instead of a division, and every bit of the hash affects the index.
+ *
+ * @param Key The key.
+ * @param hash The full hash of the key (see full_hash).
+ * @param size The size of the table.
+ * @return The index of the key's list.
+ */
+template <typename T>
+unsigned ChHashTable<T>::index_of(const char *Key, unsigned hash, unsigned size) const
+{
+    if (config_.PowerOfTwo_)
+    {
+        // (mixed * size) >> 32 is mixed >> (32 - log2(size)), without a
+        // 32-bit shift when size is 1
+        unsigned mixed = hash * 2654435769u;
+        return static_cast<unsigned>((static_cast<unsigned long long>(mixed) * size) >> 32);
+    }
+    if (config_.StoreHash_)
+    {
+        return hash % size;
+    }
+    return stats_->HashFunc_(Key, size);
+}
+/**
+ * @brief Checks if a node holds a key.
+ *
+ * With StoreHash_ the stored hashes are compared first, so the key bytes are
+ * only compared when the hashes are equal. Counts the key comparisons.
+ *
+ * @param node The node.
+ * @param Key The key.
+ * @param hash The full hash of the key (see full_hash).
+ * @return true if the node holds the key.
+ */
+template <typename T>
+bool ChHashTable<T>::same_key(const ChHTNode *node, const char *Key, unsigned hash) const
+{
+    if (node->Hash != hash)
+    {
+        return false;
+    }
+    stats_->KeyCompares_++;
+    return strncmp(node->Key, Key, MAX_KEYLEN) == 0;
+}
+/**
+ * @brief Copies a key into a node.
+ *
+ * Keys are compared over MAX_KEYLEN bytes, so a key that fills the buffer
+ * is kept whole without a NUL.
+ *
+ * @param node The node.
+ * @param Key The key.
+ */
+template <typename T>
+void ChHashTable<T>::copy_key(ChHTNode *node, const char *Key)
+{
+    std::size_t length = std::strlen(Key);
+    if (length > MAX_KEYLEN)
+    {
+        length = MAX_KEYLEN;
+    }
+    std::memcpy(node->Key, Key, length);
+    if (length < MAX_KEYLEN)
+    {
+        node->Key[length] = '\0';
+    }
+}
+/**
+ * @brief Returns the size of a table that holds at least some lists.
+ *
+ * Sizes are powers of two with PowerOfTwo_ (see index_of) and primes
+ * otherwise.
+ *
+ * @param size The number of lists wanted.
+ * @return The smallest power of two not below size if PowerOfTwo_, the
+ *         closest prime above size otherwise.
+ */
+template <typename T>
+unsigned ChHashTable<T>::table_size(unsigned size) const
+{
+    if (!config_.PowerOfTwo_)
+    {
+        return GetClosestPrime(size);
+    }
+    unsigned power = 1;
+    while (power < size)
+    {
+        power *= 2;
+    }
+    return power;
+}
+/**
+ * @brief Returns the bits of a full hash in its filter block.
+ *
+ * The top bits of the hash times a second odd constant give six bits per
+ * position, one position per filter_hashes_.
+ *
+ * @param hash The full hash of a key.
+ * @return A word with filter_hashes_ bits set (some may coincide).
+ */
+template <typename T>
+unsigned long long ChHashTable<T>::filter_mask(unsigned hash) const
+{
+    unsigned long long mixed = hash * 0xC2B2AE3D27D4EB4Full;
+    unsigned long long mask = 0;
+    for (unsigned i = 0; i < filter_hashes_; i++)
+    {
+        mask |= 1ull << ((mixed >> (58 - 6 * i)) & 63);
+    }
+    return mask;
+}
+/**
+ * @brief Returns the filter block of a full hash.
+ *
+ * Every bit of a key is in one 64-bit block, so a lookup reads one word of
+ * memory however many bits it tests (a blocked Bloom filter).
+ *
+ * @param hash The full hash of a key.
+ * @return The block of filter_ the key's bits are in.
+ */
+template <typename T>
+unsigned long long &ChHashTable<T>::filter_block(unsigned hash) const
+{
+    unsigned long long mixed = hash * 0x9E3779B97F4A7C15ull;
+    return filter_[((mixed >> 32) * filter_words_) >> 32];
+}
+/**
+ * @brief Checks the filter for a key.
+ *
+ * @param hash The full hash of the key.
+ * @return false if the key is certainly not in the table.
+ */
+template <typename T>
+bool ChHashTable<T>::filter_may_contain(unsigned hash) const
+{
+    unsigned long long mask = filter_mask(hash);
+    return (filter_block(hash) & mask) == mask;
+}
+/**
+ * @brief Rebuilds the filter for at least some items.
+ *
+ * The filter holds full hashes, which do not depend on the size of the
+ * table, so growing the table leaves it valid. It is only rebuilt when the
+ * table outgrows it or after many removals: then it is sized for capacity
+ * items and every item is added from its stored hash, which also drops the
+ * bits of removed keys.
+ *
+ * @param capacity The number of items to size the filter for.
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename T>
+void ChHashTable<T>::rebuild_filter(unsigned capacity)
+{
+    unsigned long long bits = static_cast<unsigned long long>(capacity) * config_.FilterBits_;
+    unsigned words = static_cast<unsigned>((bits + 63) / 64);
+    unsigned long long *filter;
+    try
+    {
+        filter = new unsigned long long[words]();
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    delete[] filter_;
+    filter_ = filter;
+    filter_words_ = words;
+    filter_capacity_ = capacity;
+    filter_removed_ = 0;
+    for (unsigned i = 0; i < stats_->TableSize_; i++)
+    {
+        for (ChHTNode *node = table_[i].Nodes; node; node = node->Next)
+        {
+            filter_block(node->Hash) |= filter_mask(node->Hash);
+        }
+    }
+    for (unsigned i = migrated_; i < old_size_; i++)
+    {
+        for (ChHTNode *node = old_table_[i].Nodes; node; node = node->Next)
+        {
+            filter_block(node->Hash) |= filter_mask(node->Hash);
+        }
+    }
+}
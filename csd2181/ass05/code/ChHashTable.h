@@ -17,6 +17,8 @@
 #include "ObjectAllocator.h"
 #include "support.h"
 #include <cmath>
+#include <cstring>
+#include <limits>
 
 // client-provided hash function: takes a key and table size,
 // returns an index in the table.
@@ -25,6 +27,10 @@ typedef unsigned (*HASHFUNC)(const char *, unsigned);
 // Max length of our "string" keys
 const unsigned MAX_KEYLEN = 10;
 
+// Table size passed to the client hash function to get a hash that does not
+// depend on the table size (the largest 32-bit prime)
+const unsigned FULL_HASH_RANGE = 4294967291u;
+
 class HashTableException
 {
   private:
@@ -53,13 +59,26 @@ class HashTableException
 struct HTStats
 {
   HTStats(void) : Count_(0), TableSize_(0), Probes_(0), Expansions_(0),
+                    KeyCompares_(0), FilterRejects_(0), FilterFalsePositives_(0),
                     HashFunc_(0) {};
   unsigned Count_;      // Number of elements in the table
   unsigned TableSize_;  // Size of the table (total slots)
   unsigned Probes_;     // Number of probes performed
   unsigned Expansions_; // Number of times the table grew
+  unsigned KeyCompares_; // Number of probes that compared the key bytes
+  unsigned FilterRejects_; // Finds and removes of missing keys the filter
+                           // answered without a probe (inserts not counted)
+  unsigned FilterFalsePositives_; // Finds and removes of missing keys the
+                                  // filter let through
   HASHFUNC HashFunc_;   // Pointer to primary hash function
   ObjectAllocator *Allocator_; // The allocator in use (may be 0)
+
+    // Share of lookups of missing keys that the filter let through (0 if
+    // there were none)
+  double FilterFalsePositiveRate(void) const {
+    unsigned misses = FilterRejects_ + FilterFalsePositives_;
+    return misses ? static_cast<double>(FilterFalsePositives_) / misses : 0.0;
+  }
 };
 
 template <typename T>
@@ -75,7 +94,11 @@ class ChHashTable
                  HASHFUNC HashFunc,
                  double MaxLoadFactor = 3.0,
                  double GrowthFactor = 2.0,
-                 FREEPROC FreeProc = 0) :
+                 FREEPROC FreeProc = 0,
+                 unsigned RehashStep = 0,
+                 bool StoreHash = false,
+                 bool PowerOfTwo = false,
+                 unsigned FilterBits = 0) :
 
         // The number of slots in the table initially.
         InitialTableSize_(InitialTableSize),
@@ -87,19 +110,38 @@ class ChHashTable
         GrowthFactor_(GrowthFactor),
         // The method provided by the client that may need to be called when 
         // data in the table is removed.
-        FreeProc_(FreeProc) {}
+        FreeProc_(FreeProc),
+        // The number of old lists moved by each insert and remove while the
+        // table grows. 0 moves them all at once.
+        RehashStep_(RehashStep),
+        // Keep each key's full hash in its node, place keys by it, and
+        // compare it before the key bytes. Changes where keys are placed.
+        StoreHash_(StoreHash),
+        // Round table sizes up to powers of two instead of primes, and pick
+        // lists by the top bits of the full hash times 2^32 / phi. Keeps the
+        // full hash in each node like StoreHash_.
+        PowerOfTwo_(PowerOfTwo),
+        // Bits per item of a blocked Bloom filter of full hashes in front of
+        // the lists. 0 means no filter. Keeps the full hash in each node
+        // like StoreHash_.
+        FilterBits_(FilterBits) {}
 
       unsigned InitialTableSize_;
       HASHFUNC HashFunc_;
       double MaxLoadFactor_;
       double GrowthFactor_;
       FREEPROC FreeProc_;
+      unsigned RehashStep_;
+      bool StoreHash_;
+      bool PowerOfTwo_;
+      unsigned FilterBits_;
     };
 
       // Nodes that will hold the key/data pairs
     struct ChHTNode
     {
       char Key[MAX_KEYLEN]; // Key is a string
+      unsigned Hash;        // Full hash of Key if StoreHash_, PowerOfTwo_ or FilterBits_, else 0
       T Data;               // Client data
       ChHTNode *Next;
       ChHTNode(const T& data) : Data(data) {}; // constructor
@@ -122,6 +164,16 @@ class ChHashTable
       // insertion is unsuccessful.(E_DUPLICATE, E_NO_MEMORY)
     void insert(const char *Key, const T& Data);
 
+      // Finishes any growth in progress and grows the table once, if needed,
+      // so that Count items fit without passing MaxLoadFactor_. (E_NO_MEMORY)
+    void reserve(unsigned Count);
+
+      // Insert Count key/data pairs: reserves room for them, hashes every
+      // key, allocates every node, then links them. Keys before a duplicate
+      // stay inserted. If a node cannot be allocated no key is inserted, but
+      // the table may have grown. (E_DUPLICATE, E_NO_MEMORY)
+    void insert_range(const char *const *Keys, const T *Data, unsigned Count);
+
       // Delete an item by key. Throws an exception if the key doesn't exist.
       // (E_ITEM_NOT_FOUND)
     void remove(const char *Key);
@@ -130,6 +182,9 @@ class ChHashTable
       // (E_ITEM_NOT_FOUND)
     const T& find(const char *Key) const;
 
+      // Find data by key. Returns 0 if the key doesn't exist.
+    const T* try_find(const char *Key) const;
+
       // Removes all items from the table (Doesn't deallocate table)
     void clear();
 
@@ -146,6 +201,23 @@ class ChHashTable
     HTStats *stats_; // Stats
     HTConfig config_; // Config
     ObjectAllocator *allocator_; // Allocator
+    ChHTHeadNode *old_table_; // The table being emptied while growing, or 0
+    unsigned old_size_; // Size of old_table_
+    unsigned migrated_; // Lists of old_table_ already moved to table_
+    unsigned long long *filter_; // Bloom filter blocks, or 0
+    unsigned filter_words_; // Number of blocks in filter_
+    unsigned filter_capacity_; // Items filter_ was sized for
+    unsigned filter_removed_; // Items removed since filter_ was rebuilt
+    unsigned filter_hashes_; // Bits set per item
+
+      // A key of insert_range between its passes
+    struct BulkItem
+    {
+      unsigned hash;  // Full hash of the key (see full_hash)
+      unsigned index; // Its list
+      ChHTNode *node; // Its node, once allocated
+    };
+
     /**
      * @brief Creates a new node with the given data.
      * 
@@ -164,6 +236,12 @@ class ChHashTable
      * @param node Pointer to the node to be deleted.
      */
     void delete_node(ChHTNode *&node);
+    /**
+     * @brief Frees a node without calling the free proc.
+     * 
+     * @param node Pointer to the node to be freed.
+     */
+    void release_node(ChHTNode *node);
     /**
      * @brief Grows the hash table.
      * 
@@ -172,6 +250,111 @@ class ChHashTable
      * @throws HashTableException if memory allocation fails.
      */
     void grow_table();
+    /**
+     * @brief Moves every node into a table of another size at once.
+     * 
+     * @param newSize The size of the new table.
+     * @throws HashTableException if memory allocation fails.
+     */
+    void rehash(unsigned newSize);
+    /**
+     * @brief Moves lists from the old table into the new one.
+     * 
+     * Moves up to count lists of the table being emptied while growing, and
+     * frees it once every list has moved.
+     * 
+     * @param count The number of lists to move.
+     */
+    void migrate(unsigned count);
+    /**
+     * @brief Finds the list of the old table that may hold a key.
+     * 
+     * @param Key The key.
+     * @param hash The full hash of the key (see full_hash).
+     * @return The list of old_table_ the key hashes to, or 0 if no growth is
+     *         in progress or that list has already moved.
+     */
+    ChHTHeadNode *old_list(const char *Key, unsigned hash) const;
+    /**
+     * @brief Returns the full hash of a key.
+     * 
+     * @param Key The key.
+     * @return The client hash for a table of FULL_HASH_RANGE if StoreHash_,
+     *         PowerOfTwo_ or FilterBits_, 0 otherwise.
+     */
+    unsigned full_hash(const char *Key) const;
+    /**
+     * @brief Returns the bits of a full hash in its filter block.
+     * 
+     * @param hash The full hash of a key.
+     * @return A word with filter_hashes_ bits set (some may coincide).
+     */
+    unsigned long long filter_mask(unsigned hash) const;
+    /**
+     * @brief Returns the filter block of a full hash.
+     * 
+     * @param hash The full hash of a key.
+     * @return The block of filter_ the key's bits are in.
+     */
+    unsigned long long &filter_block(unsigned hash) const;
+    /**
+     * @brief Checks the filter for a key.
+     * 
+     * @param hash The full hash of the key.
+     * @return false if the key is certainly not in the table.
+     */
+    bool filter_may_contain(unsigned hash) const;
+    /**
+     * @brief Rebuilds the filter for at least some items.
+     * 
+     * Sizes the filter for capacity items and adds every item in the table,
+     * which also drops the bits of removed keys. Resets the removal count.
+     * 
+     * @param capacity The number of items to size the filter for.
+     * @throws HashTableException if memory allocation fails.
+     */
+    void rebuild_filter(unsigned capacity);
+    /**
+     * @brief Returns the list of a table of some size that holds a key.
+     * 
+     * @param Key The key.
+     * @param hash The full hash of the key (see full_hash).
+     * @param size The size of the table.
+     * @return The top bits of the stored hash times 2^32 / phi if
+     *         PowerOfTwo_, the stored hash reduced to the table size if
+     *         StoreHash_, the client hash for that size otherwise.
+     */
+    unsigned index_of(const char *Key, unsigned hash, unsigned size) const;
+    /**
+     * @brief Returns the size of a table that holds at least some lists.
+     * 
+     * @param size The number of lists wanted.
+     * @return The smallest power of two not below size if PowerOfTwo_, the
+     *         closest prime above size otherwise.
+     */
+    unsigned table_size(unsigned size) const;
+    /**
+     * @brief Checks if a node holds a key.
+     * 
+     * With StoreHash_ the stored hashes are compared first, so the key
+     * bytes are only compared when the hashes are equal.
+     * 
+     * @param node The node.
+     * @param Key The key.
+     * @param hash The full hash of the key (see full_hash).
+     * @return true if the node holds the key.
+     */
+    bool same_key(const ChHTNode *node, const char *Key, unsigned hash) const;
+    /**
+     * @brief Copies a key into a node.
+     * 
+     * Keys are compared over MAX_KEYLEN bytes, so a key that fills the
+     * buffer is kept whole without a NUL.
+     * 
+     * @param node The node.
+     * @param Key The key.
+     */
+    static void copy_key(ChHTNode *node, const char *Key);
 };
 
 #include "ChHashTable.cpp"
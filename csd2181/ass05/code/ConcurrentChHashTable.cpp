@@ -0,0 +1,421 @@
+/*!
+@file ConcurrentChHashTable.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the definition of the ConcurrentChHashTable class.
+*/
+#include "ConcurrentChHashTable.h"
+/**
+ * @brief Constructor for ConcurrentChHashTable class.
+ *
+ * Creates the shards, each with a prime number of lists close to its share
+ * of the initial table size.
+ *
+ * @param Config The configuration of each shard.
+ * @param Shards The number of shards, rounded up to a power of two.
+ */
+template <typename T>
+ConcurrentChHashTable<T>::ConcurrentChHashTable(const HTConfig &Config, unsigned Shards)
+    : count_(shard_count(Shards)), shift_(32), config_(Config), shards_(count_)
+{
+    for (unsigned n = count_; n > 1; n /= 2)
+    {
+        shift_--;
+    }
+    // if a table cannot be allocated, shards_ frees the ones already made
+    unsigned size = GetClosestPrime(config_.InitialTableSize_ / count_ + 1);
+    for (unsigned i = 0; i < count_; i++)
+    {
+        shards_[i].table.reset(new ChHTHeadNode[size]);
+        shards_[i].size = size;
+        shards_[i].count = 0;
+        shards_[i].expansions = 0;
+        shards_[i].probes = 0;
+        shards_[i].key_compares = 0;
+    }
+}
+/**
+ * @brief Destructor for ConcurrentChHashTable class.
+ *
+ * Frees every node. The lists go with the shards. No other thread may be
+ * using the table.
+ */
+template <typename T>
+ConcurrentChHashTable<T>::~ConcurrentChHashTable()
+{
+    for (unsigned i = 0; i < count_; i++)
+    {
+        clear_shard(shards_[i]);
+    }
+}
+/**
+ * @brief Inserts an element into the hash table.
+ *
+ * Locks the key's shard exclusively, grows it first if the insertion would
+ * pass the maximum load factor, and inserts at the head of the key's list.
+ *
+ * @param Key The key associated with the data to be inserted.
+ * @param Data The data to be inserted into the hash table.
+ * @throws HashTableException if the insertion fails due to a duplicate key or memory allocation failure.
+ */
+template <typename T>
+void ConcurrentChHashTable<T>::insert(const char *Key, const T &Data)
+{
+    unsigned hash = config_.HashFunc_(Key, FULL_HASH_RANGE);
+    Shard &shard = shard_of(hash);
+    std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+    double loadFactor = static_cast<double>(shard.count + 1) / static_cast<double>(shard.size);
+    if (loadFactor > config_.MaxLoadFactor_)
+    {
+        grow_shard(shard);
+    }
+    ChHTHeadNode &head = shard.table[hash % shard.size];
+    unsigned probes = 1;
+    unsigned compares = 0;
+    ChHTNode *found = search(head, Key, hash, probes, compares);
+    shard.probes.fetch_add(probes, std::memory_order_relaxed);
+    shard.key_compares.fetch_add(compares, std::memory_order_relaxed);
+    if (found)
+    {
+        throw HashTableException(HashTableException::E_DUPLICATE, "Duplicate key");
+    }
+    ChHTNode *node;
+    try
+    {
+        node = new ChHTNode(Data);
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    // keys are compared over MAX_KEYLEN bytes, so one that fills the buffer
+    // is kept whole without a NUL
+    std::size_t length = std::strlen(Key);
+    if (length > MAX_KEYLEN)
+    {
+        length = MAX_KEYLEN;
+    }
+    std::memcpy(node->Key, Key, length);
+    if (length < MAX_KEYLEN)
+    {
+        node->Key[length] = '\0';
+    }
+    node->Hash = hash;
+    node->Next = head.Nodes;
+    head.Nodes = node;
+    head.Count++;
+    shard.count++;
+}
+/**
+ * @brief Removes an element from the hash table.
+ *
+ * Locks the key's shard exclusively and unlinks the key's node, if any.
+ *
+ * @param Key The key of the element to be removed.
+ */
+template <typename T>
+void ConcurrentChHashTable<T>::remove(const char *Key)
+{
+    unsigned hash = config_.HashFunc_(Key, FULL_HASH_RANGE);
+    Shard &shard = shard_of(hash);
+    std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+    ChHTHeadNode &head = shard.table[hash % shard.size];
+    ChHTNode *node = head.Nodes;
+    ChHTNode *prev = nullptr;
+    unsigned probes = 0;
+    unsigned compares = 0;
+    while (node)
+    {
+        probes++;
+        if (node->Hash == hash)
+        {
+            compares++;
+            if (strncmp(node->Key, Key, MAX_KEYLEN) == 0)
+            {
+                if (prev)
+                {
+                    prev->Next = node->Next;
+                }
+                else
+                {
+                    head.Nodes = node->Next;
+                }
+                if (config_.FreeProc_)
+                {
+                    config_.FreeProc_(node->Data);
+                }
+                delete node;
+                head.Count--;
+                shard.count--;
+                break;
+            }
+        }
+        prev = node;
+        node = node->Next;
+    }
+    shard.probes.fetch_add(probes, std::memory_order_relaxed);
+    shard.key_compares.fetch_add(compares, std::memory_order_relaxed);
+}
+/**
+ * @brief Finds an element in the hash table.
+ *
+ * Locks the key's shard shared, so finds in the same shard run together,
+ * and copies the data out before unlocking.
+ *
+ * @param Key The key of the element to be found.
+ * @return A copy of the found element.
+ * @throws HashTableException if the element with the specified key is not found.
+ */
+template <typename T>
+T ConcurrentChHashTable<T>::find(const char *Key) const
+{
+    unsigned hash = config_.HashFunc_(Key, FULL_HASH_RANGE);
+    Shard &shard = shard_of(hash);
+    std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+    unsigned probes = 0;
+    unsigned compares = 0;
+    ChHTNode *found = search(shard.table[hash % shard.size], Key, hash, probes, compares);
+    shard.probes.fetch_add(probes, std::memory_order_relaxed);
+    shard.key_compares.fetch_add(compares, std::memory_order_relaxed);
+    if (!found)
+    {
+        throw HashTableException(HashTableException::E_ITEM_NOT_FOUND, "Item not found");
+    }
+    return found->Data;
+}
+/**
+ * @brief Clears the hash table.
+ *
+ * Removes all elements from the hash table, one shard at a time.
+ */
+template <typename T>
+void ConcurrentChHashTable<T>::clear()
+{
+    for (unsigned i = 0; i < count_; i++)
+    {
+        std::unique_lock<std::shared_timed_mutex> lock(shards_[i].lock);
+        clear_shard(shards_[i]);
+    }
+}
+/**
+ * @brief Gets the statistics of the hash table.
+ *
+ * Adds up the statistics of the shards, locking each one shared in turn, so
+ * the totals are exact when no other thread is writing.
+ *
+ * @return The statistics of the hash table.
+ */
+template <typename T>
+HTStats ConcurrentChHashTable<T>::GetStats() const
+{
+    HTStats stats;
+    stats.HashFunc_ = config_.HashFunc_;
+    stats.Allocator_ = 0;
+    for (unsigned i = 0; i < count_; i++)
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(shards_[i].lock);
+        stats.Count_ += shards_[i].count;
+        stats.TableSize_ += shards_[i].size;
+        stats.Expansions_ += shards_[i].expansions;
+        stats.Probes_ += shards_[i].probes.load(std::memory_order_relaxed);
+        stats.KeyCompares_ += shards_[i].key_compares.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+/**
+ * @brief Returns the number of shards.
+ *
+ * @return The number of shards.
+ */
+template <typename T>
+unsigned ConcurrentChHashTable<T>::shards() const
+{
+    return count_;
+}
+/**
+ * @brief Returns the shard that holds a key.
+ *
+ * Uses the top bits of the hash times 2^32 / phi, so the shard does not
+ * depend on the bits that pick the list within it.
+ *
+ * @param hash The full hash of the key.
+ * @return The shard.
+ */
+template <typename T>
+typename ConcurrentChHashTable<T>::Shard &ConcurrentChHashTable<T>::shard_of(unsigned hash) const
+{
+    if (count_ == 1)
+    {
+        return shards_[0];
+    }
+    return shards_[static_cast<unsigned>(hash * 2654435769u) >> shift_];
+}
+/**
+ * @brief Rounds a number of shards up to a power of two.
+ *
+ * @param Shards The number of shards asked for.
+ * @return The number of shards to use.
+ */
+template <typename T>
+unsigned ConcurrentChHashTable<T>::shard_count(unsigned Shards)
+{
+    unsigned count = 1;
+    while (count < Shards)
+    {
+        count *= 2;
+    }
+    return count;
+}
+/**
+ * @brief Searches one list for a key.
+ *
+ * Compares the stored hash of each node before its key.
+ *
+ * @param head The list.
+ * @param Key The key.
+ * @param hash The full hash of the key.
+ * @param probes Incremented once per node visited.
+ * @param compares Incremented once per key comparison.
+ * @return The node holding the key, or 0.
+ */
+template <typename T>
+typename ConcurrentChHashTable<T>::ChHTNode *ConcurrentChHashTable<T>::search(const ChHTHeadNode &head,
+                                                                              const char *Key, unsigned hash,
+                                                                              unsigned &probes, unsigned &compares)
+{
+    for (ChHTNode *node = head.Nodes; node; node = node->Next)
+    {
+        probes++;
+        if (node->Hash == hash)
+        {
+            compares++;
+            if (strncmp(node->Key, Key, MAX_KEYLEN) == 0)
+            {
+                return node;
+            }
+        }
+    }
+    return 0;
+}
+/**
+ * @brief Grows a shard.
+ *
+ * Allocates GrowthFactor_ times as many lists (rounded to a prime) and
+ * relinks every node by its stored hash.
+ *
+ * @param shard The shard.
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename T>
+void ConcurrentChHashTable<T>::grow_shard(Shard &shard)
+{
+    unsigned newSize = GetClosestPrime(static_cast<unsigned>(std::ceil(shard.size * config_.GrowthFactor_)));
+    ChHTHeadNode *newTable;
+    try
+    {
+        newTable = new ChHTHeadNode[newSize];
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    unsigned probes = 0;
+    for (unsigned i = 0; i < shard.size; i++)
+    {
+        ChHTNode *node = shard.table[i].Nodes;
+        while (node)
+        {
+            probes++;
+            ChHTNode *temp = node->Next;
+            ChHTHeadNode &head = newTable[node->Hash % newSize];
+            node->Next = head.Nodes;
+            head.Nodes = node;
+            head.Count++;
+            node = temp;
+        }
+    }
+    shard.table.reset(newTable);
+    shard.size = newSize;
+    shard.expansions++;
+    shard.probes.fetch_add(probes, std::memory_order_relaxed);
+}
+/**
+ * @brief Frees every node of a shard.
+ *
+ * @param shard The shard.
+ */
+template <typename T>
+void ConcurrentChHashTable<T>::clear_shard(Shard &shard)
+{
+    for (unsigned i = 0; i < shard.size; i++)
+    {
+        ChHTNode *node = shard.table[i].Nodes;
+        while (node)
+        {
+            ChHTNode *temp = node->Next;
+            if (config_.FreeProc_)
+            {
+                config_.FreeProc_(node->Data);
+            }
+            delete node;
+            node = temp;
+        }
+        shard.table[i].Nodes = nullptr;
+        shard.table[i].Count = 0;
+    }
+    shard.count = 0;
+}
+/**
+ * @brief Constructs the shards in storage aligned for them.
+ *
+ * @param count The number of shards.
+ */
+template <typename T>
+ConcurrentChHashTable<T>::ShardArray::ShardArray(unsigned count)
+    : storage_(new char[count * sizeof(Shard) + alignof(Shard) - 1]), shards_(nullptr), built_(0)
+{
+    std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage_.get());
+    address = (address + alignof(Shard) - 1) & ~static_cast<std::uintptr_t>(alignof(Shard) - 1);
+    shards_ = reinterpret_cast<Shard *>(address);
+    try
+    {
+        for (; built_ < count; built_++)
+        {
+            new (&shards_[built_]) Shard();
+        }
+    }
+    catch (...)
+    {
+        while (built_ > 0)
+        {
+            shards_[--built_].~Shard();
+        }
+        throw;
+    }
+}
+/**
+ * @brief Destroys the shards that were constructed.
+ */
+template <typename T>
+ConcurrentChHashTable<T>::ShardArray::~ShardArray()
+{
+    while (built_ > 0)
+    {
+        shards_[--built_].~Shard();
+    }
+}
+/**
+ * @brief Returns a shard.
+ *
+ * @param index The index of the shard.
+ * @return The shard.
+ */
+template <typename T>
+typename ConcurrentChHashTable<T>::Shard &ConcurrentChHashTable<T>::ShardArray::operator[](unsigned index) const
+{
+    return shards_[index];
+}
@@ -0,0 +1,160 @@
+/*!
+@file ConcurrentChHashTable.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the declaration of the ConcurrentChHashTable class,
+       a chained hash table split into independently locked shards.
+*/
+//---------------------------------------------------------------------------
+#ifndef CONCURRENTCHHASHTABLEH
+#define CONCURRENTCHHASHTABLEH
+//---------------------------------------------------------------------------
+
+#include "ChHashTable.h" // HTStats, HashTableException, ChHTNode, HTConfig
+#include <atomic>        // std::atomic
+#include <cstdint>       // std::uintptr_t
+#include <cstring>       // strncmp, std::strlen, std::memcpy
+#include <memory>        // std::unique_ptr
+#include <mutex>         // std::unique_lock
+#include <new>           // placement new
+#include <shared_mutex>  // std::shared_timed_mutex, std::shared_lock
+
+/*!
+  A chained hash table that many threads can use at once.
+
+  Keys are hashed once, for a table of FULL_HASH_RANGE, and the hash is kept
+  in the node. Its top bits pick one of a power of two number of shards, and
+  the hash modulo the shard's size picks a list within the shard. Every shard
+  has its own lists, load factor and growth, and its own reader-writer lock:
+  find takes it shared, so lookups only wait for writers to the same shard,
+  while insert, remove and growth take it exclusively.
+
+  find returns a copy of the data, since another thread may remove the item
+  as soon as the lock is released. Probe counts are kept per shard in
+  atomics and summed by GetStats.
+*/
+template <typename T>
+class ConcurrentChHashTable
+{
+  public:
+
+    typedef typename ChHashTable<T>::HTConfig HTConfig;
+    typedef typename ChHashTable<T>::ChHTNode ChHTNode;
+    typedef typename ChHashTable<T>::ChHTHeadNode ChHTHeadNode;
+
+      // Config: the configuration of each shard; InitialTableSize_ is split
+      // among the shards.
+      // Shards: the number of shards, rounded up to a power of two.
+    ConcurrentChHashTable(const HTConfig& Config, unsigned Shards = 16);
+    ~ConcurrentChHashTable();
+
+      // Insert a key/data pair into table. Throws an exception if the
+      // insertion is unsuccessful.(E_DUPLICATE, E_NO_MEMORY)
+    void insert(const char *Key, const T& Data);
+
+      // Delete an item by key. Does nothing if the key doesn't exist.
+    void remove(const char *Key);
+
+      // Find and return a copy of the data by key. throws exception if key
+      // doesn't exist. (E_ITEM_NOT_FOUND)
+    T find(const char *Key) const;
+
+      // Removes all items from the table (Doesn't deallocate table)
+    void clear();
+
+      // Returns the statistics of all shards added together.
+    HTStats GetStats() const;
+
+      // Returns the number of shards.
+    unsigned shards() const;
+
+  private:
+
+    //! One shard, aligned so that neighbouring shards' locks and counters
+    //! are on different cache lines
+    struct alignas(64) Shard
+    {
+      mutable std::shared_timed_mutex lock;          //!< Guards everything below
+      std::unique_ptr<ChHTHeadNode[]> table;         //!< The lists
+      unsigned size;                                 //!< Number of lists
+      unsigned count;                                //!< Number of items
+      unsigned expansions;                           //!< Times the shard grew
+      mutable std::atomic<unsigned> probes;          //!< Probes, also by readers
+      mutable std::atomic<unsigned> key_compares;    //!< Key comparisons
+    };
+
+    //! The shards, in storage aligned for them by hand, since new only
+    //! aligns to alignof(std::max_align_t) before C++17. Destroys every
+    //! shard it built, and with it the shard's lists.
+    class ShardArray
+    {
+      public:
+        explicit ShardArray(unsigned count);
+        ~ShardArray();
+        Shard &operator[](unsigned index) const;
+
+      private:
+        std::unique_ptr<char[]> storage_; // Room for the shards and alignment
+        Shard *shards_;                   // The first shard, inside storage_
+        unsigned built_;                  // Number of shards constructed
+
+        ShardArray(const ShardArray &) = delete;
+        ShardArray &operator=(const ShardArray &) = delete;
+    };
+
+    unsigned count_;     // Number of shards, a power of two
+    unsigned shift_;     // 32 - log2(count_)
+    HTConfig config_;    // Config of every shard
+    ShardArray shards_;  // The shards
+
+    ConcurrentChHashTable(const ConcurrentChHashTable &) = delete;
+    ConcurrentChHashTable &operator=(const ConcurrentChHashTable &) = delete;
+
+    /**
+     * @brief Returns the shard that holds a key.
+     *
+     * @param hash The full hash of the key.
+     * @return The shard.
+     */
+    Shard &shard_of(unsigned hash) const;
+    /**
+     * @brief Rounds a number of shards up to a power of two.
+     *
+     * @param Shards The number of shards asked for.
+     * @return The number of shards to use.
+     */
+    static unsigned shard_count(unsigned Shards);
+    /**
+     * @brief Searches one list for a key.
+     *
+     * @param head The list.
+     * @param Key The key.
+     * @param hash The full hash of the key.
+     * @param probes Incremented once per node visited.
+     * @param compares Incremented once per key comparison.
+     * @return The node holding the key, or 0.
+     */
+    static ChHTNode *search(const ChHTHeadNode &head, const char *Key, unsigned hash,
+                            unsigned &probes, unsigned &compares);
+    /**
+     * @brief Grows a shard. The caller holds its lock exclusively.
+     *
+     * @param shard The shard.
+     * @throws HashTableException if memory allocation fails.
+     */
+    void grow_shard(Shard &shard);
+    /**
+     * @brief Frees every node of a shard. The caller holds its lock exclusively.
+     *
+     * @param shard The shard.
+     */
+    void clear_shard(Shard &shard);
+};
+
+#include "ConcurrentChHashTable.cpp"
+
+#endif
@@ -0,0 +1,220 @@
+/*!
+@file HashFunctions.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the definition of the built-in HASHFUNCs.
+*/
+#include "HashFunctions.h"
+#include <cstring> // std::memcpy, std::strlen
+
+#if defined(__SIZEOF_INT128__)
+#define HASH_INT128
+__extension__ typedef unsigned __int128 uint128;
+#endif
+
+namespace
+{
+const unsigned XXH_PRIME1 = 2654435761u;
+const unsigned XXH_PRIME2 = 2246822519u;
+const unsigned XXH_PRIME3 = 3266489917u;
+const unsigned XXH_PRIME4 = 668265263u;
+const unsigned XXH_PRIME5 = 374761393u;
+
+const unsigned long long WY_SECRET0 = 0xa0761d6478bd642full;
+const unsigned long long WY_SECRET1 = 0xe7037ed1a0b428dbull;
+
+/**
+ * @brief Reads 4 bytes as a little-endian word.
+ *
+ * @param p The bytes.
+ * @return The word.
+ */
+unsigned long long read32(const unsigned char *p)
+{
+    return static_cast<unsigned long long>(p[0]) | static_cast<unsigned long long>(p[1]) << 8 |
+           static_cast<unsigned long long>(p[2]) << 16 | static_cast<unsigned long long>(p[3]) << 24;
+}
+/**
+ * @brief Reads 8 bytes as a little-endian word.
+ *
+ * @param p The bytes.
+ * @return The word.
+ */
+unsigned long long read64(const unsigned char *p)
+{
+    return read32(p) | read32(p + 4) << 32;
+}
+/**
+ * @brief Rotates a 32-bit word left.
+ *
+ * @param x The word.
+ * @param r The number of bits, 1 to 31.
+ * @return The rotated word.
+ */
+unsigned rotl32(unsigned x, unsigned r)
+{
+    return (x << r) | (x >> (32 - r));
+}
+/**
+ * @brief Mixes 4 bytes of input into an xxHash32 lane.
+ *
+ * @param lane The lane.
+ * @param input The bytes as a word.
+ * @return The new lane.
+ */
+unsigned xxh_round(unsigned lane, unsigned input)
+{
+    lane += input * XXH_PRIME2;
+    lane = rotl32(lane, 13);
+    return lane * XXH_PRIME1;
+}
+/**
+ * @brief Multiplies two 64-bit words into 128 bits.
+ *
+ * Uses the compiler's 128-bit integers when it has them, and four 32x32-bit
+ * products otherwise.
+ *
+ * @param a Receives the low 64 bits of a * b.
+ * @param b Receives the high 64 bits of a * b.
+ */
+void wy_mum(unsigned long long &a, unsigned long long &b)
+{
+#ifdef HASH_INT128
+    uint128 product = static_cast<uint128>(a) * b;
+    a = static_cast<unsigned long long>(product);
+    b = static_cast<unsigned long long>(product >> 64);
+#else
+    unsigned long long ha = a >> 32, la = a & 0xffffffffull;
+    unsigned long long hb = b >> 32, lb = b & 0xffffffffull;
+    unsigned long long hh = ha * hb, hl = ha * lb, lh = la * hb, ll = la * lb;
+    unsigned long long mid = (ll >> 32) + (hl & 0xffffffffull) + (lh & 0xffffffffull);
+    a = (mid << 32) | (ll & 0xffffffffull);
+    b = hh + (hl >> 32) + (lh >> 32) + (mid >> 32);
+#endif
+}
+/**
+ * @brief Multiplies two 64-bit words and folds the 128-bit product.
+ *
+ * @param a The first word.
+ * @param b The second word.
+ * @return The low 64 bits of a * b xor the high 64 bits.
+ */
+unsigned long long wy_mix(unsigned long long a, unsigned long long b)
+{
+    wy_mum(a, b);
+    return a ^ b;
+}
+} // namespace
+
+/**
+ * @brief Hashes a key with xxHash32.
+ *
+ * Keys of 16 bytes or more go through four lanes 16 bytes at a time; the
+ * rest of the key is mixed in 4 bytes, then 1 byte, at a time.
+ *
+ * @param Key The null-terminated key.
+ * @param TableSize The size of the table.
+ * @return The hash modulo TableSize.
+ */
+unsigned XXHash32(const char *Key, unsigned TableSize)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(Key);
+    std::size_t len = std::strlen(Key);
+    const unsigned char *end = p + len;
+    unsigned hash;
+    if (len >= 16)
+    {
+        unsigned v1 = XXH_PRIME1 + XXH_PRIME2;
+        unsigned v2 = XXH_PRIME2;
+        unsigned v3 = 0;
+        unsigned v4 = 0 - XXH_PRIME1;
+        for (; p + 16 <= end; p += 16)
+        {
+            v1 = xxh_round(v1, static_cast<unsigned>(read32(p)));
+            v2 = xxh_round(v2, static_cast<unsigned>(read32(p + 4)));
+            v3 = xxh_round(v3, static_cast<unsigned>(read32(p + 8)));
+            v4 = xxh_round(v4, static_cast<unsigned>(read32(p + 12)));
+        }
+        hash = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+    }
+    else
+    {
+        hash = XXH_PRIME5;
+    }
+    hash += static_cast<unsigned>(len);
+    for (; p + 4 <= end; p += 4)
+    {
+        hash += static_cast<unsigned>(read32(p)) * XXH_PRIME3;
+        hash = rotl32(hash, 17) * XXH_PRIME4;
+    }
+    for (; p < end; p++)
+    {
+        hash += *p * XXH_PRIME5;
+        hash = rotl32(hash, 11) * XXH_PRIME1;
+    }
+    hash ^= hash >> 15;
+    hash *= XXH_PRIME2;
+    hash ^= hash >> 13;
+    hash *= XXH_PRIME3;
+    hash ^= hash >> 16;
+    return hash % TableSize;
+}
+/**
+ * @brief Hashes a key with wyhash.
+ *
+ * A key of up to 16 bytes is read as two overlapping 64-bit words (up to 3
+ * bytes as one), so short keys take no loop at all. Longer keys are mixed
+ * 16 bytes at a time. The two words are multiplied with the secrets and the
+ * 64-bit result is folded to 32 bits.
+ *
+ * @param Key The null-terminated key.
+ * @param TableSize The size of the table.
+ * @return The hash modulo TableSize.
+ */
+unsigned WyHash(const char *Key, unsigned TableSize)
+{
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(Key);
+    std::size_t len = std::strlen(Key);
+    unsigned long long seed = wy_mix(WY_SECRET0, WY_SECRET1);
+    unsigned long long a;
+    unsigned long long b;
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            std::size_t shift = (len >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + shift);
+            b = (read32(p + len - 4) << 32) | read32(p + len - 4 - shift);
+        }
+        else if (len > 0)
+        {
+            a = static_cast<unsigned long long>(p[0]) << 16 | static_cast<unsigned long long>(p[len >> 1]) << 8 |
+                p[len - 1];
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        std::size_t left = len;
+        for (; left > 16; left -= 16, p += 16)
+        {
+            seed = wy_mix(read64(p) ^ WY_SECRET1, read64(p + 8) ^ seed);
+        }
+        a = read64(p + left - 16);
+        b = read64(p + left - 8);
+    }
+    a ^= WY_SECRET1;
+    b ^= seed;
+    wy_mum(a, b);
+    unsigned long long hash = wy_mix(a ^ WY_SECRET0 ^ len, b ^ WY_SECRET1);
+    return static_cast<unsigned>(hash ^ (hash >> 32)) % TableSize;
+}
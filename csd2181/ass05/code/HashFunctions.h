@@ -0,0 +1,35 @@
+/*!
+@file HashFunctions.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the declaration of built-in HASHFUNCs for the hash
+       tables: 32-bit xxHash and wyhash.
+*/
+//---------------------------------------------------------------------------
+#ifndef HASHFUNCTIONSH
+#define HASHFUNCTIONSH
+//---------------------------------------------------------------------------
+
+/*
+  Both functions have the HASHFUNC signature: they hash the bytes of a
+  null-terminated key and return the hash modulo TableSize. Passed
+  FULL_HASH_RANGE they return (almost) the whole 32-bit hash, which is what
+  ChHashTable uses with StoreHash_ or PowerOfTwo_.
+
+  Blocks of the key are read as little-endian words, so the values differ
+  from the reference implementations on big-endian machines.
+*/
+
+  // xxHash32 with seed 0: four 32-bit lanes for keys of 16 bytes or more,
+  // then 4-byte and 1-byte steps and an avalanche.
+unsigned XXHash32(const char *Key, unsigned TableSize);
+
+  // wyhash with seed 0 and one lane for long keys: 64x64->128-bit
+  // multiplies of 16-byte blocks, folded to 32 bits.
+unsigned WyHash(const char *Key, unsigned TableSize);
+
+#endif
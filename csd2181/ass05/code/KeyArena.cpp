@@ -0,0 +1,136 @@
+/*!
+@file KeyArena.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the definition of the KeyArena class.
+*/
+#include "KeyArena.h"
+#include <new>     // operator new
+#include <utility> // std::swap
+/**
+ * @brief Constructor for KeyArena class.
+ *
+ * Constructs an empty arena; no chunk is allocated until it is needed.
+ */
+KeyArena::KeyArena() : chunks_(nullptr), free_(nullptr), left_(0), used_(0), reserved_(0)
+{
+}
+/**
+ * @brief Destructor for KeyArena class.
+ *
+ * Frees every chunk.
+ */
+KeyArena::~KeyArena()
+{
+    clear();
+}
+/**
+ * @brief Allocates bytes for a key.
+ *
+ * Takes the bytes from the current chunk, starting a new chunk when it does
+ * not have enough left. A request longer than CHUNK_SIZE gets its own chunk.
+ *
+ * @param size The number of bytes.
+ * @return The bytes, valid until clear or destruction.
+ * @throws std::bad_alloc if memory allocation fails.
+ */
+char *KeyArena::allocate(std::size_t size)
+{
+    reserve(size);
+    char *bytes = free_;
+    free_ += size;
+    left_ -= size;
+    used_ += size;
+    return bytes;
+}
+/**
+ * @brief Makes room for later allocations.
+ *
+ * Starts a new chunk of at least size bytes when the current one does not
+ * have size bytes left, so allocations adding up to size cannot throw.
+ *
+ * @param size The number of bytes.
+ * @throws std::bad_alloc if memory allocation fails.
+ */
+void KeyArena::reserve(std::size_t size)
+{
+    if (size > left_)
+    {
+        std::size_t chunkSize = size > CHUNK_SIZE ? size : CHUNK_SIZE;
+        Chunk *chunk = static_cast<Chunk *>(::operator new(sizeof(Chunk) + chunkSize));
+        chunk->next = chunks_;
+        chunk->size = chunkSize;
+        chunks_ = chunk;
+        free_ = reinterpret_cast<char *>(chunk + 1);
+        left_ = chunkSize;
+        reserved_ += sizeof(Chunk) + chunkSize;
+    }
+}
+/**
+ * @brief Counts bytes as no longer used.
+ *
+ * The bytes stay in their chunk until clear or destruction; only used
+ * goes down.
+ *
+ * @param size The number of bytes, as passed to allocate.
+ */
+void KeyArena::release(std::size_t size)
+{
+    used_ -= size;
+}
+/**
+ * @brief Frees every chunk.
+ *
+ * Every pointer returned by allocate becomes invalid.
+ */
+void KeyArena::clear()
+{
+    while (chunks_)
+    {
+        Chunk *next = chunks_->next;
+        ::operator delete(chunks_);
+        chunks_ = next;
+    }
+    free_ = nullptr;
+    left_ = 0;
+    used_ = 0;
+    reserved_ = 0;
+}
+/**
+ * @brief Exchanges the chunks of two arenas.
+ *
+ * Pointers returned by either arena stay valid and now belong to the other.
+ *
+ * @param other The other arena.
+ */
+void KeyArena::swap(KeyArena &other)
+{
+    std::swap(chunks_, other.chunks_);
+    std::swap(free_, other.free_);
+    std::swap(left_, other.left_);
+    std::swap(used_, other.used_);
+    std::swap(reserved_, other.reserved_);
+}
+/**
+ * @brief Returns the number of bytes handed out and not released.
+ *
+ * @return The number of bytes handed out since the last clear, less those
+ *         released.
+ */
+std::size_t KeyArena::used() const
+{
+    return used_;
+}
+/**
+ * @brief Returns the number of bytes held in chunks.
+ *
+ * @return The size of every chunk, headers included.
+ */
+std::size_t KeyArena::reserved() const
+{
+    return reserved_;
+}
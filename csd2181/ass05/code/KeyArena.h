@@ -0,0 +1,76 @@
+/*!
+@file KeyArena.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the declaration of the KeyArena class, a bump
+       allocator for key bytes that do not fit inside a node.
+*/
+//---------------------------------------------------------------------------
+#ifndef KEYARENAH
+#define KEYARENAH
+//---------------------------------------------------------------------------
+
+#include <cstddef> // std::size_t
+
+/*!
+  Hands out memory for key bytes from large chunks.
+
+  Each allocation takes the next bytes of the current chunk, so keys stored
+  one after the other are packed together with no per-key header. Memory is
+  only given back all at once, by clear or the destructor; release only
+  counts bytes as dead, so the owner can tell when to copy its live keys
+  into a fresh arena and swap it in.
+*/
+class KeyArena
+{
+  public:
+    //! Size of a chunk; longer requests get a chunk of their own
+    static const std::size_t CHUNK_SIZE = 64 * 1024;
+
+    KeyArena();
+    ~KeyArena();
+
+      // Returns size bytes that stay valid until clear or destruction.
+    char *allocate(std::size_t size);
+
+      // Makes sure the next size bytes of allocations will not throw.
+    void reserve(std::size_t size);
+
+      // Counts size bytes from allocate as no longer used.
+    void release(std::size_t size);
+
+      // Frees every chunk.
+    void clear();
+
+      // Exchanges the chunks of two arenas.
+    void swap(KeyArena &other);
+
+      // Returns the number of bytes handed out and not released.
+    std::size_t used() const;
+
+      // Returns the number of bytes held in chunks.
+    std::size_t reserved() const;
+
+  private:
+    //! Header at the start of every chunk
+    struct Chunk
+    {
+      Chunk *next;      //!< The chunk allocated before this one
+      std::size_t size; //!< Bytes after the header
+    };
+
+    Chunk *chunks_;        // Most recent chunk first
+    char *free_;           // Next free byte of chunks_
+    std::size_t left_;     // Free bytes left in chunks_
+    std::size_t used_;     // Bytes handed out and not released
+    std::size_t reserved_; // Bytes held in chunks, headers included
+
+    KeyArena(const KeyArena &) = delete;
+    KeyArena &operator=(const KeyArena &) = delete;
+};
+
+#endif
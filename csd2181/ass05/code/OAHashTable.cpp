@@ -0,0 +1,460 @@
+/*!
+@file OAHashTable.cpp
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the definition of the OAHashTable class.
+*/
+#include "OAHashTable.h"
+/**
+ * @brief Constructor for OAHashTable class.
+ *
+ * Constructs an OAHashTable object with the given configuration. The table
+ * size is rounded up to a power of two number of groups.
+ *
+ * @param Config The configuration for the hash table.
+ */
+template <typename T>
+OAHashTable<T>::OAHashTable(const HTConfig &Config)
+    : control_(nullptr), control_base_(nullptr), slots_(nullptr), groups_(0), deleted_(0), stats_(nullptr),
+      config_(Config)
+{
+    if (!(config_.MaxLoadFactor_ > 0.0 && config_.MaxLoadFactor_ < 1.0))
+    {
+        config_.MaxLoadFactor_ = DEFAULT_MAX_LOAD;
+    }
+    if (!(config_.GrowthFactor_ > 1.0))
+    {
+        config_.GrowthFactor_ = DEFAULT_GROWTH;
+    }
+    stats_ = new HTStats();
+    stats_->HashFunc_ = config_.HashFunc_;
+    stats_->Allocator_ = 0;
+    allocate(groups_for(config_.InitialTableSize_));
+}
+/**
+ * @brief Destructor for OAHashTable class.
+ *
+ * Destructs the OAHashTable object and frees allocated memory.
+ */
+template <typename T>
+OAHashTable<T>::~OAHashTable()
+{
+    clear();
+    ::operator delete(control_base_);
+    ::operator delete(slots_);
+    delete stats_;
+}
+/**
+ * @brief Inserts an element into the hash table.
+ *
+ * Looks for the key along its probe sequence, remembering the first free
+ * slot passed, and stores the item there if the key is not found.
+ *
+ * @param Key The key associated with the data to be inserted.
+ * @param Data The data to be inserted into the hash table.
+ * @throws HashTableException if the insertion fails due to a duplicate key or memory allocation failure.
+ */
+template <typename T>
+void OAHashTable<T>::insert(const char *Key, const T &Data)
+{
+    double used = static_cast<double>(stats_->Count_ + deleted_ + 1);
+    if (used > config_.MaxLoadFactor_ * static_cast<double>(stats_->TableSize_))
+    {
+        grow_table();
+    }
+    unsigned group;
+    signed char tag;
+    hash(Key, group, tag);
+    unsigned target = stats_->TableSize_;
+    for (unsigned step = 1;; ++step)
+    {
+        stats_->Probes_++;
+        unsigned first = group * GROUP_SIZE;
+        for (unsigned bits = match(group, tag); bits; bits &= bits - 1)
+        {
+            unsigned slot = first + lowest_bit(bits);
+            stats_->Probes_++;
+            stats_->KeyCompares_++;
+            if (strncmp(slots_[slot].Key, Key, MAX_KEYLEN) == 0)
+            {
+                throw HashTableException(HashTableException::E_DUPLICATE, "Duplicate key");
+            }
+        }
+        unsigned vacant = match_free(group);
+        if (target == stats_->TableSize_ && vacant)
+        {
+            target = first + lowest_bit(vacant);
+        }
+        if (match(group, EMPTY))
+        {
+            break;
+        }
+        group = (group + step) & (groups_ - 1);
+    }
+    try
+    {
+        new (&slots_[target]) OAHTSlot(Data);
+    }
+    catch (const std::bad_alloc &e)
+    {
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    // keys are compared over MAX_KEYLEN bytes, so one that fills the buffer
+    // is kept whole without a NUL
+    std::size_t length = std::strlen(Key);
+    if (length > MAX_KEYLEN)
+    {
+        length = MAX_KEYLEN;
+    }
+    std::memcpy(slots_[target].Key, Key, length);
+    if (length < MAX_KEYLEN)
+    {
+        slots_[target].Key[length] = '\0';
+    }
+    if (control_[target] == DELETED)
+    {
+        deleted_--;
+    }
+    control_[target] = tag;
+    stats_->Count_++;
+}
+/**
+ * @brief Removes an element from the hash table.
+ *
+ * Removes the element with the specified key from the hash table. The slot
+ * becomes EMPTY if its group was never full, since then no probe sequence
+ * passes through the group, and DELETED otherwise.
+ *
+ * @param Key The key of the element to be removed.
+ */
+template <typename T>
+void OAHashTable<T>::remove(const char *Key)
+{
+    unsigned slot = find_slot(Key);
+    if (slot == stats_->TableSize_)
+    {
+        return;
+    }
+    if (config_.FreeProc_)
+    {
+        config_.FreeProc_(slots_[slot].Data);
+    }
+    slots_[slot].~OAHTSlot();
+    if (match(slot / GROUP_SIZE, EMPTY))
+    {
+        control_[slot] = EMPTY;
+    }
+    else
+    {
+        control_[slot] = DELETED;
+        deleted_++;
+    }
+    stats_->Count_--;
+}
+/**
+ * @brief Finds an element in the hash table.
+ *
+ * Finds and returns the element with the specified key from the hash table.
+ *
+ * @param Key The key of the element to be found.
+ * @return The reference to the found element.
+ * @throws HashTableException if the element with the specified key is not found.
+ */
+template <typename T>
+const T &OAHashTable<T>::find(const char *Key) const
+{
+    unsigned slot = find_slot(Key);
+    if (slot == stats_->TableSize_)
+    {
+        throw HashTableException(HashTableException::E_ITEM_NOT_FOUND, "Item not found");
+    }
+    return slots_[slot].Data;
+}
+/**
+ * @brief Clears the hash table.
+ *
+ * Removes all elements from the hash table and marks every slot EMPTY.
+ */
+template <typename T>
+void OAHashTable<T>::clear()
+{
+    for (unsigned i = 0; i < stats_->TableSize_; i++)
+    {
+        if (control_[i] >= 0)
+        {
+            if (config_.FreeProc_)
+            {
+                config_.FreeProc_(slots_[i].Data);
+            }
+            slots_[i].~OAHTSlot();
+        }
+        control_[i] = EMPTY;
+    }
+    deleted_ = 0;
+    stats_->Count_ = 0;
+}
+/**
+ * @brief Gets the statistics of the hash table.
+ *
+ * Returns the statistics of the hash table.
+ *
+ * @return The statistics of the hash table.
+ */
+template <typename T>
+HTStats OAHashTable<T>::GetStats() const
+{
+    return *stats_;
+}
+/**
+ * @brief Hashes a key.
+ *
+ * Calls the client hash with FULL_HASH_RANGE as the table size and
+ * multiplies the result by 2^64 / phi, so every bit of the product depends on
+ * the hash. The top 7 bits become the control byte and the bits below them
+ * pick the first group.
+ *
+ * @param Key The key.
+ * @param group Receives the first group to probe.
+ * @param tag Receives the 7 hash bits stored in the control byte.
+ */
+template <typename T>
+void OAHashTable<T>::hash(const char *Key, unsigned &group, signed char &tag) const
+{
+    std::uint64_t mixed = static_cast<std::uint64_t>(config_.HashFunc_(Key, FULL_HASH_RANGE)) * 0x9E3779B97F4A7C15ull;
+    tag = static_cast<signed char>(mixed >> 57);
+    group = static_cast<unsigned>(mixed >> 25) & (groups_ - 1);
+}
+/**
+ * @brief Finds the slots of a group whose control byte equals a value.
+ *
+ * With SSE2 the whole group is compared in one instruction and the sign bits
+ * of the result are gathered into the mask.
+ *
+ * @param group Index of the group.
+ * @param value The control byte to look for.
+ * @return A bit mask with bit i set if slot i of the group matches.
+ */
+template <typename T>
+unsigned OAHashTable<T>::match(unsigned group, signed char value) const
+{
+    const signed char *control = control_ + group * GROUP_SIZE;
+#ifdef OAHT_SSE2
+    __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i *>(control));
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+    unsigned bits = 0;
+    for (unsigned i = 0; i < GROUP_SIZE; i++)
+    {
+        if (control[i] == value)
+        {
+            bits |= 1u << i;
+        }
+    }
+    return bits;
+#endif
+}
+/**
+ * @brief Finds the EMPTY and DELETED slots of a group.
+ *
+ * Both markers are negative and hash bits are not, so the sign bits of the
+ * control bytes are the answer.
+ *
+ * @param group Index of the group.
+ * @return A bit mask with bit i set if slot i of the group is free.
+ */
+template <typename T>
+unsigned OAHashTable<T>::match_free(unsigned group) const
+{
+    const signed char *control = control_ + group * GROUP_SIZE;
+#ifdef OAHT_SSE2
+    return static_cast<unsigned>(_mm_movemask_epi8(_mm_load_si128(reinterpret_cast<const __m128i *>(control))));
+#else
+    unsigned bits = 0;
+    for (unsigned i = 0; i < GROUP_SIZE; i++)
+    {
+        if (control[i] < 0)
+        {
+            bits |= 1u << i;
+        }
+    }
+    return bits;
+#endif
+}
+/**
+ * @brief Returns the index of the lowest set bit.
+ *
+ * @param bits A non-zero bit mask.
+ * @return The index of its lowest set bit.
+ */
+template <typename T>
+unsigned OAHashTable<T>::lowest_bit(unsigned bits)
+{
+#if defined(__GNUC__)
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#else
+    unsigned index = 0;
+    while (!(bits & 1u))
+    {
+        bits >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+/**
+ * @brief Finds the slot that holds a key.
+ *
+ * Probes the groups in triangular order, comparing keys only in slots whose
+ * control byte matches, until the key or a group with an EMPTY slot is found.
+ *
+ * @param Key The key.
+ * @return Index of the slot, or the table size if the key is not found.
+ */
+template <typename T>
+unsigned OAHashTable<T>::find_slot(const char *Key) const
+{
+    unsigned group;
+    signed char tag;
+    hash(Key, group, tag);
+    for (unsigned step = 1; step <= groups_; ++step)
+    {
+        stats_->Probes_++;
+        unsigned first = group * GROUP_SIZE;
+        for (unsigned bits = match(group, tag); bits; bits &= bits - 1)
+        {
+            unsigned slot = first + lowest_bit(bits);
+            stats_->Probes_++;
+            stats_->KeyCompares_++;
+            if (strncmp(slots_[slot].Key, Key, MAX_KEYLEN) == 0)
+            {
+                return slot;
+            }
+        }
+        if (match(group, EMPTY))
+        {
+            break;
+        }
+        group = (group + step) & (groups_ - 1);
+    }
+    return stats_->TableSize_;
+}
+/**
+ * @brief Allocates the control bytes and slots for a number of groups.
+ *
+ * Every slot starts EMPTY; slots are constructed only when an item is stored.
+ *
+ * @param groups Number of groups.
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename T>
+void OAHashTable<T>::allocate(unsigned groups)
+{
+    unsigned size = groups * GROUP_SIZE;
+    signed char *base = nullptr;
+    try
+    {
+        // groups are loaded with aligned 16-byte loads
+        base = static_cast<signed char *>(::operator new(size + GROUP_SIZE));
+        slots_ = static_cast<OAHTSlot *>(::operator new(sizeof(OAHTSlot) * size));
+    }
+    catch (const std::bad_alloc &e)
+    {
+        ::operator delete(base);
+        throw HashTableException(HashTableException::E_NO_MEMORY, "No memory");
+    }
+    std::size_t misalign = reinterpret_cast<std::uintptr_t>(base) % GROUP_SIZE;
+    control_base_ = base;
+    control_ = base + (misalign ? GROUP_SIZE - misalign : 0);
+    std::memset(control_, EMPTY, size);
+    groups_ = groups;
+    stats_->TableSize_ = size;
+}
+/**
+ * @brief Grows the hash table.
+ *
+ * Allocates a table GrowthFactor_ times larger and moves every item into its
+ * first free slot there. If at least half of the used slots are DELETED the
+ * table is rebuilt at the same size instead, which only clears them.
+ *
+ * @throws HashTableException if memory allocation fails.
+ */
+template <typename T>
+void OAHashTable<T>::grow_table()
+{
+    signed char *oldControl = control_;
+    signed char *oldBase = control_base_;
+    OAHTSlot *oldSlots = slots_;
+    unsigned oldSize = stats_->TableSize_;
+    unsigned oldGroups = groups_;
+    unsigned groups = groups_;
+    if (deleted_ < stats_->Count_)
+    {
+        groups = groups_for(std::ceil(oldSize * config_.GrowthFactor_));
+        // a factor that rounds back to oldSize would rebuild at the same size
+        if (groups <= groups_)
+        {
+            groups = groups_ * 2;
+        }
+    }
+    try
+    {
+        allocate(groups);
+    }
+    catch (HashTableException &e)
+    {
+        control_ = oldControl;
+        control_base_ = oldBase;
+        slots_ = oldSlots;
+        groups_ = oldGroups;
+        stats_->TableSize_ = oldSize;
+        throw e;
+    }
+    for (unsigned i = 0; i < oldSize; i++)
+    {
+        if (oldControl[i] >= 0)
+        {
+            stats_->Probes_++;
+            unsigned group;
+            signed char tag;
+            hash(oldSlots[i].Key, group, tag);
+            unsigned vacant = match_free(group);
+            for (unsigned step = 1; !vacant; ++step)
+            {
+                group = (group + step) & (groups_ - 1);
+                vacant = match_free(group);
+            }
+            unsigned slot = group * GROUP_SIZE + lowest_bit(vacant);
+            new (&slots_[slot]) OAHTSlot(oldSlots[i].Data);
+            std::memcpy(slots_[slot].Key, oldSlots[i].Key, MAX_KEYLEN);
+            control_[slot] = tag;
+            oldSlots[i].~OAHTSlot();
+        }
+    }
+    ::operator delete(oldBase);
+    ::operator delete(oldSlots);
+    deleted_ = 0;
+    if (groups != oldGroups)
+    {
+        stats_->Expansions_++;
+    }
+}
+/**
+ * @brief Returns the number of groups needed for a number of slots.
+ *
+ * @param slots Number of slots.
+ * @return The smallest power of two number of groups that holds slots.
+ */
+template <typename T>
+unsigned OAHashTable<T>::groups_for(double slots)
+{
+    unsigned groups = 1;
+    while (static_cast<double>(groups) * GROUP_SIZE < slots)
+    {
+        groups *= 2;
+    }
+    return groups;
+}
@@ -0,0 +1,207 @@
+/*!
+@file OAHashTable.h
+@author Wei Jingsong (jingsong.wei@digipen.edu)
+@SIT id 2200646
+@course csd2183
+@section A
+@assignment 5
+@date 10/19/2026
+@brief This file contains the declaration of the OAHashTable class, an
+       open-addressing hash table with the ChHashTable interface.
+*/
+//---------------------------------------------------------------------------
+#ifndef OAHASHTABLEH
+#define OAHASHTABLEH
+//---------------------------------------------------------------------------
+
+#include "ChHashTable.h" // HASHFUNC, MAX_KEYLEN, HTStats, HashTableException
+#include <cstddef>       // std::size_t
+#include <cstdint>       // std::uint64_t, std::uintptr_t
+#include <cstring>       // strncmp, std::strlen, std::memcpy, std::memset
+#include <new>           // placement new, std::bad_alloc
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OAHT_SSE2
+#include <emmintrin.h>   // _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+/*!
+  An open-addressing hash table in the style of SwissTable.
+
+  Keys and data live inline in one slot array, so a lookup touches no nodes.
+  Slots are grouped in runs of GROUP_SIZE. Next to the slots is one control
+  byte per slot: EMPTY, DELETED, or 7 bits of the key's hash. A probe
+  loads a whole group of control bytes and compares all of them against the
+  hash bits at once (one SSE2 compare when available), and only slots whose
+  byte matches have their keys compared. Groups are probed in triangular
+  order, and a lookup stops at the first group that still has an EMPTY slot.
+
+  The client HASHFUNC is called with FULL_HASH_RANGE as the table size, and
+  the result is mixed to pick the first group and the 7 hash bits.
+
+  MaxLoadFactor_ must be below 1 (the slots are the table); larger values are
+  reduced to DEFAULT_MAX_LOAD. GrowthFactor_ must be above 1; other values
+  are replaced by DEFAULT_GROWTH. Probes_ counts one per group inspected plus
+  one per key compared; KeyCompares_ counts the keys compared.
+*/
+template <typename T>
+class OAHashTable
+{
+  public:
+
+    typedef void (*FREEPROC)(T); // client-provided free proc (we own the data)
+
+    //! Number of slots that share one probe
+    static const unsigned GROUP_SIZE = 16;
+    //! Load factor used when the configured one is not below 1
+    static const double DEFAULT_MAX_LOAD;
+    //! Growth factor used when the configured one is not above 1
+    static const double DEFAULT_GROWTH;
+
+    struct HTConfig
+    {
+        HTConfig(unsigned InitialTableSize,
+                 HASHFUNC HashFunc,
+                 double MaxLoadFactor = 0.875,
+                 double GrowthFactor = 2.0,
+                 FREEPROC FreeProc = 0) :
+
+        // The number of slots in the table initially.
+        InitialTableSize_(InitialTableSize),
+        // The hash function used in all cases.
+        HashFunc_(HashFunc),
+        // The maximum fraction of slots in use (including deleted slots).
+        MaxLoadFactor_(MaxLoadFactor),
+        // The factor by which the table grows.
+        GrowthFactor_(GrowthFactor),
+        // The method provided by the client that may need to be called when
+        // data in the table is removed.
+        FreeProc_(FreeProc) {}
+
+      unsigned InitialTableSize_;
+      HASHFUNC HashFunc_;
+      double MaxLoadFactor_;
+      double GrowthFactor_;
+      FREEPROC FreeProc_;
+    };
+
+      // A key/data pair stored inline in the table
+    struct OAHTSlot
+    {
+      char Key[MAX_KEYLEN]; // Key is a string
+      T Data;               // Client data
+      OAHTSlot(const T& data) : Data(data) {}; // constructor
+    };
+
+      // Config: the configuration for the hash table.
+    OAHashTable(const HTConfig& Config);
+    ~OAHashTable();
+
+      // Insert a key/data pair into table. Throws an exception if the
+      // insertion is unsuccessful.(E_DUPLICATE, E_NO_MEMORY)
+    void insert(const char *Key, const T& Data);
+
+      // Delete an item by key. Throws an exception if the key doesn't exist.
+      // (E_ITEM_NOT_FOUND)
+    void remove(const char *Key);
+
+      // Find and return data by key. throws exception if key doesn't exist.
+      // (E_ITEM_NOT_FOUND)
+    const T& find(const char *Key) const;
+
+      // Removes all items from the table (Doesn't deallocate table)
+    void clear();
+
+      // Returns a struct that contains information on the status of the table.
+    HTStats GetStats() const;
+
+  private:
+
+    //! Control byte of a slot that was never used
+    static const signed char EMPTY = -128;
+    //! Control byte of a slot whose item was removed
+    static const signed char DELETED = -2;
+
+    signed char *control_;      // One control byte per slot, 16-byte aligned
+    signed char *control_base_; // The allocation holding control_
+    OAHTSlot *slots_;           // The slots (constructed only where in use)
+    unsigned groups_;           // Number of groups, a power of two
+    unsigned deleted_;          // Number of DELETED slots
+    HTStats *stats_;            // Stats
+    HTConfig config_;           // Config
+
+    OAHashTable(const OAHashTable &) = delete;
+    OAHashTable &operator=(const OAHashTable &) = delete;
+
+    /**
+     * @brief Hashes a key.
+     *
+     * Calls the client hash and mixes the result so the group index and the
+     * 7 control bits come from different bits.
+     *
+     * @param Key The key.
+     * @param group Receives the first group to probe.
+     * @param tag Receives the 7 hash bits stored in the control byte.
+     */
+    void hash(const char *Key, unsigned &group, signed char &tag) const;
+    /**
+     * @brief Finds the slots of a group whose control byte equals a value.
+     *
+     * @param group Index of the group.
+     * @param value The control byte to look for.
+     * @return A bit mask with bit i set if slot i of the group matches.
+     */
+    unsigned match(unsigned group, signed char value) const;
+    /**
+     * @brief Finds the EMPTY and DELETED slots of a group.
+     *
+     * @param group Index of the group.
+     * @return A bit mask with bit i set if slot i of the group is free.
+     */
+    unsigned match_free(unsigned group) const;
+    /**
+     * @brief Returns the index of the lowest set bit.
+     *
+     * @param bits A non-zero bit mask.
+     * @return The index of its lowest set bit.
+     */
+    static unsigned lowest_bit(unsigned bits);
+    /**
+     * @brief Finds the slot that holds a key.
+     *
+     * @param Key The key.
+     * @return Index of the slot, or the table size if the key is not found.
+     */
+    unsigned find_slot(const char *Key) const;
+    /**
+     * @brief Allocates the control bytes and slots for a number of groups.
+     *
+     * @param groups Number of groups.
+     * @throws HashTableException if memory allocation fails.
+     */
+    void allocate(unsigned groups);
+    /**
+     * @brief Grows the hash table.
+     *
+     * Allocates a larger table and moves every item into it.
+     *
+     * @throws HashTableException if memory allocation fails.
+     */
+    void grow_table();
+    /**
+     * @brief Returns the number of groups needed for a number of slots.
+     *
+     * @param slots Number of slots.
+     * @return The smallest power of two number of groups that holds slots.
+     */
+    static unsigned groups_for(double slots);
+};
+
+template <typename T>
+const double OAHashTable<T>::DEFAULT_MAX_LOAD = 0.875;
+template <typename T>
+const double OAHashTable<T>::DEFAULT_GROWTH = 2.0;
+
+#include "OAHashTable.cpp"
+
+#endif
@@ -0,0 +1,881 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+
+#include "ChHashTable.h"
+#include "OAHashTable.h"
+#include "ConcurrentChHashTable.h"
+#include "ChHashMap.h"
+#include "HashFunctions.h"
+#include "ChHashSnapshot.h"
+
+unsigned gCount = 1000000; // number of keys inserted by each workload
+unsigned gMaxThreads = 0;  // 0 means std::thread::hardware_concurrency()
+
+using std::cout;
+using std::endl;
+
+//*********************************************************************
+// Helpers
+//*********************************************************************
+typedef std::chrono::steady_clock Clock;
+
+double ElapsedMs(Clock::time_point start)
+{
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// 32-bit FNV-1a, reduced to the table size
+unsigned FNVHash(const char *Key, unsigned TableSize)
+{
+  unsigned hash = 2166136261u;
+  while (*Key)
+  {
+    hash ^= static_cast<unsigned char>(*Key++);
+    hash *= 16777619u;
+  }
+  return hash % TableSize;
+}
+
+// hash * 31 + character, reduced to the table size
+unsigned Poly31Hash(const char *Key, unsigned TableSize)
+{
+  unsigned hash = 0;
+  while (*Key)
+    hash = hash * 31 + static_cast<unsigned char>(*Key++);
+  return hash % TableSize;
+}
+
+unsigned gHashCalls = 0; // calls to CountedHash
+
+// FNVHash, counting its calls
+unsigned CountedHash(const char *Key, unsigned TableSize)
+{
+  gHashCalls++;
+  return FNVHash(Key, TableSize);
+}
+
+// count keys "000000000", "000000001", ... in random order (the keys of
+// Test8 in driver-sample.cpp); prefix 'X' makes keys that are never inserted
+std::vector<std::string> MakeKeys(unsigned count, char prefix, unsigned seed)
+{
+  std::vector<std::string> keys(count);
+  char buf[16];
+  for (unsigned i = 0; i < count; i++)
+  {
+    std::sprintf(buf, "%c%08u", prefix, i);
+    keys[i] = buf;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(seed));
+  return keys;
+}
+
+// count distinct random lowercase words of 4 to 9 letters
+std::vector<std::string> MakeWords(unsigned count, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::vector<std::string> words;
+  words.reserve(count);
+  while (words.size() < count)
+  {
+    unsigned length = 4 + static_cast<unsigned>(rng() % 6);
+    std::string word(length, 'a');
+    for (unsigned i = 0; i < length; i++)
+      word[i] = static_cast<char>('a' + rng() % 26);
+    words.push_back(word);
+    if (words.size() == count)
+    {
+      std::sort(words.begin(), words.end());
+      words.erase(std::unique(words.begin(), words.end()), words.end());
+    }
+  }
+  std::shuffle(words.begin(), words.end(), rng);
+  return words;
+}
+
+// count identifiers "obj0", "obj1", ... with the number in base 36, in order
+std::vector<std::string> MakeIds(unsigned count)
+{
+  const char *digits = "0123456789abcdefghijklmnopqrstuvwxyz";
+  std::vector<std::string> ids(count);
+  for (unsigned i = 0; i < count; i++)
+  {
+    std::string number;
+    unsigned n = i;
+    do
+    {
+      number.insert(number.begin(), digits[n % 36]);
+      n /= 36;
+    } while (n);
+    ids[i] = "obj" + number;
+  }
+  return ids;
+}
+
+// Bytes used by the table: heads plus one node per item
+size_t TableBytes(const ChHashTable<int> &table)
+{
+  HTStats stats = table.GetStats();
+  return stats.TableSize_ * sizeof(ChHashTable<int>::ChHTHeadNode) +
+         stats.Count_ * sizeof(ChHashTable<int>::ChHTNode);
+}
+
+// Bytes used by the table: one slot and one control byte per slot
+size_t TableBytes(const OAHashTable<int> &table)
+{
+  HTStats stats = table.GetStats();
+  return stats.TableSize_ * (sizeof(OAHashTable<int>::OAHTSlot) + 1);
+}
+
+// Bytes used by the map: heads, one node per item and the key arena
+template <typename K>
+size_t TableBytes(const ChHashMap<K, int> &table)
+{
+  return table.memory();
+}
+
+// Thread counts 1, 2, 4, ... up to the number of cores (at least 4 so
+// oversubscription is visible on small machines).
+std::vector<unsigned> ThreadCounts(void)
+{
+  unsigned max_threads = gMaxThreads;
+  if (max_threads == 0)
+    max_threads = std::max(4u, std::thread::hardware_concurrency());
+
+  std::vector<unsigned> counts;
+  for (unsigned t = 1; t <= max_threads; t *= 2)
+    counts.push_back(t);
+  return counts;
+}
+
+//*********************************************************************
+// End Helpers
+//*********************************************************************
+
+// Nanoseconds per operation
+double PerOp(double ms, size_t ops)
+{
+  return ms * 1000000.0 / static_cast<double>(ops);
+}
+
+// Inserts count keys, looks them all up, looks up keys that are not there,
+// removes half of them and looks the rest up again. Prints the time per
+// operation of each step.
+template <typename Table>
+void Workload(const char *label, Table &table, size_t count,
+              const std::vector<std::string> &keys, const std::vector<std::string> &misses)
+{
+  HTStats initial = table.GetStats();
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < count; i++)
+    table.insert(keys[i].c_str(), static_cast<int>(i));
+  double insert_ms = ElapsedMs(start);
+  HTStats built = table.GetStats();
+
+  long sum = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < count; i++)
+    sum += table.find(keys[i].c_str());
+  double hit_ms = ElapsedMs(start);
+  unsigned hit_probes = table.GetStats().Probes_ - built.Probes_;
+
+  unsigned missed = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < misses.size(); i++)
+  {
+    try
+    {
+      sum += table.find(misses[i].c_str());
+    }
+    catch (const HashTableException &)
+    {
+      missed++;
+    }
+  }
+  double miss_ms = ElapsedMs(start);
+
+  size_t half = count / 2;
+  start = Clock::now();
+  for (size_t i = 0; i < half; i++)
+    table.remove(keys[i].c_str());
+  double remove_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  for (size_t i = half; i < count; i++)
+    sum += table.find(keys[i].c_str());
+  double after_ms = ElapsedMs(start);
+
+  bool right = missed == misses.size() && sum > 0 && built.Expansions_ == initial.Expansions_;
+  cout << std::left << std::setw(10) << label << std::right
+       << std::setw(7) << static_cast<double>(built.Count_) / built.TableSize_
+       << std::setw(9) << PerOp(insert_ms, count)
+       << std::setw(9) << PerOp(hit_ms, count)
+       << std::setw(9) << PerOp(miss_ms, misses.size())
+       << std::setw(9) << PerOp(remove_ms, half)
+       << std::setw(9) << PerOp(after_ms, count - half)
+       << std::setw(9) << static_cast<double>(hit_probes) / static_cast<double>(count)
+       << std::setw(8) << static_cast<double>(TableBytes(table)) / table.GetStats().Count_
+       << (right ? "" : "  WRONG")
+       << endl;
+}
+
+// Both tables get about gCount slots and are filled to each load factor
+// without growing, so every row measures one load factor.
+void TestOpenAddressing(void)
+{
+  unsigned slots = 1;
+  while (slots < gCount)
+    slots *= 2;
+  unsigned buckets = GetClosestPrime(slots);
+
+  cout << "\n========== Open addressing vs chaining (" << slots << " slots) ==========\n";
+  cout << "Time in ns per operation. 'after' is a hit once half the keys are removed;\n"
+          "bytes are per key left after the removals.\n";
+
+  const double chained_loads[] = {0.5, 1.0, 2.0, 3.0};
+  const double open_loads[] = {0.5, 0.75, 0.875, 0.95};
+  std::vector<std::string> keys = MakeKeys(3 * buckets, '0', 1);
+  std::vector<std::string> misses = MakeKeys(slots / 4, 'X', 2);
+
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(10) << "table" << std::right << std::setw(7) << "load"
+       << std::setw(9) << "insert" << std::setw(9) << "hit" << std::setw(9) << "miss"
+       << std::setw(9) << "remove" << std::setw(9) << "after"
+       << std::setw(9) << "probes" << std::setw(8) << "bytes" << endl;
+
+  for (size_t i = 0; i < sizeof(chained_loads) / sizeof(*chained_loads); i++)
+  {
+    double load = chained_loads[i];
+    ChHashTable<int> table(ChHashTable<int>::HTConfig(buckets, FNVHash, load + 0.01, 2.0));
+    Workload("chained", table, static_cast<size_t>(load * buckets), keys, misses);
+  }
+
+  for (size_t i = 0; i < sizeof(open_loads) / sizeof(*open_loads); i++)
+  {
+    double load = open_loads[i];
+    OAHashTable<int> table(OAHashTable<int>::HTConfig(slots, FNVHash, load + 0.01, 2.0));
+    Workload("open", table, static_cast<size_t>(load * slots), keys, misses);
+  }
+
+  cout << "\nprobes: chained counts nodes visited per hit; open counts groups\n"
+          "inspected plus keys compared.\n";
+}
+
+// Prints percentiles of the time each insert took while a table grows from
+// 17 lists to hold every key.
+void InsertLatency(const char *label, unsigned step, const std::vector<std::string> &keys)
+{
+  ChHashTable<int> table(ChHashTable<int>::HTConfig(17, FNVHash, 3.0, 2.0, 0, step));
+  std::vector<double> times(keys.size());
+  Clock::time_point begin = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    Clock::time_point start = Clock::now();
+    table.insert(keys[i].c_str(), static_cast<int>(i));
+    times[i] = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+  }
+  double total_ms = ElapsedMs(begin);
+  std::sort(times.begin(), times.end());
+
+  const double percentiles[] = {0.5, 0.99, 0.999, 0.9999};
+  cout << std::left << std::setw(14) << label << std::right << std::setw(10) << total_ms;
+  for (size_t i = 0; i < sizeof(percentiles) / sizeof(*percentiles); i++)
+    cout << std::setw(10) << times[static_cast<size_t>(percentiles[i] * static_cast<double>(times.size() - 1))];
+  cout << std::setw(11) << times.back()
+       << std::setw(6) << table.GetStats().Expansions_ << endl;
+}
+
+void TestIncrementalRehash(void)
+{
+  cout << "\n========== Insert latency while growing (" << gCount << " keys) ==========\n";
+  cout << "Total in ms, percentiles of one insert in us. 'step' is RehashStep_.\n";
+
+  std::vector<std::string> keys = MakeKeys(gCount, '0', 3);
+
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(14) << "mode" << std::right << std::setw(10) << "total"
+       << std::setw(10) << "p50" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+       << std::setw(10) << "p99.99" << std::setw(11) << "max" << std::setw(6) << "grew" << endl;
+
+  InsertLatency("one pass", 0, keys);
+  InsertLatency("step 1", 1, keys);
+  InsertLatency("step 4", 4, keys);
+  InsertLatency("step 16", 16, keys);
+}
+
+// Grows a table from 17 lists to hold every key, then looks every key and as
+// many missing keys up. Prints times and the work the table did.
+void HashCacheWorkload(const char *label, bool store_hash,
+                       const std::vector<std::string> &keys, const std::vector<std::string> &misses)
+{
+  ChHashTable<int> table(ChHashTable<int>::HTConfig(17, CountedHash, 3.0, 2.0, 0, 0, store_hash));
+  gHashCalls = 0;
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    table.insert(keys[i].c_str(), static_cast<int>(i));
+  double insert_ms = ElapsedMs(start);
+  unsigned insert_hashes = gHashCalls;
+
+  long sum = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    sum += table.find(keys[i].c_str());
+  double hit_ms = ElapsedMs(start);
+
+  HTStats before = table.GetStats();
+  start = Clock::now();
+  for (size_t i = 0; i < misses.size(); i++)
+  {
+    try
+    {
+      sum += table.find(misses[i].c_str());
+    }
+    catch (const HashTableException &)
+    {
+    }
+  }
+  double miss_ms = ElapsedMs(start);
+  HTStats after = table.GetStats();
+
+  cout << std::left << std::setw(10) << label << std::right
+       << std::setw(10) << insert_ms
+       << std::setw(9) << hit_ms
+       << std::setw(9) << miss_ms
+       << std::setw(12) << insert_hashes
+       << std::setw(11) << after.Probes_
+       << std::setw(11) << after.KeyCompares_
+       << std::setw(12) << after.KeyCompares_ - before.KeyCompares_
+       << (sum > 0 ? "" : "  WRONG") << endl;
+}
+
+void TestHashCache(void)
+{
+  cout << "\n========== Stored hashes in ChHashTable (" << gCount << " keys) ==========\n";
+  cout << "Times in ms. 'hashes' are hash calls while inserting (growth included);\n"
+          "'compares' are key comparisons in total and while missing.\n";
+
+  std::vector<std::string> keys = MakeKeys(gCount, '0', 4);
+  std::vector<std::string> misses = MakeKeys(gCount / 4, 'X', 5);
+
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(10) << "hash" << std::right
+       << std::setw(10) << "insert" << std::setw(9) << "hit" << std::setw(9) << "miss"
+       << std::setw(12) << "hashes" << std::setw(11) << "probes" << std::setw(11) << "compares"
+       << std::setw(12) << "miss cmp" << endl;
+
+  HashCacheWorkload("client", false, keys, misses);
+  HashCacheWorkload("stored", true, keys, misses);
+}
+
+// Runs num_threads threads over a table holding keys. Out of every 100
+// operations, reads are finds of keys; the rest alternate between inserting
+// a key of the thread's own and removing its oldest one. Returns operations
+// per second.
+template <typename Find, typename Insert, typename Remove>
+double MixedThroughput(unsigned num_threads, unsigned reads, const std::vector<std::string> &keys,
+                       Find find, Insert insert, Remove remove)
+{
+  const unsigned ops_per_thread = 400000;
+  std::vector<std::thread> threads;
+  Clock::time_point start = Clock::now();
+  for (unsigned t = 0; t < num_threads; t++)
+  {
+    threads.push_back(std::thread([&, t]() {
+      std::mt19937 rng(t + 1);
+      unsigned inserted = 0;
+      unsigned removed = 0;
+      long sum = 0;
+      char key[16];
+      for (unsigned i = 0; i < ops_per_thread; i++)
+      {
+        unsigned r = static_cast<unsigned>(rng());
+        if (r % 100 < reads)
+          sum += find(keys[(r >> 8) % keys.size()].c_str());
+        else if (inserted == removed || (r >> 8) % 2)
+        {
+          std::sprintf(key, "W%02u%06u", t % 100, inserted++ % 1000000);
+          insert(key, static_cast<int>(i));
+        }
+        else
+        {
+          std::sprintf(key, "W%02u%06u", t % 100, removed++ % 1000000);
+          remove(key);
+        }
+      }
+      if (sum < 0)
+        cout << "WRONG" << endl;
+    }));
+  }
+  for (size_t t = 0; t < threads.size(); t++)
+    threads[t].join();
+  double ms = ElapsedMs(start);
+  return static_cast<double>(ops_per_thread) * num_threads / (ms / 1000.0);
+}
+
+void TestConcurrentTable(void)
+{
+  cout << "\n========== Sharded table vs one mutex (" << gCount << " keys) ==========\n";
+  cout << "Millions of operations per second; each thread does 400000.\n";
+
+  std::vector<std::string> keys = MakeKeys(gCount, '0', 6);
+  std::vector<unsigned> counts = ThreadCounts();
+  const unsigned read_mixes[] = {100, 90, 50};
+
+  cout << std::fixed << std::setprecision(2);
+  for (size_t m = 0; m < sizeof(read_mixes) / sizeof(*read_mixes); m++)
+  {
+    unsigned reads = read_mixes[m];
+    cout << "\n" << reads << "% finds\n";
+    cout << std::setw(8) << "threads" << std::setw(12) << "mutex" << std::setw(12) << "sharded" << endl;
+    for (size_t c = 0; c < counts.size(); c++)
+    {
+      ChHashTable<int> locked(ChHashTable<int>::HTConfig(gCount, FNVHash, 3.0, 2.0));
+      std::mutex mutex;
+      ConcurrentChHashTable<int> sharded(ConcurrentChHashTable<int>::HTConfig(gCount, FNVHash, 3.0, 2.0), 64);
+      for (size_t i = 0; i < keys.size(); i++)
+      {
+        locked.insert(keys[i].c_str(), 1);
+        sharded.insert(keys[i].c_str(), 1);
+      }
+
+      double locked_ops = MixedThroughput(counts[c], reads, keys,
+          [&](const char *key) { std::lock_guard<std::mutex> lock(mutex); return locked.find(key); },
+          [&](const char *key, int data) { std::lock_guard<std::mutex> lock(mutex); locked.insert(key, data); },
+          [&](const char *key) { std::lock_guard<std::mutex> lock(mutex); locked.remove(key); });
+      double sharded_ops = MixedThroughput(counts[c], reads, keys,
+          [&](const char *key) { return sharded.find(key); },
+          [&](const char *key, int data) { sharded.insert(key, data); },
+          [&](const char *key) { sharded.remove(key); });
+
+      cout << std::setw(8) << counts[c] << std::setw(12) << locked_ops / 1e6
+           << std::setw(12) << sharded_ops / 1e6 << endl;
+    }
+  }
+}
+
+// Inserts every key into table, then looks every key up. Prints the times,
+// the number of keys the table rejected as duplicates and bytes per key.
+template <typename Table, typename Key>
+void KeyTypeWorkload(const char *label, Table &table, const std::vector<Key> &keys)
+{
+  unsigned duplicates = 0;
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    try
+    {
+      table.insert(keys[i], static_cast<int>(i));
+    }
+    catch (const HashTableException &)
+    {
+      duplicates++;
+    }
+  }
+  double insert_ms = ElapsedMs(start);
+
+  long sum = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    sum += table.find(keys[i]);
+  double hit_ms = ElapsedMs(start);
+
+  cout << std::left << std::setw(26) << label << std::right
+       << std::setw(10) << PerOp(insert_ms, keys.size())
+       << std::setw(10) << PerOp(hit_ms, keys.size())
+       << std::setw(10) << duplicates
+       << std::setw(10) << static_cast<double>(TableBytes(table)) / static_cast<double>(keys.size())
+       << (sum >= 0 ? "" : "  WRONG") << endl;
+}
+
+// Adapts ChHashTable to the std::string keys of KeyTypeWorkload
+struct CharKeyTable
+{
+  ChHashTable<int> table;
+  CharKeyTable() : table(ChHashTable<int>::HTConfig(17, FNVHash, 3.0, 2.0, 0, 0, true)) {}
+  void insert(const std::string &key, int data) { table.insert(key.c_str(), data); }
+  int find(const std::string &key) const { return table.find(key.c_str()); }
+};
+
+size_t TableBytes(const CharKeyTable &table)
+{
+  return TableBytes(table.table);
+}
+
+void TestKeyTypes(void)
+{
+  cout << "\n========== Key types (" << gCount << " keys) ==========\n";
+  cout << "Nanoseconds per operation. Every table grows from 17 lists and stores\n"
+          "hashes; 'dups' are distinct keys rejected as duplicates.\n";
+
+  std::vector<std::string> keys = MakeKeys(gCount, '0', 7);
+  std::vector<std::string> names(keys.size());
+  for (size_t i = 0; i < keys.size(); i++)
+    names[i] = "render.pipeline.pass." + keys[i] + std::string(i % 16, '_');
+  std::vector<unsigned> numbers(keys.size());
+  for (size_t i = 0; i < keys.size(); i++)
+    numbers[i] = static_cast<unsigned>(std::atoi(keys[i].c_str()));
+
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(26) << "table" << std::right
+       << std::setw(10) << "insert" << std::setw(10) << "hit" << std::setw(10) << "dups"
+       << std::setw(10) << "bytes" << endl;
+
+  {
+    CharKeyTable table;
+    KeyTypeWorkload("ChHashTable 9 chars", table, keys);
+  }
+  {
+    ChHashMap<std::string, int> table(ChHashMap<std::string, int>::HTConfig(17));
+    KeyTypeWorkload("ChHashMap 9 chars", table, keys);
+  }
+  {
+    ChHashMap<unsigned, int> table(ChHashMap<unsigned, int>::HTConfig(17));
+    KeyTypeWorkload("ChHashMap unsigned", table, numbers);
+  }
+  {
+    CharKeyTable table;
+    KeyTypeWorkload("ChHashTable 30-45 chars", table, names);
+  }
+  {
+    ChHashMap<std::string, int> table(ChHashMap<std::string, int>::HTConfig(17));
+    KeyTypeWorkload("ChHashMap 30-45 chars", table, names);
+  }
+}
+
+// Fills a table of size lists with keys, looks every key up and prints the
+// times, the share of empty lists, the longest list and probes per hit.
+void HashQualityWorkload(const char *label, HASHFUNC hash, bool power_of_two, unsigned size,
+                         const std::vector<std::string> &keys)
+{
+  ChHashTable<int> table(ChHashTable<int>::HTConfig(size, hash, 1e9, 2.0, 0, 0, false, power_of_two));
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    table.insert(keys[i].c_str(), static_cast<int>(i));
+  double insert_ms = ElapsedMs(start);
+
+  HTStats before = table.GetStats();
+  long sum = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    sum += table.find(keys[i].c_str());
+  double hit_ms = ElapsedMs(start);
+  HTStats after = table.GetStats();
+
+  const ChHashTable<int>::ChHTHeadNode *lists = table.GetTable();
+  unsigned empty = 0;
+  unsigned longest = 0;
+  for (unsigned i = 0; i < after.TableSize_; i++)
+  {
+    unsigned length = 0;
+    for (const ChHashTable<int>::ChHTNode *node = lists[i].Nodes; node; node = node->Next)
+      length++;
+    if (length == 0)
+      empty++;
+    longest = std::max(longest, length);
+  }
+
+  cout << std::left << std::setw(10) << label << std::setw(7) << (power_of_two ? "2^k" : "prime")
+       << std::right
+       << std::setw(10) << PerOp(insert_ms, keys.size())
+       << std::setw(10) << PerOp(hit_ms, keys.size())
+       << std::setw(9) << 100.0 * empty / after.TableSize_
+       << std::setw(9) << longest
+       << std::setw(10) << static_cast<double>(after.Probes_ - before.Probes_) / static_cast<double>(keys.size())
+       << (sum >= 0 ? "" : "  WRONG") << endl;
+}
+
+void TestHashQuality(void)
+{
+  unsigned size = 1;
+  while (size < gCount)
+    size *= 2;
+  double load = static_cast<double>(gCount) / size;
+
+  cout << "\n========== Hash functions (" << gCount << " keys, " << size << " lists) ==========\n";
+  cout << "Nanoseconds per operation. 'prime' tables have the prime closest to " << size << " lists\n"
+          "and reduce the client hash with %; '2^k' tables (PowerOfTwo_) multiply the hash for\n"
+          "FULL_HASH_RANGE by 2^32 / phi and keep its top bits.\n";
+  cout << std::fixed << std::setprecision(2);
+  cout << "A uniform hash at load " << load << " leaves " << 100.0 * std::exp(-load)
+       << "% of lists empty and takes about " << 1.0 + load / 2.0 << " probes per hit.\n";
+
+  struct { const char *name; HASHFUNC hash; } hashes[] = {
+    {"poly31", Poly31Hash},
+    {"fnv1a", FNVHash},
+    {"xxhash32", XXHash32},
+    {"wyhash", WyHash},
+  };
+  std::vector<std::string> key_sets[] = {MakeKeys(gCount, '0', 8), MakeWords(gCount, 9), MakeIds(gCount)};
+  const char *set_names[] = {"decimal '%09u' keys, shuffled", "random words of 4-9 letters", "'obj' + base-36 counter, in order"};
+
+  for (size_t k = 0; k < sizeof(set_names) / sizeof(*set_names); k++)
+  {
+    cout << "\n" << set_names[k] << "\n";
+    cout << std::left << std::setw(10) << "hash" << std::setw(7) << "size" << std::right
+         << std::setw(10) << "insert" << std::setw(10) << "hit" << std::setw(9) << "empty%"
+         << std::setw(9) << "longest" << std::setw(10) << "probes" << endl;
+    for (size_t h = 0; h < sizeof(hashes) / sizeof(*hashes); h++)
+    {
+      HashQualityWorkload(hashes[h].name, hashes[h].hash, false, GetClosestPrime(size), key_sets[k]);
+      HashQualityWorkload(hashes[h].name, hashes[h].hash, true, size, key_sets[k]);
+    }
+  }
+}
+
+// Builds a table of every key starting from 17 lists, one of three ways,
+// and prints the time, the growths and a check that every key is there.
+void BuildWorkload(const char *label, int mode, const std::vector<const char *> &keys,
+                   const std::vector<int> &data)
+{
+  ChHashTable<int> table(ChHashTable<int>::HTConfig(17, FNVHash, 3.0, 2.0));
+  unsigned count = static_cast<unsigned>(keys.size());
+  Clock::time_point start = Clock::now();
+  if (mode == 2)
+    table.insert_range(keys.data(), data.data(), count);
+  else
+  {
+    if (mode == 1)
+      table.reserve(count);
+    for (unsigned i = 0; i < count; i++)
+      table.insert(keys[i], data[i]);
+  }
+  double build_ms = ElapsedMs(start);
+
+  HTStats stats = table.GetStats();
+  bool ok = stats.Count_ == count && table.find(keys[count / 2]) == data[count / 2];
+  cout << std::left << std::setw(20) << label << std::right
+       << std::setw(10) << build_ms
+       << std::setw(10) << PerOp(build_ms, count)
+       << std::setw(8) << stats.Expansions_
+       << std::setw(10) << stats.TableSize_
+       << (ok ? "" : "  WRONG") << endl;
+}
+
+void TestBulkBuild(void)
+{
+  cout << "\n========== Building a table (" << gCount << " keys) ==========\n";
+  cout << "From 17 lists with MaxLoadFactor_ 3. Total in ms, then ns per key.\n";
+
+  std::vector<std::string> keys = MakeKeys(gCount, '0', 10);
+  std::vector<const char *> key_ptrs(keys.size());
+  std::vector<int> data(keys.size());
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    key_ptrs[i] = keys[i].c_str();
+    data[i] = static_cast<int>(i);
+  }
+
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(20) << "build" << std::right
+       << std::setw(10) << "total" << std::setw(10) << "per key" << std::setw(8) << "grew"
+       << std::setw(10) << "size" << endl;
+
+  BuildWorkload("insert", 0, key_ptrs, data);
+  BuildWorkload("reserve + insert", 1, key_ptrs, data);
+  BuildWorkload("insert_range", 2, key_ptrs, data);
+}
+
+void TestSnapshot(void)
+{
+  cout << "\n========== Loading from a snapshot (" << gCount << " keys) ==========\n";
+  cout << "Times in ms. A table is built with insert_range, written with\n"
+          "ChHashSnapshot::write, then mapped and searched in place.\n";
+
+  const char *path = "driver-bench.snapshot";
+  const unsigned hash_id = 1;
+  std::vector<std::string> keys = MakeKeys(gCount, '0', 11);
+  std::vector<std::string> misses = MakeKeys(gCount / 4, 'X', 12);
+  std::vector<const char *> key_ptrs(keys.size());
+  std::vector<int> data(keys.size());
+  for (size_t i = 0; i < keys.size(); i++)
+  {
+    key_ptrs[i] = keys[i].c_str();
+    data[i] = static_cast<int>(i);
+  }
+
+  cout << std::fixed << std::setprecision(2);
+  ChHashTable<int> table(ChHashTable<int>::HTConfig(17, WyHash, 1.0, 2.0));
+  Clock::time_point start = Clock::now();
+  table.insert_range(key_ptrs.data(), data.data(), gCount);
+  double build_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  ChHashSnapshot<int>::write(table, path, hash_id);
+  double write_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  ChHashSnapshot<int> snapshot(path, WyHash, hash_id);
+  double open_ms = ElapsedMs(start);
+
+  cout << "build " << build_ms << ", write " << write_ms << ", open " << open_ms
+       << " (" << static_cast<double>(snapshot.size()) / (1024.0 * 1024.0) << " MB, "
+       << static_cast<double>(snapshot.size()) / static_cast<double>(gCount) << " bytes per key)\n";
+
+  cout << std::left << std::setw(12) << "find in" << std::right
+       << std::setw(10) << "hit" << std::setw(10) << "miss" << std::setw(10) << "probes" << endl;
+
+  double finds = static_cast<double>(keys.size() + misses.size());
+  unsigned build_probes = table.GetStats().Probes_;
+  long sum = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    sum += table.find(key_ptrs[i]);
+  double hit_ms = ElapsedMs(start);
+  start = Clock::now();
+  for (size_t i = 0; i < misses.size(); i++)
+  {
+    try
+    {
+      sum += table.find(misses[i].c_str());
+    }
+    catch (const HashTableException &)
+    {
+    }
+  }
+  double miss_ms = ElapsedMs(start);
+  cout << std::left << std::setw(12) << "table" << std::right
+       << std::setw(10) << PerOp(hit_ms, keys.size()) << std::setw(10) << PerOp(miss_ms, misses.size())
+       << std::setw(10) << (table.GetStats().Probes_ - build_probes) / finds << endl;
+
+  long snapshot_sum = 0;
+  start = Clock::now();
+  for (size_t i = 0; i < keys.size(); i++)
+    snapshot_sum += snapshot.find(key_ptrs[i]);
+  hit_ms = ElapsedMs(start);
+  start = Clock::now();
+  for (size_t i = 0; i < misses.size(); i++)
+  {
+    try
+    {
+      snapshot_sum += snapshot.find(misses[i].c_str());
+    }
+    catch (const HashTableException &)
+    {
+    }
+  }
+  miss_ms = ElapsedMs(start);
+  cout << std::left << std::setw(12) << "snapshot" << std::right
+       << std::setw(10) << PerOp(hit_ms, keys.size()) << std::setw(10) << PerOp(miss_ms, misses.size())
+       << std::setw(10) << snapshot.GetStats().Probes_ / finds
+       << (snapshot_sum == sum ? "" : "  WRONG") << endl;
+
+  std::remove(path);
+}
+
+// Looks up every key of lookups in a table holding keys, with find and a
+// catch, or with try_find. Prints the time and probes per lookup and the
+// filter's false-positive rate.
+void MissWorkload(const char *label, unsigned filter_bits, bool use_find,
+                  const std::vector<std::string> &keys, const std::vector<std::string> &lookups)
+{
+  ChHashTable<int> table(ChHashTable<int>::HTConfig(17, WyHash, 3.0, 2.0, 0, 0, false, false, filter_bits));
+  for (size_t i = 0; i < keys.size(); i++)
+    table.insert(keys[i].c_str(), static_cast<int>(i));
+
+  HTStats before = table.GetStats();
+  unsigned found = 0;
+  Clock::time_point start = Clock::now();
+  for (size_t i = 0; i < lookups.size(); i++)
+  {
+    if (use_find)
+    {
+      try
+      {
+        table.find(lookups[i].c_str());
+        found++;
+      }
+      catch (const HashTableException &)
+      {
+      }
+    }
+    else if (table.try_find(lookups[i].c_str()))
+      found++;
+  }
+  double ms = ElapsedMs(start);
+  HTStats after = table.GetStats();
+  HTStats lookup_stats;
+  lookup_stats.FilterRejects_ = after.FilterRejects_ - before.FilterRejects_;
+  lookup_stats.FilterFalsePositives_ = after.FilterFalsePositives_ - before.FilterFalsePositives_;
+
+  cout << std::left << std::setw(18) << label << std::right
+       << std::setw(10) << PerOp(ms, lookups.size())
+       << std::setw(10) << static_cast<double>(after.Probes_ - before.Probes_) / static_cast<double>(lookups.size())
+       << std::setw(10) << 100.0 * lookup_stats.FilterFalsePositiveRate()
+       << std::setw(9) << found << endl;
+}
+
+void TestMissFilter(void)
+{
+  cout << "\n========== Lookups that mostly miss (" << gCount << " keys) ==========\n";
+  cout << "9 of every 10 lookups miss. ns and probes per lookup; 'fp%' is the share\n"
+          "of misses the Bloom filter let through.\n";
+
+  std::vector<std::string> keys = MakeKeys(gCount, '0', 13);
+  std::vector<std::string> misses = MakeKeys(gCount, 'X', 14);
+  std::vector<std::string> lookups;
+  for (size_t i = 0; i < keys.size(); i++)
+    lookups.push_back(i % 10 ? misses[i] : keys[i]);
+
+  cout << std::fixed << std::setprecision(2);
+  cout << std::left << std::setw(18) << "lookup" << std::right
+       << std::setw(10) << "ns" << std::setw(10) << "probes" << std::setw(10) << "fp%"
+       << std::setw(9) << "found" << endl;
+
+  MissWorkload("find + catch", 0, true, keys, lookups);
+  MissWorkload("try_find", 0, false, keys, lookups);
+  MissWorkload("find, 8 bits", 8, true, keys, lookups);
+  MissWorkload("try_find, 8 bits", 8, false, keys, lookups);
+  MissWorkload("try_find, 16 bits", 16, false, keys, lookups);
+}
+
+typedef void (*TestFn)(void);
+
+int main(int argc, char **argv)
+{
+    // Test number
+  int test_num = 0;
+  if (argc > 1)
+    test_num = std::atoi(argv[1]);
+
+    // Number of keys
+  if (argc > 2)
+    gCount = static_cast<unsigned>(std::atoi(argv[2]));
+
+    // Maximum number of threads
+  if (argc > 3)
+    gMaxThreads = static_cast<unsigned>(std::atoi(argv[3]));
+
+  TestFn Tests[] = {
+                    TestOpenAddressing,    // 1 OAHashTable vs ChHashTable across load factors
+                    TestIncrementalRehash, // 2 insert latency, one-pass vs incremental growth
+                    TestHashCache,         // 3 stored hashes vs rehashing and comparing keys
+                    TestConcurrentTable,   // 4 sharded table vs one mutex, 1 to N threads
+                    TestKeyTypes,          // 5 ChHashMap string and integer keys vs char[10] keys
+                    TestHashQuality,       // 6 list lengths and speed of each hash, prime vs 2^k sizes
+                    TestBulkBuild,         // 7 insert one by one vs reserve vs insert_range
+                    TestSnapshot,          // 8 mapping a ChHashSnapshot vs building the table
+                    TestMissFilter,        // 9 find vs try_find, with and without a Bloom filter
+                   };
+
+  int num = sizeof(Tests) / sizeof(*Tests);
+  if (test_num == 0)
+  {
+    for (int i = 0; i < num; i++)
+      Tests[i]();
+  }
+  else if (test_num > 0 && test_num <= num)
+  {
+    Tests[test_num - 1]();
+  }
+
+  return 0;
+}